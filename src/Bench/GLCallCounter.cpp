@@ -0,0 +1,98 @@
+/*
+ * GLCallCounter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Counts the GL calls which the benchmark issues.
+ *  The counters are incremented by wrapper functions which the linker puts in front of the GL library functions
+ *  (ld option --wrap=<symbol>, see Bench/Makefile.am).
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <GLES2/gl2.h>
+
+#include "Bench/GLCallCounter.h"
+
+namespace OevBench {
+
+static GLCallCounts counts;
+
+GLCallCounts const &getGLCallCounts() {
+	return counts;
+}
+
+void resetGLCallCounts() {
+	counts = GLCallCounts();
+}
+
+} /* namespace OevBench */
+
+/** \brief Define the wrapper of a GL function
+ *
+ * The linker resolves all references to name to __wrap_name, and __real_name to the original name
+ * in the GL library.
+ *
+ * @param category Member of \ref OevBench::GLCallCounts which is incremented besides the total counter
+ */
+#define OEV_WRAP_GL(category,name,params,args) \
+	extern "C" void GL_APIENTRY __real_##name params; \
+	extern "C" void GL_APIENTRY __wrap_##name params { \
+		OevBench::counts.total++; \
+		OevBench::counts.category++; \
+		__real_##name args; \
+	}
+
+OEV_WRAP_GL(state,glUseProgram,(GLuint program),(program))
+OEV_WRAP_GL(state,glEnable,(GLenum cap),(cap))
+OEV_WRAP_GL(state,glDisable,(GLenum cap),(cap))
+OEV_WRAP_GL(state,glDepthMask,(GLboolean flag),(flag))
+OEV_WRAP_GL(state,glBlendFunc,(GLenum sfactor, GLenum dfactor),(sfactor, dfactor))
+OEV_WRAP_GL(state,glScissor,(GLint x, GLint y, GLsizei width, GLsizei height),(x, y, width, height))
+OEV_WRAP_GL(state,glViewport,(GLint x, GLint y, GLsizei width, GLsizei height),(x, y, width, height))
+OEV_WRAP_GL(state,glClear,(GLbitfield mask),(mask))
+OEV_WRAP_GL(state,glClearColor,(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha),(red, green, blue, alpha))
+OEV_WRAP_GL(state,glEnableVertexAttribArray,(GLuint index),(index))
+OEV_WRAP_GL(state,glDisableVertexAttribArray,(GLuint index),(index))
+OEV_WRAP_GL(state,glVertexAttribPointer,(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer),(index, size, type, normalized, stride, pointer))
+OEV_WRAP_GL(state,glVertexAttrib4fv,(GLuint index, const GLfloat *v),(index, v))
+OEV_WRAP_GL(state,glTexParameteri,(GLenum target, GLenum pname, GLint param),(target, pname, param))
+OEV_WRAP_GL(bind,glActiveTexture,(GLenum texture),(texture))
+OEV_WRAP_GL(bind,glBindTexture,(GLenum target, GLuint texture),(target, texture))
+OEV_WRAP_GL(bind,glBindBuffer,(GLenum target, GLuint buffer),(target, buffer))
+OEV_WRAP_GL(bind,glBindFramebuffer,(GLenum target, GLuint framebuffer),(target, framebuffer))
+OEV_WRAP_GL(uniform,glUniform1i,(GLint location, GLint v0),(location, v0))
+OEV_WRAP_GL(uniform,glUniform1f,(GLint location, GLfloat v0),(location, v0))
+OEV_WRAP_GL(uniform,glUniform2fv,(GLint location, GLsizei count, const GLfloat *value),(location, count, value))
+OEV_WRAP_GL(uniform,glUniform3fv,(GLint location, GLsizei count, const GLfloat *value),(location, count, value))
+OEV_WRAP_GL(uniform,glUniform4fv,(GLint location, GLsizei count, const GLfloat *value),(location, count, value))
+OEV_WRAP_GL(uniform,glUniformMatrix4fv,(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value),(location, count, transpose, value))
+OEV_WRAP_GL(upload,glBufferData,(GLenum target, GLsizeiptr size, const void *data, GLenum usage),(target, size, data, usage))
+OEV_WRAP_GL(upload,glBufferSubData,(GLenum target, GLintptr offset, GLsizeiptr size, const void *data),(target, offset, size, data))
+OEV_WRAP_GL(upload,glTexImage2D,(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels),(target, level, internalformat, width, height, border, format, type, pixels))
+OEV_WRAP_GL(upload,glTexSubImage2D,(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels),(target, level, xoffset, yoffset, width, height, format, type, pixels))
+OEV_WRAP_GL(upload,glCompressedTexImage2D,(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data),(target, level, internalformat, width, height, border, imageSize, data))
+OEV_WRAP_GL(draw,glDrawArrays,(GLenum mode, GLint first, GLsizei count),(mode, first, count))
+OEV_WRAP_GL(draw,glDrawElements,(GLenum mode, GLsizei count, GLenum type, const void *indices),(mode, count, type, indices))
@@ -0,0 +1,60 @@
+/*
+ * GLCallCounter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Counts the GL calls which the benchmark issues.
+ *  The counters are incremented by wrapper functions which the linker puts in front of the GL library functions
+ *  (ld option --wrap=<symbol>, see Bench/Makefile.am).
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef BENCH_GLCALLCOUNTER_H_
+#define BENCH_GLCALLCOUNTER_H_
+
+#include <cstdint>
+
+namespace OevBench {
+
+/** \brief Number of GL calls by category
+ *
+ */
+struct GLCallCounts {
+	uint64_t total = 0;			///< All counted GL calls
+	uint64_t draw = 0;			///< glDrawArrays, glDrawElements
+	uint64_t uniform = 0;		///< glUniform*
+	uint64_t state = 0;			///< Program, capability, depth, blend, and vertex attribute state
+	uint64_t bind = 0;			///< glBindBuffer, glBindTexture, glBindFramebuffer, glActiveTexture
+	uint64_t upload = 0;		///< Buffer and texture data uploads
+};
+
+/** \brief Return the counts accumulated since the start of the program or the last \ref resetGLCallCounts()
+ *
+ * @return Current counts
+ */
+GLCallCounts const &getGLCallCounts();
+
+/// \brief Set all counters to 0
+void resetGLCallCounts();
+
+} /* namespace OevBench */
+
+#endif /* BENCH_GLCALLCOUNTER_H_ */
@@ -0,0 +1,435 @@
+/*
+ *  OpenVarioBench.cpp
+ *
+ *  Rendering benchmark. Renders a fixed number of frames with deterministic matrices headless,
+ *  and reports frame rate, CPU time per frame, and GL calls per frame.
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <getopt.h>
+#include <time.h>
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+#include <chrono>
+
+#include "OVFCommon.h"
+
+#include "GLES/EGLRenderSurface.h"
+#include "Renderers/AnalogHandRenderer.h"
+#include "Renderers/NeedleBatchRenderer.h"
+#include "Renderers/SquareTextureRenderer.h"
+#include "Renderers/RenderQueue.h"
+#include "Renderers/FrameScheduler.h"
+#include "Renderers/LayerCache.h"
+#include "Renderers/SceneCamera.h"
+#include "Renderers/TransformNode.h"
+#include "Utils/FrameProfiler.h"
+#include "Bench/GLCallCounter.h"
+#include "GLES/GLStateCache.h"
+#include "GLPrograms/ProgramRegistry.h"
+#include "GLES/TexHelper/TextureLoader.h"
+#include "GLES/TexHelper/TextureAtlas.h"
+
+// Success is defined in X headers, but collides with an enum value in lib Eigen.
+#if defined Success
+#	undef Success
+#endif
+
+#include "GLES/VecMat.h"
+
+/// \brief Parameters of a benchmark run
+struct BenchOptions {
+	unsigned numFrames = 1000;		///< Number of measured frames
+	unsigned numWarmupFrames = 50;	///< Frames rendered before the measurement starts
+	unsigned numHands = 1;			///< Number of analog hands
+	unsigned numQuads = 1;			///< Number of SquareTextureRenderer instances
+	bool batchNeedles = false;		///< Draw the hands as needles of NeedleBatchRenderer batches
+	bool useRenderQueue = false;	///< Draw through the RenderQueue instead of calling the renderers directly
+	bool onDemand = false;			///< Static camera, draw through the FrameScheduler with damage tracking
+	bool useLayerCache = false;		///< Draw the quads into a cached background layer. Implies onDemand.
+	GLint width = 640;
+	GLint height = 480;
+};
+
+static void usage(char const *progName) {
+	std::cerr << "Usage: " << progName << " [options]\n"
+			"  -f, --frames N    Number of measured frames (default 1000)\n"
+			"  -w, --warmup N    Number of warm-up frames (default 50)\n"
+			"  -n, --hands N     Number of analog hands (default 1)\n"
+			"  -q, --quads N     Number of textured quads (default 1)\n"
+			"  -b, --batch       Draw the hands as needle batches, one draw call per 16 hands\n"
+			"  -Q, --queue       Draw through the render queue\n"
+			"  -d, --on-demand   Static camera, draw only damaged regions with the frame scheduler\n"
+			"  -l, --layer       Like --on-demand, and the quads are cached in a background layer\n"
+			"  -h, --help        This help\n";
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options) {
+	static struct option longOptions[] = {
+			{"frames",	required_argument,	0, 'f'},
+			{"warmup",	required_argument,	0, 'w'},
+			{"hands",	required_argument,	0, 'n'},
+			{"quads",	required_argument,	0, 'q'},
+			{"batch",	no_argument,		0, 'b'},
+			{"queue",	no_argument,		0, 'Q'},
+			{"on-demand",	no_argument,	0, 'd'},
+			{"layer",	no_argument,		0, 'l'},
+			{"help",	no_argument,		0, 'h'},
+			{0, 0, 0, 0}
+	};
+	int c;
+
+	while ((c = getopt_long(argc,argv,"f:w:n:q:bQdlh",longOptions,NULL)) != -1) {
+		switch (c) {
+		case 'f':
+			options.numFrames = unsigned(strtoul(optarg,NULL,0));
+			break;
+		case 'w':
+			options.numWarmupFrames = unsigned(strtoul(optarg,NULL,0));
+			break;
+		case 'n':
+			options.numHands = unsigned(strtoul(optarg,NULL,0));
+			break;
+		case 'q':
+			options.numQuads = unsigned(strtoul(optarg,NULL,0));
+			break;
+		case 'b':
+			options.batchNeedles = true;
+			break;
+		case 'Q':
+			options.useRenderQueue = true;
+			break;
+		case 'l':
+			options.useLayerCache = true;
+			[[fallthrough]];
+		case 'd':
+			options.onDemand = true;
+			options.useRenderQueue = true;
+			break;
+		default:
+			usage(argv[0]);
+			return false;
+		}
+	}
+
+	if (options.numFrames == 0) {
+		std::cerr << "Number of frames must be > 0" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/// \brief Consumed CPU time of the process in seconds
+static double processCpuTime() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID,&ts);
+
+	return double(ts.tv_sec) + double(ts.tv_nsec) / 1.0e9;
+}
+
+/** \brief Place instrument number idx of num instruments on a square grid in the X/Y plane
+ *
+ * The instruments are scaled down so that the grid covers the same area as a single instrument
+ * of the main program.
+ *
+ * @param idx Index of the instrument
+ * @param num Number of instruments
+ * @return Model matrix of the instrument without its own rotation
+ */
+static OevGLES::Mat4 gridPosition(unsigned idx, unsigned num) {
+	unsigned columns = 1;
+
+	while (columns * columns < num) {
+		columns++;
+	}
+
+	GLfloat const scale = 1.0f / GLfloat(columns);
+	GLfloat const spacing = 20.0f * scale;
+	GLfloat const offset = GLfloat(columns - 1) * spacing / 2.0f;
+
+	return OevGLES::translationMatrix(
+			GLfloat(idx % columns) * spacing - offset,
+			GLfloat(idx / columns) * spacing - offset,
+			0.0f) * OevGLES::scalingMatrix(scale,scale,scale);
+}
+
+int main(int argc, char **argv) {
+	BenchOptions options;
+
+#if defined HAVE_LOG4CXX_H
+	log4cxx::BasicConfigurator::configure();
+	log4cxx::Logger::getRootLogger()->setLevel(log4cxx::Level::getWarn());
+#endif // if defined HAVE_LOG4CXX_H
+
+	if (!parseOptions(argc,argv,options)) {
+		return 1;
+	}
+
+	OevUtils::FrameProfiler frameProfiler (options.numFrames);
+	unsigned const phaseMatrices = frameProfiler.registerPhase("matrices");
+	unsigned const phaseDrawHands = frameProfiler.registerPhase("draw hands");
+	unsigned const phaseDrawQuads = frameProfiler.registerPhase("draw quads");
+	unsigned const phaseRenderQueue = frameProfiler.registerPhase("render queue");
+	unsigned const phaseSwap = frameProfiler.registerPhase("swap");
+
+	try {
+		auto const setupStart = std::chrono::steady_clock::now();
+		OevGLES::EGLRenderSurface eglSurface;
+		eglSurface.createOffscreenSurface(options.width,options.height);
+
+		// Compile all programs in the background while the renderers are set up
+		OevGLES::ProgramRegistry::prepareAllPrograms();
+
+		std::vector<std::unique_ptr<AnalogHandRenderer>> hands;
+		std::vector<std::unique_ptr<NeedleBatchRenderer>> needleBatches;
+		std::vector<std::unique_ptr<SquareTextureRenderer>> quads;
+		std::vector<OevGLES::Mat4> quadPositions;
+		RenderQueue renderQueue;
+		FrameScheduler frameScheduler (eglSurface);
+		LayerCache layerCache (eglSurface);
+		SceneCamera camera;
+		// Each hand is mounted on its own gauge panel. All panels are children of the scene root.
+		// Needle batches are children of the scene root. The gauge position is the pivot of the needle.
+		TransformNode sceneRoot;
+		std::vector<std::unique_ptr<TransformNode>> gaugeNodes;
+		std::vector<std::unique_ptr<TransformNode>> handNodes;
+		OevGLES::Vec4 const handColor {1.0f,1.0f,0.7f,1.0f};
+
+		for (unsigned i = 0; options.batchNeedles && i < options.numHands; i++) {
+			if (i % NeedleBatchRenderer::maxNeedles == 0) {
+				needleBatches.emplace_back(new NeedleBatchRenderer);
+				handNodes.emplace_back(new TransformNode(&sceneRoot,needleBatches.back().get()));
+			}
+
+			OevGLES::Mat4 const gaugeMatrix = gridPosition(i,options.numHands);
+			GLfloat const scale = gaugeMatrix(0,0);
+
+			// The same size as the scaled AnalogHandRenderer
+			needleBatches.back()->addNeedle(10.0f * scale,scale,handColor,gaugeMatrix(0,3),gaugeMatrix(1,3));
+		}
+		for (auto &batch : needleBatches) {
+			batch->setupVertexBuffers();
+		}
+
+		for (unsigned i = 0; !options.batchNeedles && i < options.numHands; i++) {
+			hands.emplace_back(new AnalogHandRenderer);
+			hands.back()->setupVertexBuffers();
+
+			gaugeNodes.emplace_back(new TransformNode(&sceneRoot));
+			gaugeNodes.back()->setLocalMatrix(gridPosition(i,options.numHands));
+			handNodes.emplace_back(new TransformNode(gaugeNodes.back().get(),hands.back().get()));
+		}
+		for (unsigned i = 0; i < options.numQuads; i++) {
+			quads.emplace_back(new SquareTextureRenderer);
+			quads.back()->setupVertexBuffers();
+			quadPositions.push_back(gridPosition(i,options.numQuads));
+		}
+
+		for (unsigned i = 0; i < handNodes.size(); i++) {
+			frameScheduler.addItem(*handNodes[i]);
+		}
+
+		// Measure with the real textures, not the placeholders
+		OevGLES::TextureLoader::getTextureLoader().finishAll();
+
+		double const setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+		for (unsigned i = 0; i < options.numQuads; i++) {
+			if (options.useLayerCache) {
+				layerCache.addItem(*quads[i],quadPositions[i]);
+			} else {
+				frameScheduler.addItem(*quads[i],quadPositions[i]);
+			}
+		}
+		frameScheduler.setClearColor(OevGLES::Vec4 {0.2f,0.2f,0.01f,1.0f});
+		if (options.useLayerCache) {
+			frameScheduler.setLayerCache(&layerCache);
+		}
+
+		OevGLES::Vec4 const camPos = {3,4,20,1};
+		OevGLES::Vec3 const up = {0,1,0};
+		OevGLES::Vec3 const origin = {0,0,0};
+		OevGLES::Vec4 const ambientLightColor {0.5f,0.5f,0.5f,1.0f};
+		OevGLES::Vec4 const lightColor {0.5f,0.5f,0.3f,1.0f};
+
+		OevGLES::Mat4 const projMatrix = OevGLES::projectionMatrix(5,35,GLfloat(options.width)/GLfloat(options.height),66);
+		OevGLES::Mat4 camRotMatrix;
+		OevGLES::Mat4 viewMatrix;
+		OevGLES::Mat4 MVMatrix;
+		OevGLES::Mat4 MVPMatrix;
+		OevGLES::Mat4 handMatrix;
+
+		camera.setProjectionMatrix(projMatrix);
+
+		unsigned const totalFrames = options.numWarmupFrames + options.numFrames;
+		double cpuStart = 0.0;
+		auto wallStart = std::chrono::steady_clock::now();
+
+		for (unsigned frame = 0; frame < totalFrames; frame++) {
+
+			if (frame == options.numWarmupFrames) {
+				// Start the measurement with an idle GPU
+				glFinish();
+				OevBench::resetGLCallCounts();
+				OevGLES::GLStateCache::getStateCache().resetCounters();
+				cpuStart = processCpuTime();
+				wallStart = std::chrono::steady_clock::now();
+			}
+
+			// The same camera orbit as the main program, but depending only on the frame number.
+			GLfloat const camAngle = options.onDemand ? 0.0f : GLfloat(frame) * 0.1f;
+			GLfloat const handAngle = GLfloat(frame);
+
+			frameProfiler.beginFrame();
+			frameProfiler.beginPhase(phaseMatrices);
+
+			OevGLES::rotationMatrixY(camRotMatrix,camAngle);
+			OevGLES::viewMatrix(viewMatrix,(camRotMatrix * camPos).block<3,1>(0,0),origin,up);
+			camera.setViewMatrix(viewMatrix);
+
+			OevGLES::Vec4 lightDir4 = viewMatrix * (camRotMatrix * OevGLES::Vec4  {-6.0f,10.0f,10.0f,0.0f});
+			OevGLES::Vec3 lightDir = lightDir4.block<3,1>(0,0);
+			lightDir.normalize();
+
+			for (unsigned i = 0; i < hands.size(); i++) {
+				OevGLES::rotationMatrixZ(handMatrix,handAngle + GLfloat(i) * 37.0f);
+				handNodes[i]->setLocalMatrix(handMatrix);
+			}
+			for (unsigned i = 0; options.batchNeedles && i < options.numHands; i++) {
+				needleBatches[i / NeedleBatchRenderer::maxNeedles]->setNeedleAngle(i % NeedleBatchRenderer::maxNeedles,
+						handAngle + GLfloat(i) * 37.0f);
+			}
+
+			sceneRoot.updateTransforms(camera);
+
+			frameProfiler.endPhase(phaseMatrices);
+
+			if (options.onDemand) {
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseRenderQueue);
+
+				frameScheduler.setCamera(viewMatrix,projMatrix);
+				frameScheduler.setLight(lightDir,lightColor,ambientLightColor);
+				frameScheduler.drawFrame(renderQueue);
+			} else {
+				glClearColor(0.2f,0.2f,0.01f,1.0f);
+				glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+			}
+
+			if (options.useRenderQueue && !options.onDemand) {
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseRenderQueue);
+
+				renderQueue.beginFrame(viewMatrix,projMatrix,lightDir,lightColor,ambientLightColor);
+				for (unsigned i = 0; i < handNodes.size(); i++) {
+					renderQueue.submit(*handNodes[i]);
+				}
+				for (unsigned i = 0; i < quads.size(); i++) {
+					renderQueue.submit(*quads[i],quadPositions[i]);
+				}
+				renderQueue.flush();
+			}
+
+			for (unsigned i = 0; !options.useRenderQueue && i < handNodes.size(); i++) {
+				TransformNode const &node = *handNodes[i];
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseDrawHands);
+				node.getRenderer()->draw(node.getWorldMatrix(),viewMatrix,projMatrix,node.getMVMatrix(),node.getMVPMatrix(),lightDir,lightColor,ambientLightColor);
+			}
+
+			for (unsigned i = 0; !options.useRenderQueue && i < quads.size(); i++) {
+				frameProfiler.beginPhase(phaseMatrices);
+				OevGLES::Mat4 const &modelMatrix = quadPositions[i];
+				OevGLES::multiplyMat4(MVMatrix,viewMatrix,modelMatrix);
+				OevGLES::multiplyMat4(MVPMatrix,camera.getViewProjMatrix(),modelMatrix);
+				frameProfiler.endPhase(phaseMatrices);
+
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseDrawQuads);
+				quads[i]->draw(modelMatrix,viewMatrix,projMatrix,MVMatrix,MVPMatrix,lightDir,lightColor,ambientLightColor);
+			}
+
+			{
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseSwap);
+				if (options.onDemand) {
+					frameScheduler.swapBuffers();
+				} else {
+					eglSurface.swapBuffers();
+				}
+			}
+
+			frameProfiler.endFrame();
+		}
+
+		// Include the completion of the GPU work in the wall time.
+		glFinish();
+
+		double const cpuTime = processCpuTime() - cpuStart;
+		double const wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+		OevBench::GLCallCounts const counts = OevBench::getGLCallCounts();
+		OevGLES::GLStateCache const &stateCache = OevGLES::GLStateCache::getStateCache();
+		double const frames = double(options.numFrames);
+
+		std::cout << "OpenVarioBench: " << options.numHands << (options.batchNeedles ? " batched hands, " : " hands, ") << options.numQuads << " textured quads, "
+				<< (options.useLayerCache ? "layer cache, " : "")
+				<< (options.onDemand ? "on demand, " : (options.useRenderQueue ? "render queue, " : ""))
+				<< options.numFrames << " frames (" << options.numWarmupFrames << " warm-up), "
+				<< options.width << 'x' << options.height << ", renderer " << glGetString(GL_RENDERER) << '\n';
+		std::cout << std::fixed << std::setprecision(3)
+				<< "  setup ms            " << (setupTime * 1000.0) << '\n'
+				<< "  frames/s            " << (frames / wallTime) << '\n'
+				<< "  wall ms/frame       " << (wallTime * 1000.0 / frames) << '\n'
+				<< "  CPU ms/frame        " << (cpuTime * 1000.0 / frames) << '\n'
+				<< std::setprecision(1)
+				<< "  GL calls/frame      " << (double(counts.total) / frames) << '\n'
+				<< "    draw              " << (double(counts.draw) / frames) << '\n'
+				<< "    uniform           " << (double(counts.uniform) / frames) << '\n'
+				<< "    bind              " << (double(counts.bind) / frames) << '\n'
+				<< "    state             " << (double(counts.state) / frames) << '\n'
+				<< "    upload            " << (double(counts.upload) / frames) << '\n'
+				<< "  avoided state calls " << (double(stateCache.getNumCallsAvoided()) / frames) << '\n';
+		if (options.onDemand) {
+			std::cout << "  partial frames      " << frameScheduler.getNumPartialFrames()
+					<< " of " << frameScheduler.getNumFramesDrawn() << '\n';
+		}
+		if (options.useLayerCache) {
+			std::cout << "  layer updates       " << layerCache.getNumUpdates()
+					<< ", composites " << layerCache.getNumComposites() << '\n';
+		}
+		frameProfiler.writeSummary(std::cout);
+		std::cout << std::endl;
+
+		OevGLES::ProgramRegistry::destroyAllPrograms();
+		OevGLES::TextureAtlas::getTextureAtlas().clear();
+
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * AssetPack.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Pack of precooked assets which is mapped into memory, and uploaded to GL without decoding.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "OVFCommon.h"
+
+#include "GLES/AssetPack.h"
+#include "GLES/GLStateCache.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+/// \brief Compare the name of an entry with a name. The name in the pack is always 0 terminated.
+static int compareName(AssetPack::Entry const &entry,char const *name) {
+	return strncmp(entry.name,name,AssetPack::maxNameLength);
+}
+
+AssetPack::AssetPack() {
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.AssetPack");
+	}
+#endif
+}
+
+AssetPack::~AssetPack() {
+	close();
+}
+
+AssetPack &AssetPack::getAssetPack() {
+	static AssetPack theAssetPack;
+
+	return theAssetPack;
+}
+
+void AssetPack::open(char const *fileName) {
+
+	close();
+
+	int const fd = ::open(fileName,O_RDONLY);
+	struct stat fileStat;
+
+	if (fd < 0) {
+		std::ostringstream os;
+		os << "AssetPack: Could not open \"" << fileName << "\": " << strerror(errno);
+		throw AssetPackException(os.str().c_str());
+	}
+
+	if (fstat(fd,&fileStat) != 0 || size_t(fileStat.st_size) < sizeof(FileHeader)) {
+		::close(fd);
+		std::ostringstream os;
+		os << "AssetPack: \"" << fileName << "\" is too short";
+		throw AssetPackException(os.str().c_str());
+	}
+
+	void *addr = mmap(nullptr,size_t(fileStat.st_size),PROT_READ,MAP_PRIVATE,fd,0);
+	// The mapping keeps the file referenced
+	::close(fd);
+
+	if (addr == MAP_FAILED) {
+		std::ostringstream os;
+		os << "AssetPack: Could not map \"" << fileName << "\": " << strerror(errno);
+		throw AssetPackException(os.str().c_str());
+	}
+
+	// Start reading the complete file in one sequential read-ahead instead of page faults at the first access of each blob.
+	madvise(addr,size_t(fileStat.st_size),MADV_WILLNEED);
+
+	mapping = static_cast<uint8_t const *>(addr);
+	mappingSize = size_t(fileStat.st_size);
+	this->fileName = fileName;
+
+	FileHeader const *header = reinterpret_cast<FileHeader const *>(mapping);
+	entries = reinterpret_cast<Entry const *>(mapping + sizeof(FileHeader));
+	numEntries = header->numEntries;
+
+	try {
+		validate();
+	} catch (...) {
+		close();
+		throw;
+	}
+
+	LOG4CXX_INFO(logger,"Mapped asset pack " << fileName << " with " << numEntries << " entries, " << mappingSize << " bytes");
+}
+
+void AssetPack::close() {
+
+	if (mapping) {
+		LOG4CXX_DEBUG(logger,"Unmap asset pack " << fileName);
+		munmap(const_cast<uint8_t *>(mapping),mappingSize);
+	}
+
+	mapping = nullptr;
+	mappingSize = 0;
+	entries = nullptr;
+	numEntries = 0;
+	fileName.clear();
+}
+
+void AssetPack::validate() const {
+	FileHeader const *header = reinterpret_cast<FileHeader const *>(mapping);
+	std::ostringstream os;
+
+	os << "AssetPack: \"" << fileName << "\": ";
+
+	if (memcmp(header->magic,fileMagic,sizeof(fileMagic))) {
+		os << "Not an asset pack, or a different version";
+		throw AssetPackException(os.str().c_str());
+	}
+
+	if (header->byteOrder != byteOrderMark) {
+		os << "The pack was built for a different byte order";
+		throw AssetPackException(os.str().c_str());
+	}
+
+	if (header->fileSize != mappingSize ||
+			(mappingSize - sizeof(FileHeader)) / sizeof(Entry) < numEntries) {
+		os << "The file is truncated";
+		throw AssetPackException(os.str().c_str());
+	}
+
+	for (uint32_t i = 0; i < numEntries; i++) {
+		Entry const &entry = entries[i];
+		uint64_t blobSize = 0;
+
+		if (memchr(entry.name,0,maxNameLength) == nullptr) {
+			os << "Name of entry " << i << " is not terminated";
+			throw AssetPackException(os.str().c_str());
+		}
+
+		if (i > 0 && compareName(entries[i - 1],entry.name) >= 0) {
+			os << "The index is not sorted at \"" << entry.name << '"';
+			throw AssetPackException(os.str().c_str());
+		}
+
+		switch (entry.type) {
+		case Texture:
+		case CompressedTexture:
+			if (entry.width == 0 || entry.height == 0 || entry.numLevels == 0 || entry.numLevels > 32) {
+				os << "Texture \"" << entry.name << "\" has an invalid size";
+				throw AssetPackException(os.str().c_str());
+			}
+			if (getLevelSize(entry,0) == 0) {
+				os << "Texture \"" << entry.name << "\" has an unsupported format";
+				throw AssetPackException(os.str().c_str());
+			}
+			blobSize = getLevelOffset(entry,entry.numLevels - 1) + getLevelSize(entry,entry.numLevels - 1);
+			break;
+		case Buffer:
+			blobSize = entry.size;
+			break;
+		case Text:
+			// Including the terminating 0
+			blobSize = entry.size + 1;
+			break;
+		default:
+			os << "Entry \"" << entry.name << "\" has the unknown type " << entry.type;
+			throw AssetPackException(os.str().c_str());
+		}
+
+		if (entry.offset % blobAlignment != 0 || entry.offset > mappingSize || blobSize > mappingSize - entry.offset) {
+			os << "Data of entry \"" << entry.name << "\" is outside of the file";
+			throw AssetPackException(os.str().c_str());
+		}
+
+		if (entry.type == Text && mapping[entry.offset + entry.size] != 0) {
+			os << "Text \"" << entry.name << "\" is not terminated";
+			throw AssetPackException(os.str().c_str());
+		}
+
+		LOG4CXX_DEBUG(logger,"Entry \"" << entry.name << "\": type " << entry.type << ", "
+				<< entry.width << 'x' << entry.height << ", " << entry.numLevels << " levels, " << blobSize << " bytes");
+	}
+}
+
+AssetPack::Entry const *AssetPack::findEntry(char const *name) const {
+
+	if (name[0] == '.' && name[1] == '/') {
+		name += 2;
+	}
+
+	Entry const *end = entries + numEntries;
+	Entry const *entry = std::lower_bound(entries,end,name,[] (Entry const &e,char const *n) {
+		return compareName(e,n) < 0;
+	});
+
+	if (entry == end || compareName(*entry,name) != 0) {
+		return nullptr;
+	}
+
+	return entry;
+}
+
+char const *AssetPack::getText(Entry const &entry) const {
+
+	if (entry.type != Text) {
+		std::ostringstream os;
+		os << "AssetPack: Entry \"" << entry.name << "\" is not a text";
+		throw AssetPackException(os.str().c_str());
+	}
+
+	return reinterpret_cast<char const *>(mapping + entry.offset);
+}
+
+void AssetPack::uploadTexture(Entry const &entry,GLTexture &texture) const {
+
+	for (uint32_t i = 0; i < entry.numLevels; i++) {
+		GLsizei const width = GLsizei(getLevelWidth(entry,i));
+		GLsizei const height = GLsizei(getLevelHeight(entry,i));
+
+		switch (entry.type) {
+		case Texture:
+			texture.setTextureData(width,height,TextureData::GlFormat(entry.glFormat),TextureData::DataType(entry.dataType),
+					getLevelData(entry,i),GLint(i));
+			break;
+		case CompressedTexture:
+			texture.setCompressedTextureData(width,height,entry.glFormat,GLsizei(getLevelSize(entry,i)),
+					getLevelData(entry,i),GLint(i));
+			break;
+		default: {
+				std::ostringstream os;
+				os << "AssetPack: Entry \"" << entry.name << "\" is not a texture";
+				throw AssetPackException(os.str().c_str());
+			}
+		}
+	}
+}
+
+void AssetPack::uploadBuffer(Entry const &entry,GLenum target,GLuint bufferHandle,GLenum usage) const {
+
+	if (entry.type != Buffer) {
+		std::ostringstream os;
+		os << "AssetPack: Entry \"" << entry.name << "\" is not a buffer";
+		throw AssetPackException(os.str().c_str());
+	}
+
+	GLStateCache::getStateCache().bindBuffer(target,bufferHandle);
+	glBufferData(target,GLsizeiptr(entry.size),getLevelData(entry),usage);
+}
+
+} /* namespace OevGLES */
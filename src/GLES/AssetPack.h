@@ -0,0 +1,289 @@
+/*
+ * AssetPack.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Pack of precooked assets which is mapped into memory, and uploaded to GL without decoding.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifndef GLES_ASSETPACK_H_
+#define GLES_ASSETPACK_H_
+
+#include <string>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include "GLES/GLTexture.h"
+
+namespace OevGLES {
+
+/** \brief Pack of precooked assets in one file
+ *
+ * Decoding PNG images and converting them is the largest part of the start time on small CPUs.
+ * The pack builder (Tools/AssetPackBuilder) does this at build time, and stores the results in the format
+ * which is passed to GL as it is. At run time the pack is mapped into memory with one sequential read-ahead,
+ * and glTexImage2D() and glBufferData() read directly from the mapping.
+ *
+ * Layout of the file:
+ * - \ref FileHeader
+ * - \ref Entry records of the index, sorted by name
+ * - The data blobs of the entries. Each blob, and each mip level of a texture, starts at a multiple of \ref blobAlignment.
+ *
+ * All numbers are in the byte order of the target. The pack is rejected when the byte order differs.
+ *
+ * The layout helpers are inline because the pack builder uses them without linking GL.
+ * There is only one pack which is obtained with \ref getAssetPack().
+ */
+class AssetPack {
+public:
+
+	enum EntryType {
+		/// \brief Uncompressed texture with one or more mip levels
+		Texture				= 1,
+		/// \brief ETC1 texture with one or more mip levels
+		CompressedTexture	= 2,
+		/// \brief Vertex or index data for glBufferData()
+		Buffer				= 3,
+		/// \brief Text, e.g. shader source. A 0 follows the text in the pack.
+		Text				= 4
+	};
+
+	/// \brief Identifies the pack file, and the version of the layout
+	static constexpr char fileMagic[8] = {'O','V','F','P','A','C','K','1'};
+	static constexpr uint32_t byteOrderMark = 0x01020304;
+	static constexpr size_t blobAlignment = 64;
+	/// \brief Length of the names including the terminating 0
+	static constexpr size_t maxNameLength = 56;
+
+	/// \brief Header at the start of the file
+	struct FileHeader {
+		char magic[8];
+		uint32_t byteOrder;
+		uint32_t numEntries;
+		/// \brief Size of the complete file. Detects truncated files.
+		uint64_t fileSize;
+	};
+
+	/// \brief Entry of the index
+	struct Entry {
+		/// \brief Name of the asset, usually the name of the source file without directory, e.g. "Vario5m.png"
+		char name[maxNameLength];
+		/// \brief \ref EntryType
+		uint32_t type;
+		/// \brief \ref TextureData::GlFormat of textures, the compressed format of compressed textures, else 0
+		uint32_t glFormat;
+		/// \brief \ref TextureData::DataType of textures, else 0
+		uint32_t dataType;
+		/// \brief Size of level 0 of textures in texels, else 0
+		uint32_t width;
+		uint32_t height;
+		/// \brief Number of mip levels of textures, else 1
+		uint32_t numLevels;
+		/// \brief Offset of the blob from the start of the file
+		uint64_t offset;
+		/// \brief Size of the blob in bytes. The size of the text without the terminating 0.
+		uint64_t size;
+	};
+
+	static_assert(sizeof(FileHeader) == 24,"FileHeader must not have padding");
+	static_assert(sizeof(Entry) == 96,"Entry must not have padding");
+
+	/** \brief Return the only instance of the pack
+	 *
+	 * @return Reference to the pack
+	 */
+	static AssetPack &getAssetPack();
+
+	/** \brief Map a pack file into memory, and validate the index
+	 *
+	 * A pack which is already open is closed before.
+	 *
+	 * @param fileName Path of the pack
+	 * @throws AssetPackException when the file cannot be mapped, or is not a valid pack
+	 */
+	void open(char const *fileName);
+
+	/// \brief Unmap the pack. Pointers into the pack are invalid afterwards.
+	void close();
+
+	bool isOpen() const {
+		return mapping != nullptr;
+	}
+
+	std::string const &getFileName() const {
+		return fileName;
+	}
+
+	uint32_t getNumEntries() const {
+		return numEntries;
+	}
+
+	Entry const &getEntry(uint32_t entryNo) const {
+		return entries[entryNo];
+	}
+
+	/** \brief Look up an asset by name
+	 *
+	 * A leading "./" of the name is ignored, i.e. "./Vario5m.png" finds "Vario5m.png".
+	 *
+	 * @param name Name of the asset
+	 * @return The entry, or nullptr when the pack is not open or does not contain the asset
+	 */
+	Entry const *findEntry(char const *name) const;
+
+	/** \brief Pointer to the data of a mip level within the mapping
+	 *
+	 * @param entry Entry of this pack
+	 * @param levelNo Mip level. 0 for other types than textures.
+	 * @return Start of the data
+	 */
+	void const *getLevelData(Entry const &entry,uint32_t levelNo = 0) const {
+		return mapping + entry.offset + getLevelOffset(entry,levelNo);
+	}
+
+	/** \brief Text of an entry of type \ref Text
+	 *
+	 * @param entry Entry of this pack
+	 * @return The 0 terminated text within the mapping
+	 * @throws AssetPackException when the entry is not a text
+	 */
+	char const *getText(Entry const &entry) const;
+
+	/** \brief Upload all mip levels of a texture entry directly from the mapping
+	 *
+	 * Set a mip-map minification filter when the entry has more than one level.
+	 *
+	 * @param entry Entry of this pack
+	 * @param texture Target texture
+	 * @throws AssetPackException when the entry is not a texture
+	 */
+	void uploadTexture(Entry const &entry,GLTexture &texture) const;
+
+	/** \brief Upload a buffer entry directly from the mapping with glBufferData()
+	 *
+	 * @param entry Entry of this pack
+	 * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+	 * @param bufferHandle Buffer object which receives the data
+	 * @param usage Usage hint of glBufferData()
+	 * @throws AssetPackException when the entry is not a buffer
+	 */
+	void uploadBuffer(Entry const &entry,GLenum target,GLuint bufferHandle,GLenum usage = GL_STATIC_DRAW) const;
+
+	/// \brief Round up to the next multiple of \ref blobAlignment
+	static uint64_t alignBlob(uint64_t size) {
+		return (size + blobAlignment - 1) / blobAlignment * blobAlignment;
+	}
+
+	/// \brief Size of a texture level in texels, or 0 when the level does not exist
+	static uint32_t getLevelWidth(Entry const &entry,uint32_t levelNo) {
+		return levelNo < 32 ? std::max<uint32_t>(entry.width >> levelNo,1) : 0;
+	}
+
+	static uint32_t getLevelHeight(Entry const &entry,uint32_t levelNo) {
+		return levelNo < 32 ? std::max<uint32_t>(entry.height >> levelNo,1) : 0;
+	}
+
+	/** \brief Size of the data of a mip level in bytes. The rows of uncompressed textures are tightly packed.
+	 *
+	 * @param entry The entry
+	 * @param levelNo Mip level
+	 * @return Size in bytes, 0 when the format is not supported.
+	 */
+	static uint64_t getLevelSize(Entry const &entry,uint32_t levelNo) {
+		uint64_t const width = getLevelWidth(entry,levelNo);
+		uint64_t const height = getLevelHeight(entry,levelNo);
+
+		switch (entry.type) {
+		case Texture:
+			return width * height * getBytesPerTexel(entry.glFormat,entry.dataType);
+		case CompressedTexture:
+			return entry.glFormat == GL_ETC1_RGB8_OES ? CompressedTextureData::getEtc1DataSize(width,height) : 0;
+		default:
+			return entry.size;
+		}
+	}
+
+	/// \brief Offset of a mip level from the start of the blob. Each level starts at a multiple of \ref blobAlignment.
+	static uint64_t getLevelOffset(Entry const &entry,uint32_t levelNo) {
+		uint64_t offset = 0;
+
+		for (uint32_t i = 0; i < levelNo; i++) {
+			offset += alignBlob(getLevelSize(entry,i));
+		}
+
+		return offset;
+	}
+
+	/// \brief Size of a texel of an uncompressed texture, 0 for invalid combinations
+	static uint32_t getBytesPerTexel(uint32_t glFormat,uint32_t dataType) {
+
+		switch (dataType) {
+		case TextureData::Byte:
+			switch (glFormat) {
+			case TextureData::Luminance:
+				return 1;
+			case TextureData::LuminanceA:
+				return 2;
+			case TextureData::RGB:
+				return 3;
+			case TextureData::RGBA:
+				return 4;
+			default:
+				return 0;
+			}
+		case TextureData::Short565:
+			return glFormat == TextureData::RGB ? 2 : 0;
+		case TextureData::Short4444:
+		case TextureData::Short5551:
+			return glFormat == TextureData::RGBA ? 2 : 0;
+		default:
+			return 0;
+		}
+	}
+
+private:
+
+	AssetPack();
+	~AssetPack();
+
+	std::string fileName;
+
+	uint8_t const *mapping = nullptr;
+	size_t mappingSize = 0;
+
+	Entry const *entries = nullptr;
+	uint32_t numEntries = 0;
+
+	/// \brief Check the index and the blobs against the size of the mapping
+	void validate() const;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLES_ASSETPACK_H_ */
@@ -28,6 +28,8 @@
 #endif
 
 #include <sstream>
+#include <algorithm>
+#include <string.h>
 
 #include "OVFCommon.h"
 
@@ -36,6 +38,11 @@
 #include "GLES/sysEGLWindow.h"
 #include "GLES/ExceptionBase.h"
 
+// Older EGL headers do not define the buffer age extension
+#if !defined EGL_BUFFER_AGE_EXT
+#	define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 namespace OevGLES {
 
 #if defined HAVE_LOG4CXX_H
@@ -57,6 +64,17 @@ EGLRenderSurface::EGLRenderSurface()
 
 EGLRenderSurface::~EGLRenderSurface() {
 
+	if (offscreenFramebuffer != 0) {
+		glBindFramebuffer(GL_FRAMEBUFFER,0);
+		glDeleteFramebuffers(1,&offscreenFramebuffer);
+	}
+	if (offscreenColorBuffer != 0) {
+		glDeleteRenderbuffers(1,&offscreenColorBuffer);
+	}
+	if (offscreenDepthBuffer != 0) {
+		glDeleteRenderbuffers(1,&offscreenDepthBuffer);
+	}
+
 	if (eglDisplay != EGL_NO_DISPLAY) {
 		eglMakeCurrent(eglDisplay,EGL_NO_SURFACE,EGL_NO_SURFACE,EGL_NO_CONTEXT);
 	}
@@ -93,65 +111,14 @@ void EGLRenderSurface::createRenderSurface (GLint width, GLint height,
 		throw EGLException(errStr.str().c_str());
 	}
 
-	if (eglInitialize(eglDisplay,&eglMajorVersion,&eglMinorVersion) == EGL_FALSE) {
+	initializeDisplay();
+
+	if (!chooseConfig(EGL_WINDOW_BIT,config)) {
 		std::ostringstream errStr;
-		errStr << "Cannot initialize EGL. Error = " << eglGetError();
+		errStr << "Could not retrieve valid EGL configuration. Error = " << eglGetError();
 
 		throw EGLException(errStr.str().c_str());
 	}
-    LOG4CXX_INFO(logger,"Initialized EGL. EGL Version = " << eglMajorVersion << '.' << eglMinorVersion);
-
-    {
-    	EGLint numReturnedConfigs = 0;
-
-        EGLint attribList [] = {
-        		EGL_COLOR_BUFFER_TYPE, EGL_RGB_BUFFER,
-        		EGL_RENDERABLE_TYPE	, EGL_OPENGL_ES2_BIT,
-				EGL_RED_SIZE 		, 8,
-				EGL_GREEN_SIZE		, 8,
-				EGL_BLUE_SIZE		, 8,
-				EGL_ALPHA_SIZE		, 8,
-				EGL_DEPTH_SIZE		, 16,
-				EGL_SAMPLE_BUFFERS  , 1,
-				EGL_SAMPLES         , 2,
-				EGL_NONE
-        };
-
-        if (eglChooseConfig(eglDisplay,attribList,&config,1,&numReturnedConfigs)){
-			if (numReturnedConfigs == 0) {
-				// Do not prescribe a sample number
-				attribList[16] = EGL_NONE;
-		        eglChooseConfig(eglDisplay,attribList,&config,1,&numReturnedConfigs);
-				if (numReturnedConfigs == 0) {
-					// Do not prescribe a sample buffer at all
-					attribList[14] = EGL_NONE;
-			        eglChooseConfig(eglDisplay,attribList,&config,1,&numReturnedConfigs);
-				}
-			}
-
-
-#if defined HAVE_LOG4CXX_H
-			if (logger->getLevel() == log4cxx::Level::getDebug()) {
-				debugPrintConfig (&config,numReturnedConfigs);
-			}
-
-#endif // if defined HAVE_LOG4CXX_H
-			if (numReturnedConfigs == 0) {
-    		std::ostringstream errStr;
-    		errStr << "Could not retrieve valid EGL configuration. Error = " << eglGetError();
-
-    		throw EGLException(errStr.str().c_str());
-			}
-
-
-        } else {
-    		std::ostringstream errStr;
-    		errStr << "Could not retrieve valid EGL configuration. Error = " << eglGetError();
-
-    		throw EGLException(errStr.str().c_str());
-        }
-
-    }
     
     {
     	EGLint attribList[] = {
@@ -172,35 +139,367 @@ void EGLRenderSurface::createRenderSurface (GLint width, GLint height,
 
     };
 
-    {
+    createContext(config);
+    
+	if (!eglMakeCurrent(eglDisplay,renderSurface,renderSurface,renderContext)) {
+		std::ostringstream errStr;
+		errStr << "Error calling eglMakeCurrent. Error = " << eglGetError();
+
+		throw EGLException(errStr.str().c_str());
+	}
+
+	LOG4CXX_DEBUG(logger,"renderContext is now current");
+
+	surfaceMode = WindowSurface;
+	surfaceWidth = width;
+	surfaceHeight = height;
+
+	detectDamageExtensions();
+
+}
+
+void EGLRenderSurface::createOffscreenSurface (GLint width, GLint height) {
+	EGLConfig config = nullptr;
+	char const *clientExtensions = eglQueryString(EGL_NO_DISPLAY,EGL_EXTENSIONS);
+
+	LOG4CXX_DEBUG(logger,"EGL client extensions = " << (clientExtensions ? clientExtensions : "<none>"));
+
+	surfaceWidth = width;
+	surfaceHeight = height;
+
+#if defined EGL_PLATFORM_SURFACELESS_MESA
+	if (clientExtensions && strstr(clientExtensions,"EGL_MESA_platform_surfaceless")) {
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+				(PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+		if (getPlatformDisplay) {
+			eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,EGL_DEFAULT_DISPLAY,NULL);
+			LOG4CXX_DEBUG(logger,"Surfaceless platform eglDisplay = " << eglDisplay);
+		}
+	}
+#endif // if defined EGL_PLATFORM_SURFACELESS_MESA
+
+	if (eglDisplay == EGL_NO_DISPLAY) {
+		eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	    LOG4CXX_DEBUG(logger,"Default eglDisplay = " << eglDisplay);
+	}
+
+	if (eglDisplay == EGL_NO_DISPLAY) {
+		std::ostringstream errStr;
+		errStr << "Cannot get an EGL display for offscreen rendering. Error = " << eglGetError();
+
+		throw EGLException(errStr.str().c_str());
+	}
+
+	initializeDisplay();
+
+	if (chooseConfig(EGL_PBUFFER_BIT,config)) {
     	EGLint attribList[] = {
-    			EGL_CONTEXT_CLIENT_VERSION , 2,
+    			EGL_WIDTH	, width,
+				EGL_HEIGHT	, height,
 				EGL_NONE
     	};
 
-    	renderContext = eglCreateContext(eglDisplay,config,EGL_NO_CONTEXT,attribList);
+    	renderSurface = eglCreatePbufferSurface(eglDisplay,config,attribList);
+        LOG4CXX_DEBUG(logger,"pbuffer renderSurface = " << renderSurface);
+	}
 
-        LOG4CXX_DEBUG(logger,"renderContext = " << renderContext);
+	if (renderSurface != EGL_NO_SURFACE) {
+		createContext(config);
 
-    	if (renderContext == EGL_NO_CONTEXT) {
-    		std::ostringstream errStr;
-    		errStr << "Error calling eglCreateContext. Error = " << eglGetError();
+		if (!eglMakeCurrent(eglDisplay,renderSurface,renderSurface,renderContext)) {
+			std::ostringstream errStr;
+			errStr << "Error calling eglMakeCurrent with a pbuffer surface. Error = " << eglGetError();
 
-    		throw EGLException(errStr.str().c_str());
-    	}
+			throw EGLException(errStr.str().c_str());
+		}
 
-    };
-    
-	if (!eglMakeCurrent(eglDisplay,renderSurface,renderSurface,renderContext)) {
+		surfaceMode = PbufferSurface;
+	    LOG4CXX_INFO(logger,"Rendering headless into an EGL pbuffer of " << width << 'x' << height);
+
+	} else {
+		char const *displayExtensions = eglQueryString(eglDisplay,EGL_EXTENSIONS);
+
+		LOG4CXX_DEBUG(logger,"No pbuffer available. EGL display extensions = " << (displayExtensions ? displayExtensions : "<none>"));
+
+		if (!displayExtensions || !strstr(displayExtensions,"EGL_KHR_surfaceless_context")) {
+			std::ostringstream errStr;
+			errStr << "Neither EGL pbuffers nor EGL_KHR_surfaceless_context are available for offscreen rendering. Error = " << eglGetError();
+
+			throw EGLException(errStr.str().c_str());
+		}
+
+		if (!chooseConfig(0,config)) {
+			std::ostringstream errStr;
+			errStr << "Could not retrieve valid EGL configuration for a surfaceless context. Error = " << eglGetError();
+
+			throw EGLException(errStr.str().c_str());
+		}
+
+		createContext(config);
+
+		if (!eglMakeCurrent(eglDisplay,EGL_NO_SURFACE,EGL_NO_SURFACE,renderContext)) {
+			std::ostringstream errStr;
+			errStr << "Error calling eglMakeCurrent without surface. Error = " << eglGetError();
+
+			throw EGLException(errStr.str().c_str());
+		}
+
+		createOffscreenFramebuffer();
+
+		surfaceMode = SurfacelessFBO;
+	    LOG4CXX_INFO(logger,"Rendering headless into a framebuffer object of " << width << 'x' << height);
+	}
+
+	glViewport(0,0,width,height);
+
+	LOG4CXX_DEBUG(logger,"renderContext is now current");
+
+}
+
+void EGLRenderSurface::initializeDisplay() {
+
+	if (eglInitialize(eglDisplay,&eglMajorVersion,&eglMinorVersion) == EGL_FALSE) {
 		std::ostringstream errStr;
-		errStr << "Error calling eglMakeCurrent. Error = " << eglGetError();
+		errStr << "Cannot initialize EGL. Error = " << eglGetError();
 
 		throw EGLException(errStr.str().c_str());
 	}
+    LOG4CXX_INFO(logger,"Initialized EGL. EGL Version = " << eglMajorVersion << '.' << eglMinorVersion);
 
-	LOG4CXX_DEBUG(logger,"renderContext is now current");
+}
+
+bool EGLRenderSurface::chooseConfig(EGLint surfaceType,EGLConfig &config) {
+	EGLint numReturnedConfigs = 0;
+
+	EGLint attribList [] = {
+			EGL_SURFACE_TYPE	, surfaceType,
+			EGL_COLOR_BUFFER_TYPE, EGL_RGB_BUFFER,
+			EGL_RENDERABLE_TYPE	, EGL_OPENGL_ES2_BIT,
+			EGL_RED_SIZE 		, 8,
+			EGL_GREEN_SIZE		, 8,
+			EGL_BLUE_SIZE		, 8,
+			EGL_ALPHA_SIZE		, 8,
+			EGL_DEPTH_SIZE		, 16,
+			EGL_SAMPLE_BUFFERS  , 1,
+			EGL_SAMPLES         , 2,
+			EGL_NONE
+	};
+
+	if (surfaceType == 0) {
+		// A surfaceless context renders into an FBO. The config does not need any surface type,
+		// nor a depth buffer, and multi-sampling would be lost anyway.
+		attribList[1] = EGL_DONT_CARE;
+		attribList[14] = EGL_DEPTH_SIZE;
+		attribList[15] = 0;
+		attribList[16] = EGL_NONE;
+	}
+
+	if (!eglChooseConfig(eglDisplay,attribList,&config,1,&numReturnedConfigs)){
+		return false;
+	}
+
+	if (numReturnedConfigs == 0 && attribList[16] != EGL_NONE) {
+		// Do not prescribe a sample number
+		attribList[18] = EGL_NONE;
+		eglChooseConfig(eglDisplay,attribList,&config,1,&numReturnedConfigs);
+		if (numReturnedConfigs == 0) {
+			// Do not prescribe a sample buffer at all
+			attribList[16] = EGL_NONE;
+			eglChooseConfig(eglDisplay,attribList,&config,1,&numReturnedConfigs);
+		}
+	}
+
+
+#if defined HAVE_LOG4CXX_H
+	if (logger->getLevel() == log4cxx::Level::getDebug()) {
+		debugPrintConfig (&config,numReturnedConfigs);
+	}
+
+#endif // if defined HAVE_LOG4CXX_H
+
+	return numReturnedConfigs > 0;
+}
+
+void EGLRenderSurface::createContext(EGLConfig config) {
+	EGLint attribList[] = {
+			EGL_CONTEXT_CLIENT_VERSION , 2,
+			EGL_NONE
+	};
+
+	renderContext = eglCreateContext(eglDisplay,config,EGL_NO_CONTEXT,attribList);
+
+	LOG4CXX_DEBUG(logger,"renderContext = " << renderContext);
+
+	if (renderContext == EGL_NO_CONTEXT) {
+		std::ostringstream errStr;
+		errStr << "Error calling eglCreateContext. Error = " << eglGetError();
+
+		throw EGLException(errStr.str().c_str());
+	}
+
+}
+
+void EGLRenderSurface::createOffscreenFramebuffer() {
+	char const *glExtensions = (char const*) glGetString(GL_EXTENSIONS);
+	GLenum colorFormat = GL_RGB565;
+	GLenum fbStatus;
+
+#if defined GL_RGBA8_OES
+	if (glExtensions && strstr(glExtensions,"GL_OES_rgb8_rgba8")) {
+		colorFormat = GL_RGBA8_OES;
+	}
+#endif
+
+	glGenFramebuffers(1,&offscreenFramebuffer);
+	glGenRenderbuffers(1,&offscreenColorBuffer);
+	glGenRenderbuffers(1,&offscreenDepthBuffer);
+
+	glBindRenderbuffer(GL_RENDERBUFFER,offscreenColorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER,colorFormat,surfaceWidth,surfaceHeight);
+
+	glBindRenderbuffer(GL_RENDERBUFFER,offscreenDepthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER,GL_DEPTH_COMPONENT16,surfaceWidth,surfaceHeight);
+
+	glBindFramebuffer(GL_FRAMEBUFFER,offscreenFramebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,GL_RENDERBUFFER,offscreenColorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER,GL_DEPTH_ATTACHMENT,GL_RENDERBUFFER,offscreenDepthBuffer);
+
+	fbStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	LOG4CXX_DEBUG(logger,"Offscreen framebuffer = " << offscreenFramebuffer << ", status = " << fbStatus);
+
+	if (fbStatus != GL_FRAMEBUFFER_COMPLETE) {
+		std::ostringstream errStr;
+		errStr << "Offscreen framebuffer is incomplete. Status = " << fbStatus;
+
+		throw EGLException(errStr.str().c_str());
+	}
+
+}
+
+void EGLRenderSurface::swapBuffers() {
+
+	if (surfaceMode == SurfacelessFBO) {
+		glFlush();
+	} else {
+		eglSwapBuffers(eglDisplay,renderSurface);
+	}
+
+}
+
+void EGLRenderSurface::DamageRect::unite(DamageRect const &other) {
+
+	if (other.isEmpty()) {
+		return;
+	}
+	if (isEmpty()) {
+		*this = other;
+		return;
+	}
+
+	EGLint const right = std::max(x + width,other.x + other.width);
+	EGLint const top = std::max(y + height,other.y + other.height);
+
+	x = std::min(x,other.x);
+	y = std::min(y,other.y);
+	width = right - x;
+	height = top - y;
+}
+
+void EGLRenderSurface::DamageRect::intersect(DamageRect const &other) {
+	EGLint const right = std::min(x + width,other.x + other.width);
+	EGLint const top = std::min(y + height,other.y + other.height);
+
+	x = std::max(x,other.x);
+	y = std::max(y,other.y);
+	width = std::max(right - x,0);
+	height = std::max(top - y,0);
+}
+
+void EGLRenderSurface::detectDamageExtensions() {
+	char const *displayExtensions = eglQueryString(eglDisplay,EGL_EXTENSIONS);
+
+	if (!displayExtensions) {
+		return;
+	}
+
+	if (strstr(displayExtensions,"EGL_KHR_swap_buffers_with_damage")) {
+		swapBuffersWithDamageFunc = (SwapBuffersWithDamageFunc) eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+	}
+	if (!swapBuffersWithDamageFunc && strstr(displayExtensions,"EGL_EXT_swap_buffers_with_damage")) {
+		swapBuffersWithDamageFunc = (SwapBuffersWithDamageFunc) eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+	}
+	if (strstr(displayExtensions,"EGL_KHR_partial_update")) {
+		setDamageRegionFunc = (SetDamageRegionFunc) eglGetProcAddress("eglSetDamageRegionKHR");
+	}
+	// EGL_KHR_partial_update includes the buffer age query
+	bufferAgeSupported = strstr(displayExtensions,"EGL_EXT_buffer_age") || setDamageRegionFunc;
+
+	LOG4CXX_INFO(logger,"Swap buffers with damage: " << (swapBuffersWithDamageFunc ? "yes" : "no")
+			<< ", partial update: " << (setDamageRegionFunc ? "yes" : "no")
+			<< ", buffer age: " << (bufferAgeSupported ? "yes" : "no"));
+}
+
+void EGLRenderSurface::fillDamageRectBuffer(std::vector<DamageRect> const &damage) {
+
+	damageRectBuffer.clear();
+	for (auto const &rect : damage) {
+		damageRectBuffer.push_back(rect.x);
+		damageRectBuffer.push_back(rect.y);
+		damageRectBuffer.push_back(rect.width);
+		damageRectBuffer.push_back(rect.height);
+	}
+}
+
+void EGLRenderSurface::swapBuffers(std::vector<DamageRect> const &damage) {
+
+	if (surfaceMode != WindowSurface || !swapBuffersWithDamageFunc || damage.empty()) {
+		swapBuffers();
+		return;
+	}
+
+	fillDamageRectBuffer(damage);
+	swapBuffersWithDamageFunc(eglDisplay,renderSurface,damageRectBuffer.data(),EGLint(damage.size()));
+}
+
+EGLint EGLRenderSurface::getBufferAge() {
+	EGLint age = 0;
+
+	if (isOffscreen()) {
+		return 1;
+	}
+
+	if (bufferAgeSupported && !eglQuerySurface(eglDisplay,renderSurface,EGL_BUFFER_AGE_EXT,&age)) {
+		age = 0;
+	}
+
+	return age;
+}
+
+void EGLRenderSurface::setDamageRegion(std::vector<DamageRect> const &damage) {
+
+	if (surfaceMode != WindowSurface || !setDamageRegionFunc || damage.empty()) {
+		return;
+	}
+
+	fillDamageRectBuffer(damage);
+	setDamageRegionFunc(eglDisplay,renderSurface,damageRectBuffer.data(),EGLint(damage.size()));
+}
+
+void EGLRenderSurface::readPixels(std::vector<GLubyte> &pixels) {
+
+	pixels.resize(size_t(surfaceWidth) * size_t(surfaceHeight) * 4);
+
+	glPixelStorei(GL_PACK_ALIGNMENT,1);
+	glReadPixels(0,0,surfaceWidth,surfaceHeight,GL_RGBA,GL_UNSIGNED_BYTE,pixels.data());
+
+}
 
+void EGLRenderSurface::bindFramebuffer() {
 
+	// Window and pbuffer surfaces are framebuffer 0. In surfaceless mode it is the offscreen framebuffer.
+	glBindFramebuffer(GL_FRAMEBUFFER,offscreenFramebuffer);
+	glViewport(0,0,surfaceWidth,surfaceHeight);
 
 }
 
@@ -27,6 +27,8 @@
 #define GLES_EGLRENDERSURFACE_H_
 
 
+#include <vector>
+
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <EGL/eglplatform.h>
@@ -39,6 +41,38 @@ namespace OevGLES {
 
 class EGLRenderSurface {
 public:
+
+	/** \brief Kind of render target which was created
+	 *
+	 */
+	enum SurfaceMode {
+		NoSurface,			///< Nothing created yet
+		WindowSurface,		///< Native window, created with \ref createRenderSurface
+		PbufferSurface,		///< Headless EGL pbuffer surface, created with \ref createOffscreenSurface
+		SurfacelessFBO		///< Headless surfaceless context rendering into a framebuffer object, created with \ref createOffscreenSurface
+	};
+
+	/** \brief Rectangle of the render target which changed in a frame
+	 *
+	 * Coordinates are in pixels with the origin in the lower left corner like glScissor() and EGL damage rectangles.
+	 */
+	struct DamageRect {
+		EGLint x = 0;
+		EGLint y = 0;
+		EGLint width = 0;
+		EGLint height = 0;
+
+		bool isEmpty() const {
+			return width <= 0 || height <= 0;
+		}
+
+		/// \brief Extend this rectangle to the bounding rectangle of this and other
+		void unite(DamageRect const &other);
+
+		/// \brief Reduce this rectangle to the intersection with other
+		void intersect(DamageRect const &other);
+	};
+
 	EGLRenderSurface();
 
 	virtual ~EGLRenderSurface();
@@ -46,8 +80,104 @@ public:
 	void createRenderSurface (GLint width, GLint height,
 			char const* windowName = 0, char const* displayName = 0);
 
+	/** \brief Create a headless render target without a native window
+	 *
+	 * Intended for CI and benchmark runs on machines without a display, e.g. with the Mesa software rasterizer.
+	 *
+	 * The display is obtained from the Mesa surfaceless platform (EGL_MESA_platform_surfaceless) when available,
+	 * else the default display is used.
+	 * Then an EGL pbuffer surface is created. When the display does not offer pbuffer configurations but supports
+	 * EGL_KHR_surfaceless_context the context is made current without a surface,
+	 * and a framebuffer object with color and depth renderbuffers is bound as render target instead.
+	 *
+	 * After the call the context is current, and the viewport covers the complete render target.
+	 *
+	 * @param width Width of the render target in pixels
+	 * @param height Height of the render target in pixels
+	 * @throws EGLException when neither a pbuffer nor a surfaceless context can be created
+	 */
+	void createOffscreenSurface (GLint width, GLint height);
+
 	void makeContextCurrent();
 
+	/** \brief Present the rendered frame.
+	 *
+	 * Swaps the buffers of a window or pbuffer surface. For a surfaceless FBO target the rendering commands are flushed only.
+	 */
+	void swapBuffers();
+
+	/** \brief Present the rendered frame, and tell EGL which parts of the frame changed.
+	 *
+	 * The damage is passed to eglSwapBuffersWithDamageKHR/EXT when the extension is available.
+	 * The compositor or display controller can then update only the damaged parts of the screen.
+	 * Without the extension this is a plain \ref swapBuffers().
+	 *
+	 * @param damage Damaged rectangles of the frame. An empty vector means the complete frame.
+	 */
+	void swapBuffers(std::vector<DamageRect> const &damage);
+
+	/** \brief Age of the back buffer as defined by EGL_EXT_buffer_age
+	 *
+	 * - 0: The content of the back buffer is undefined. The complete frame must be drawn.
+	 * - 1: The back buffer contains the previous frame.
+	 * - n: The back buffer contains the frame before n-1 frames.
+	 *
+	 * Offscreen targets render into a single buffer whose content is preserved, and always return 1.
+	 *
+	 * @return Buffer age
+	 */
+	EGLint getBufferAge();
+
+	/** \brief Restrict the region of the back buffer which is updated by the next frame (EGL_KHR_partial_update)
+	 *
+	 * Must be called before the first draw call of the frame. Does nothing when the extension is not available.
+	 *
+	 * @param damage The rectangles which will be redrawn
+	 */
+	void setDamageRegion(std::vector<DamageRect> const &damage);
+
+	bool hasSwapBuffersWithDamage() const {
+		return swapBuffersWithDamageFunc != nullptr;
+	}
+
+	bool hasPartialUpdate() const {
+		return setDamageRegionFunc != nullptr;
+	}
+
+	bool hasBufferAge() const {
+		return bufferAgeSupported;
+	}
+
+	/** \brief Read back the color buffer of the current render target
+	 *
+	 * Mainly useful to verify headless rendering results.
+	 *
+	 * @param[out] pixels RGBA pixels, 4 bytes per pixel, bottom row first
+	 */
+	void readPixels(std::vector<GLubyte> &pixels);
+
+	/** \brief Make the surface the render target again, e.g. after rendering into a \ref GLRenderTarget
+	 *
+	 * Binds the framebuffer of the surface, and sets the viewport to the complete surface.
+	 */
+	void bindFramebuffer();
+
+	SurfaceMode getSurfaceMode() const {
+		return surfaceMode;
+	}
+
+	bool isOffscreen() const {
+		return surfaceMode == PbufferSurface || surfaceMode == SurfacelessFBO;
+	}
+
+	GLint getWidth() const {
+		return surfaceWidth;
+	}
+
+	GLint getHeight() const {
+		return surfaceHeight;
+	}
+
 	EGLDisplay getDisplay() const {
 		return eglDisplay;
 	}
@@ -77,6 +207,62 @@ protected:
     EGLint eglMajorVersion = 0;
     EGLint eglMinorVersion = 0;
 
+    SurfaceMode				surfaceMode = NoSurface;
+    GLint					surfaceWidth = 0;
+    GLint					surfaceHeight = 0;
+
+    // Damage extensions of the window surface
+    typedef EGLBoolean (EGLAPIENTRYP SwapBuffersWithDamageFunc) (EGLDisplay dpy, EGLSurface surface, const EGLint *rects, EGLint n_rects);
+    typedef EGLBoolean (EGLAPIENTRYP SetDamageRegionFunc) (EGLDisplay dpy, EGLSurface surface, EGLint *rects, EGLint n_rects);
+
+    SwapBuffersWithDamageFunc	swapBuffersWithDamageFunc = nullptr;
+    SetDamageRegionFunc			setDamageRegionFunc = nullptr;
+    bool						bufferAgeSupported = false;
+
+    /// \brief Scratch buffer for converting damage rectangles to the EGL format
+    std::vector<EGLint>			damageRectBuffer;
+
+    // Render target of the surfaceless mode
+    GLuint					offscreenFramebuffer = 0;
+    GLuint					offscreenColorBuffer = 0;
+    GLuint					offscreenDepthBuffer = 0;
+
+    /** \brief Initialize EGL on \ref eglDisplay, and log the version.
+     *
+     * @throws EGLException
+     */
+    void initializeDisplay();
+
+    /** \brief Choose the best matching configuration for the surface type
+     *
+     * Multi-sampling is requested first, and dropped when the implementation cannot provide it.
+     *
+     * @param surfaceType EGL_WINDOW_BIT, EGL_PBUFFER_BIT, or 0 for a surfaceless context
+     * @param[out] config The chosen configuration
+     * @return true when a configuration was found
+     */
+    bool chooseConfig(EGLint surfaceType,EGLConfig &config);
+
+    /** \brief Create a GLES 2 context for the configuration, and store it in \ref renderContext
+     *
+     * @throws EGLException
+     */
+    void createContext(EGLConfig config);
+
+    /** \brief Detect the extensions for buffer age, partial update, and swap with damage on the window surface
+     *
+     */
+    void detectDamageExtensions();
+
+    /// \brief Convert the damage rectangles into \ref damageRectBuffer
+    void fillDamageRectBuffer(std::vector<DamageRect> const &damage);
+
+    /** \brief Create and bind the framebuffer object for the surfaceless mode
+     *
+     * @throws EGLException when the framebuffer is incomplete
+     */
+    void createOffscreenFramebuffer();
+
 };
 
 
@@ -96,6 +96,54 @@ public:
 		{}
 };
 
+class CompressedTextureException :public ExceptionBase {
+
+public:
+	CompressedTextureException(char const *description)
+		:ExceptionBase {description}
+		{}
+};
+
+class AssetPackException :public ExceptionBase {
+
+public:
+	AssetPackException(char const *description)
+		:ExceptionBase {description}
+		{}
+};
+
+class FontException :public ExceptionBase {
+
+public:
+	FontException(char const *description)
+		:ExceptionBase {description}
+		{}
+};
+
+class VertexFormatException :public ExceptionBase {
+
+public:
+	VertexFormatException(char const *description)
+		:ExceptionBase {description}
+		{}
+};
+
+class MeshException :public ExceptionBase {
+
+public:
+	MeshException(char const *description)
+		:ExceptionBase {description}
+		{}
+};
+
+class FramebufferException :public ExceptionBase {
+
+public:
+	FramebufferException(char const *description)
+		:ExceptionBase {description}
+		{}
+};
+
 } /* namespace OevGLES */
 
 #endif /* SRC_EXCEPTIONBASE_H_ */
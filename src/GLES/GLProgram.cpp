@@ -141,7 +141,7 @@ GLProgram::~GLProgram() {
 
 	if (programHandle != 0) {
 		LOG4CXX_DEBUG(logger,"Delete GL program " << programHandle);
-		glDeleteProgram(programHandle);
+		GLStateCache::getStateCache().deleteProgram(programHandle);
 	}
 
 }
@@ -165,7 +165,13 @@ void GLProgram::attachFragmentShader (GLFragmentShader *newFragmentShader){
 }
 
 void GLProgram::linkProgram () {
-	GLint linkResult = GL_FALSE;
+
+	startLinkProgram();
+	finishLinkProgram();
+
+}
+
+void GLProgram::startLinkProgram () {
 
 	if (!vertexShader) {
 		LOG4CXX_FATAL(logger,"Vertex shader is undefined");
@@ -176,9 +182,10 @@ void GLProgram::linkProgram () {
 		throw ProgramException("Fragment shader is undefined");
 	}
 
-	// Re-compile the shaders if necessary
-	vertexShader->compileShader();
-	fragmentShader->compileShader();
+	// Re-compile the shaders if necessary.
+	// The compile status is not queried here. It would block until the compiler is done.
+	vertexShader->startCompileShader();
+	fragmentShader->startCompileShader();
 
 	// now create the program, attach the shaders, and link the program
 	programHandle = glCreateProgram();
@@ -192,6 +199,18 @@ void GLProgram::linkProgram () {
 	glAttachShader(programHandle,*fragmentShader);
 
 	glLinkProgram(programHandle);
+
+	linkPending = true;
+}
+
+void GLProgram::finishLinkProgram () {
+	GLint linkResult = GL_FALSE;
+
+	if (!linkPending) {
+		return;
+	}
+	linkPending = false;
+
 	glGetProgramiv(programHandle,GL_LINK_STATUS,&linkResult);
 
 	LOG4CXX_DEBUG(logger,"glLinkProgram result = " <<  linkResult);
@@ -201,6 +220,10 @@ void GLProgram::linkProgram () {
 		char* infoString = 0;
 		std::string errString;
 
+		// A shader which did not compile is the more helpful error message.
+		vertexShader->checkCompileStatus();
+		fragmentShader->checkCompileStatus();
+
 		glGetProgramiv(programHandle,GL_INFO_LOG_LENGTH,&infoLen);
 		infoString = new char [infoLen+10];
 
@@ -215,12 +238,47 @@ void GLProgram::linkProgram () {
 		throw ProgramException(errString.c_str());
 	}
 
+	// Linking resets all uniforms to 0
+	uniformCache.clear();
+
 	retrieveShaderVariableInfos();
 
+	isLinked = true;
 
 }
 
 
+bool GLProgram::adoptLinkedProgram (GLuint linkedProgramHandle) {
+	GLint linkResult = GL_FALSE;
+
+	glGetProgramiv(linkedProgramHandle,GL_LINK_STATUS,&linkResult);
+
+	LOG4CXX_DEBUG(logger,"adoptLinkedProgram: program handle = " << linkedProgramHandle << ", link status = " << linkResult);
+
+	if (linkResult != GL_TRUE) {
+		return false;
+	}
+
+	detachVertexShader();
+	detachFragmentShader();
+
+	if (programHandle != 0) {
+		GLStateCache::getStateCache().deleteProgram(programHandle);
+	}
+
+	programHandle = linkedProgramHandle;
+
+	uniformCache.clear();
+	uniformMap.clear();
+	attributeMap.clear();
+
+	retrieveShaderVariableInfos();
+
+	isLinked = true;
+
+	return true;
+}
+
 void GLProgram::retrieveShaderVariableInfos() {
 
 	GLint maxLenAttributes = 0;
@@ -288,6 +346,14 @@ void GLProgram::retrieveShaderVariableInfos() {
 
 			uniformMap.insert (ShaderVariableInfoPair(std::string(buf),ShaderVariableInfo(buf,type,i)));
 
+			// Most drivers report arrays as "name[0]". Arrays are looked up by their plain name.
+			size_t const nameLen = strlen(buf);
+			if (nameLen > 3 && strcmp(buf + nameLen - 3,"[0]") == 0) {
+				std::string const arrayName (buf,nameLen - 3);
+
+				uniformMap.insert (ShaderVariableInfoPair(arrayName,ShaderVariableInfo(arrayName.c_str(),type,i)));
+			}
+
 		}
 
 		delete buf;
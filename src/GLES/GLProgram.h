@@ -31,8 +31,12 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <cstdint>
+#include <string.h>
 
 #include "GLES/GLShader.h"
+#include "GLES/GLStateCache.h"
 
 namespace OevGLES {
 
@@ -181,6 +185,41 @@ public:
 	 */
 	void linkProgram ();
 
+	/** \brief Issue compilation and linking of the program without waiting for the result.
+	 *
+	 * The link status is only checked by \ref finishLinkProgram(). In the meantime the driver can compile
+	 * in the background when it supports GL_KHR_parallel_shader_compile, and the caller can do other work.
+	 *
+	 * @throws ProgramException when the shaders are missing, or the program cannot be created.
+	 * @throws ShaderException when a shader cannot be created.
+	 */
+	void startLinkProgram ();
+
+	/** \brief Wait for the result of \ref startLinkProgram(), and query the uniforms and vertex attributes.
+	 *
+	 * Does nothing when no link is pending.
+	 *
+	 * @throws ProgramException
+	 * @throws ShaderException when a shader did not compile.
+	 */
+	void finishLinkProgram ();
+
+	/// \brief Was \ref startLinkProgram() called, but not yet \ref finishLinkProgram()?
+	bool isLinkPending () const {
+		return linkPending;
+	}
+
+	/** \brief Take over a program which was linked outside of this object, e.g. from a program binary.
+	 *
+	 * The link status is checked. When it is successful the program replaces any previous program,
+	 * and the uniforms and vertex attribute information are queried like in \ref linkProgram().
+	 * No shaders are attached in this case.
+	 *
+	 * @param linkedProgramHandle Handle of the linked program. When the call is successful this object owns the handle.
+	 * @return true when the program is linked successfully. false leaves this object unchanged, and the caller keeps the handle.
+	 */
+	bool adoptLinkedProgram (GLuint linkedProgramHandle);
+
 	/** \brief Retrieve information about an active uniform
 	 *
 	 * When the passed uniform name does not match any active uniform the function returns 0.
@@ -209,13 +248,178 @@ public:
 
 	/** \brief Use the program for subsequent rendering
 	 *
+	 * The call goes through the \ref GLStateCache, and is skipped when the program is already in use.
 	 */
 	void useProgram() {
-		glUseProgram(programHandle);
+		GLStateCache::getStateCache().useProgram(programHandle);
+	}
+
+	/** \brief Set a mat4 uniform. The matrix is only uploaded to GL when it differs from the last uploaded value.
+	 *
+	 * Like all uniform setters below the program must be in use, see \ref useProgram().
+	 * Uniform values are part of the program state in GL. Therefore the cached values stay valid
+	 * while other programs are in use.
+	 *
+	 * @param location Location of the uniform. -1 is silently ignored like glUniform* does.
+	 * @param value 16 floats in column-major order
+	 */
+	void setUniformMatrix4fv(GLint location,GLfloat const *value) {
+		if (uniformValueChanged(location,value,16 * sizeof(GLfloat))) {
+			glUniformMatrix4fv(location,1,GL_FALSE,value);
+		}
+	}
+
+	/** \brief Set a vec4 uniform when the value changed
+	 *
+	 * @param location Location of the uniform
+	 * @param value 4 floats
+	 */
+	void setUniform4fv(GLint location,GLfloat const *value) {
+		if (uniformValueChanged(location,value,4 * sizeof(GLfloat))) {
+			glUniform4fv(location,1,value);
+		}
+	}
+
+	/** \brief Set a vec3 uniform when the value changed
+	 *
+	 * @param location Location of the uniform
+	 * @param value 3 floats
+	 */
+	void setUniform3fv(GLint location,GLfloat const *value) {
+		if (uniformValueChanged(location,value,3 * sizeof(GLfloat))) {
+			glUniform3fv(location,1,value);
+		}
+	}
+
+	/** \brief Set a vec2 uniform when the value changed
+	 *
+	 * @param location Location of the uniform
+	 * @param value 2 floats
+	 */
+	void setUniform2fv(GLint location,GLfloat const *value) {
+		if (uniformValueChanged(location,value,2 * sizeof(GLfloat))) {
+			glUniform2fv(location,1,value);
+		}
+	}
+
+	/** \brief Set a float uniform when the value changed
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform1f(GLint location,GLfloat value) {
+		if (uniformValueChanged(location,&value,sizeof(GLfloat))) {
+			glUniform1f(location,value);
+		}
+	}
+
+	/** \brief Set an int or sampler uniform when the value changed
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value. For samplers the number of the texture unit.
+	 */
+	void setUniform1i(GLint location,GLint value) {
+		if (uniformValueChanged(location,&value,sizeof(GLint))) {
+			glUniform1i(location,value);
+		}
+	}
+
+	/** \brief Set the first \p count elements of a vec4 array uniform
+	 *
+	 * Arrays are typically rewritten every frame, e.g. the per-needle transforms of a batch.
+	 * They are not compared with a cached value, and always uploaded with a single GL call.
+	 *
+	 * @param location Location of the first element of the array
+	 * @param count Number of vec4 elements
+	 * @param values 4 * \p count floats
+	 */
+	void setUniform4fvArray(GLint location,GLsizei count,GLfloat const *values) {
+		if (location < 0 || count <= 0) {
+			return;
+		}
+
+		// A single element setter on the same location must upload again.
+		if (size_t(location) < uniformCache.size()) {
+			uniformCache[location].isValid = false;
+		}
+
+		glUniform4fv(location,count,values);
+		numUniformUploads++;
+	}
+
+	/** \brief Forget all cached uniform values.
+	 *
+	 * Call this when uniforms of the program were set directly with glUniform* calls.
+	 * The next call of each setter uploads the value unconditionally.
+	 */
+	void invalidateUniformCache() {
+		uniformCache.clear();
+	}
+
+	/// \brief Number of uniform uploads which were passed to GL by the setters
+	uint64_t getNumUniformUploads() const {
+		return numUniformUploads;
+	}
+
+	/// \brief Number of uniform uploads which were skipped because the value did not change
+	uint64_t getNumUniformUploadsSkipped() const {
+		return numUniformUploadsSkipped;
 	}
 
 private:
 
+	/** \brief Maximum size of a cached uniform value in bytes. This is a mat4.
+	 *
+	 */
+	static constexpr size_t maxUniformValueSize = 16 * sizeof(GLfloat);
+
+	/// \brief Last value which was uploaded to a uniform location
+	struct UniformCacheEntry {
+		bool isValid = false;
+		GLubyte value[maxUniformValueSize];
+	};
+
+	/** \brief Shadow copy of the uniform values, indexed by the uniform location
+	 *
+	 * Uniform locations are small numbers in the common GLES implementations.
+	 * The vector grows on demand, and is cleared when the program is linked.
+	 */
+	std::vector<UniformCacheEntry> uniformCache;
+
+	uint64_t numUniformUploads = 0;
+	uint64_t numUniformUploadsSkipped = 0;
+
+	/** \brief Compare the new value of a uniform with the cached value, and update the cache.
+	 *
+	 * @param location Location of the uniform
+	 * @param value Pointer to the new value
+	 * @param size Size of the value in bytes. Must not exceed \ref maxUniformValueSize
+	 * @return true when the value must be uploaded to GL
+	 */
+	bool uniformValueChanged(GLint location,void const *value,size_t size) {
+
+		if (location < 0) {
+			return false;
+		}
+
+		if (size_t(location) >= uniformCache.size()) {
+			uniformCache.resize(location + 1);
+		}
+
+		UniformCacheEntry &entry = uniformCache[location];
+
+		if (entry.isValid && memcmp(entry.value,value,size) == 0) {
+			numUniformUploadsSkipped++;
+			return false;
+		}
+
+		memcpy(entry.value,value,size);
+		entry.isValid = true;
+		numUniformUploads++;
+
+		return true;
+	}
+
 	GLuint programHandle = 0;
 
 	GLVertexShader		*vertexShader = 0;
@@ -223,6 +427,9 @@ private:
 
 	bool isLinked = false;
 
+	/// \brief Linking was issued by \ref startLinkProgram(), but the result was not checked yet.
+	bool linkPending = false;
+
 	GLint numAttributes = 0;
 	GLint numUniforms = 0;
 
@@ -0,0 +1,123 @@
+/*
+ * GLRenderTarget.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Offscreen render target. A framebuffer object with a color texture and an optional depth buffer.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <sstream>
+
+#include "OVFCommon.h"
+
+#include "GLES/GLRenderTarget.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+GLRenderTarget::GLRenderTarget() {
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.GLRenderTarget");
+	}
+#endif
+}
+
+GLRenderTarget::~GLRenderTarget() {
+	releaseFramebuffer();
+}
+
+void GLRenderTarget::releaseFramebuffer() {
+
+	if (framebufferHandle != 0) {
+		glDeleteFramebuffers(1,&framebufferHandle);
+		framebufferHandle = 0;
+	}
+
+	if (depthBufferHandle != 0) {
+		glDeleteRenderbuffers(1,&depthBufferHandle);
+		depthBufferHandle = 0;
+	}
+
+}
+
+void GLRenderTarget::create(GLsizei width, GLsizei height, bool withDepthBuffer) {
+	GLenum fbStatus;
+
+	if (framebufferHandle != 0 && width == this->width && height == this->height &&
+			withDepthBuffer == (depthBufferHandle != 0)) {
+		return;
+	}
+
+	releaseFramebuffer();
+
+	this->width = width;
+	this->height = height;
+
+	// Non-power-of-2 textures in GLES 2.0 require clamping, and no mipmaps.
+	colorTexture.setTextureStorage(width,height,TextureData::RGBA,TextureData::Byte);
+	colorTexture.setMinificationFilter(GLTexture::Nearest);
+	colorTexture.setMagnificationFilter(GLTexture::Nearest);
+	colorTexture.setWrapMode(GLTexture::ClampToEdge,GLTexture::ClampToEdge);
+
+	glGenFramebuffers(1,&framebufferHandle);
+	glBindFramebuffer(GL_FRAMEBUFFER,framebufferHandle);
+	glFramebufferTexture2D(GL_FRAMEBUFFER,GL_COLOR_ATTACHMENT0,GL_TEXTURE_2D,colorTexture.getTextureHandle(),0);
+
+	if (withDepthBuffer) {
+		glGenRenderbuffers(1,&depthBufferHandle);
+		glBindRenderbuffer(GL_RENDERBUFFER,depthBufferHandle);
+		glRenderbufferStorage(GL_RENDERBUFFER,GL_DEPTH_COMPONENT16,width,height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER,GL_DEPTH_ATTACHMENT,GL_RENDERBUFFER,depthBufferHandle);
+	}
+
+	fbStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	LOG4CXX_DEBUG(logger,"Render target framebuffer = " << framebufferHandle << ", " << width << 'x' << height
+			<< ", status = " << fbStatus);
+
+	if (fbStatus != GL_FRAMEBUFFER_COMPLETE) {
+		std::ostringstream errStr;
+		errStr << "Render target framebuffer is incomplete. Status = " << fbStatus;
+
+		releaseFramebuffer();
+
+		throw FramebufferException(errStr.str().c_str());
+	}
+
+}
+
+void GLRenderTarget::bind() {
+
+	glBindFramebuffer(GL_FRAMEBUFFER,framebufferHandle);
+	glViewport(0,0,width,height);
+
+}
+
+} /* namespace OevGLES */
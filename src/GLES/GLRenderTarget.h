@@ -0,0 +1,107 @@
+/*
+ * GLRenderTarget.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Offscreen render target. A framebuffer object with a color texture and an optional depth buffer.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef GLES_GLRENDERTARGET_H_
+#define GLES_GLRENDERTARGET_H_
+
+#include <GLES2/gl2.h>
+
+#include "GLES/GLTexture.h"
+
+namespace OevGLES {
+
+/** \brief Offscreen render target
+ *
+ * A framebuffer object with a texture as color buffer, and optionally a depth renderbuffer.
+ * Objects are rendered into the texture once, and the texture is used like any other texture afterwards.
+ *
+ * The color texture has no mipmaps, and clamps at the edges because the size is usually not a power of 2.
+ */
+class GLRenderTarget {
+public:
+
+	GLRenderTarget();
+	virtual ~GLRenderTarget();
+
+	/** \brief Create the framebuffer, the color texture, and the depth buffer.
+	 *
+	 * When the target exists already with the same size it is kept. Otherwise the framebuffer is re-created,
+	 * and the storage of the color texture is re-allocated.
+	 *
+	 * @param width Width in pixels
+	 * @param height Height in pixels
+	 * @param withDepthBuffer Attach a 16 bit depth buffer
+	 * @throws FramebufferException when the framebuffer is incomplete
+	 */
+	void create(GLsizei width, GLsizei height, bool withDepthBuffer);
+
+	/** \brief Render into this target from now on.
+	 *
+	 * Binds the framebuffer, and sets the viewport to the size of the target.
+	 * Call \ref EGLRenderSurface::bindFramebuffer() to render to the screen again.
+	 */
+	void bind();
+
+	bool isCreated() const {
+		return framebufferHandle != 0;
+	}
+
+	GLsizei getWidth() const {
+		return width;
+	}
+
+	GLsizei getHeight() const {
+		return height;
+	}
+
+	/// \brief The color buffer as texture
+	GLTexture &getColorTexture() {
+		return colorTexture;
+	}
+
+	GLTexture const &getColorTexture() const {
+		return colorTexture;
+	}
+
+private:
+	GLuint framebufferHandle = 0;
+	GLuint depthBufferHandle = 0;
+	GLTexture colorTexture;
+
+	GLsizei width = 0;
+	GLsizei height = 0;
+
+	/// \brief Delete the framebuffer and the depth buffer
+	void releaseFramebuffer();
+
+	GLRenderTarget(GLRenderTarget const&) = delete;
+	GLRenderTarget &operator = (GLRenderTarget const&) = delete;
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLES_GLRENDERTARGET_H_ */
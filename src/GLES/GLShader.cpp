@@ -88,10 +88,15 @@ GLShader::~GLShader() {
 
 void GLShader::compileShader() {
 
-	if (!isCompiled) {
+	startCompileShader();
+	checkCompileStatus();
+
+}
+
+void GLShader::startCompileShader() {
+
+	if (!isCompiled && !isCompileStarted) {
 		char const *shaderCStr = shaderText.c_str();
-		GLint compileResult = GL_FALSE;
-		std::string exceptString;
 
 		if (shaderHandle == 0) {
 			shaderHandle = glCreateShader(getShaderType());
@@ -110,6 +115,18 @@ void GLShader::compileShader() {
 		// and compile the source
 		glCompileShader(shaderHandle);
 
+		isCompileStarted = true;
+	}
+}
+
+void GLShader::checkCompileStatus() {
+
+	if (!isCompiled) {
+		GLint compileResult = GL_FALSE;
+		std::string exceptString;
+
+		startCompileShader();
+
 		glGetShaderiv(shaderHandle,GL_COMPILE_STATUS,&compileResult);
 		if (compileResult == GL_FALSE) {
 			GLint infoLen = 0;
@@ -152,6 +169,7 @@ void GLShader::compileShader() {
 			throw ShaderException(exceptString.c_str());
 		}
 
+		isCompiled = true;
 	}
 }
 
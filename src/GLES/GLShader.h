@@ -66,9 +66,27 @@ public:
 
 	/** \brief Creates the shader and compiles it from \ref shaderText.
 	 *
+	 * Same as \ref startCompileShader() followed by \ref checkCompileStatus().
+	 *
+	 * @throws ShaderException
 	 */
 	void compileShader();
 
+	/** \brief Creates the shader, and issues the compilation without waiting for the result.
+	 *
+	 * With GL_KHR_parallel_shader_compile the driver compiles in the background.
+	 * Without it the driver may still defer the work until the result is queried.
+	 *
+	 * @throws ShaderException when the shader cannot be created
+	 */
+	void startCompileShader();
+
+	/** \brief Wait for the compilation, and check the result.
+	 *
+	 * @throws ShaderException when the compilation failed. The exception contains the info log and the source.
+	 */
+	void checkCompileStatus();
+
 	/** \brief Obtain the handle of the shader object
 	 *
 	 * Before the shader is created and compiled with \ref compileShader the method returns 0.
@@ -99,6 +117,9 @@ private:
 
 	bool isCompiled = false;
 
+	/// \brief \ref startCompileShader() issued the compilation, but the result was not checked yet.
+	bool isCompileStarted = false;
+
 };
 
 class GLVertexShader :public GLShader {
@@ -0,0 +1,121 @@
+/*
+ * GLStateCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Shadow copy of the GL context state. Filters out state changes which would not change anything.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include "OVFCommon.h"
+
+#include "GLES/GLStateCache.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+GLStateCache::GLStateCache() {
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.GLStateCache");
+	}
+#endif
+
+	invalidate();
+}
+
+GLStateCache &GLStateCache::getStateCache() {
+	static GLStateCache theStateCache;
+
+	return theStateCache;
+}
+
+void GLStateCache::invalidate() {
+
+	LOG4CXX_DEBUG(logger,"Invalidate GL state cache");
+
+	currProgram = unknownHandle;
+	currArrayBuffer = unknownHandle;
+	currElementArrayBuffer = unknownHandle;
+
+	for (auto &cap : currCapabilities) {
+		cap = -1;
+	}
+	currDepthMask = -1;
+
+	currBlendSFactor = unknownEnum;
+	currBlendDFactor = unknownEnum;
+
+	currActiveTexture = unknownEnum;
+	for (auto &tex : currTexture2D) {
+		tex = unknownHandle;
+	}
+
+	for (unsigned i = 0; i < maxVertexAttribs; i++) {
+		currVertexAttribArray[i] = -1;
+		currVertexAttribValue[i].isValid = false;
+	}
+}
+
+void GLStateCache::deleteBuffer(GLuint buffer) {
+
+	// GL binds buffer 0 when the bound buffer is deleted
+	if (buffer == currArrayBuffer) {
+		currArrayBuffer = 0;
+	}
+	if (buffer == currElementArrayBuffer) {
+		currElementArrayBuffer = 0;
+	}
+
+	glDeleteBuffers(1,&buffer);
+}
+
+void GLStateCache::deleteTexture(GLuint texture) {
+
+	// GL binds texture 0 to all units where the deleted texture was bound
+	for (auto &tex : currTexture2D) {
+		if (tex == texture) {
+			tex = 0;
+		}
+	}
+
+	glDeleteTextures(1,&texture);
+}
+
+void GLStateCache::deleteProgram(GLuint program) {
+
+	// A program which is in use is only flagged for deletion, and stays current.
+	// Forget it anyway so that the handle can be re-used by GL without confusing the cache.
+	if (program == currProgram) {
+		currProgram = unknownHandle;
+	}
+
+	glDeleteProgram(program);
+}
+
+} /* namespace OevGLES */
@@ -0,0 +1,384 @@
+/*
+ * GLStateCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Shadow copy of the GL context state. Filters out state changes which would not change anything.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef GLES_GLSTATECACHE_H_
+#define GLES_GLSTATECACHE_H_
+
+#include <cstdint>
+#include <string.h>
+
+#include <GLES2/gl2.h>
+
+namespace OevGLES {
+
+/** \brief Cache of the GL context state
+ *
+ * All renderers change the GL state through this object instead of calling GL directly.
+ * The cache remembers the current state, and passes only calls to GL which actually change the state.
+ *
+ * Cached are the current program, the bound array and element array buffers, the enabled capabilities,
+ * the depth mask, the blend function, the active texture unit, the 2D textures bound to each texture unit,
+ * the enabled vertex attribute arrays and the constant values of vertex attributes.
+ *
+ * Initially all state is unknown, and the first call of each setter is always passed to GL.
+ * When GL state is changed outside the cache call \ref invalidate().
+ *
+ * There is only one GL context in the program, therefore there is only one cache which
+ * is obtained with \ref getStateCache().
+ */
+class GLStateCache {
+public:
+
+	/// \brief Number of texture units which are tracked. GLES 2.0 guarantees 8 units for the fragment shader.
+	static constexpr unsigned maxTextureUnits = 8;
+
+	/** \brief Number of vertex attributes which are tracked.
+	 *
+	 * GLES 2.0 guarantees at least 8 vertex attributes. Common implementations have 16.
+	 * Attribute locations beyond the tracked ones are passed to GL directly.
+	 */
+	static constexpr unsigned maxVertexAttribs = 16;
+
+	/** \brief Return the only instance of the state cache
+	 *
+	 * @return Reference to the state cache
+	 */
+	static GLStateCache &getStateCache();
+
+	/** \brief Forget the cached state.
+	 *
+	 * Call this when the GL state was changed by direct GL calls, or when the context was re-created.
+	 */
+	void invalidate();
+
+	/// \brief glUseProgram
+	void useProgram(GLuint program) {
+		if (program != currProgram) {
+			currProgram = program;
+			callIssued();
+			glUseProgram(program);
+		} else {
+			callAvoided();
+		}
+	}
+
+	/** \brief glBindBuffer
+	 *
+	 * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
+	 * @param buffer Buffer handle
+	 */
+	void bindBuffer(GLenum target,GLuint buffer) {
+		GLuint &curr = (target == GL_ELEMENT_ARRAY_BUFFER) ? currElementArrayBuffer : currArrayBuffer;
+
+		if (buffer != curr) {
+			curr = buffer;
+			callIssued();
+			glBindBuffer(target,buffer);
+		} else {
+			callAvoided();
+		}
+	}
+
+	/** \brief glEnable
+	 *
+	 * Capabilities which are not cached are passed to GL unconditionally.
+	 *
+	 * @param cap Capability like GL_DEPTH_TEST, GL_BLEND...
+	 */
+	void enable(GLenum cap) {
+		setCapability(cap,true);
+	}
+
+	/** \brief glDisable
+	 *
+	 * Capabilities which are not cached are passed to GL unconditionally.
+	 *
+	 * @param cap Capability like GL_DEPTH_TEST, GL_BLEND...
+	 */
+	void disable(GLenum cap) {
+		setCapability(cap,false);
+	}
+
+	/// \brief glDepthMask
+	void depthMask(GLboolean flag) {
+		int8_t const newState = flag ? 1 : 0;
+
+		if (newState != currDepthMask) {
+			currDepthMask = newState;
+			callIssued();
+			glDepthMask(flag);
+		} else {
+			callAvoided();
+		}
+	}
+
+	/// \brief glBlendFunc
+	void blendFunc(GLenum sFactor,GLenum dFactor) {
+		if (sFactor != currBlendSFactor || dFactor != currBlendDFactor) {
+			currBlendSFactor = sFactor;
+			currBlendDFactor = dFactor;
+			callIssued();
+			glBlendFunc(sFactor,dFactor);
+		} else {
+			callAvoided();
+		}
+	}
+
+	/** \brief glActiveTexture
+	 *
+	 * @param textureUnit GL_TEXTURE0, GL_TEXTURE1...
+	 */
+	void activeTexture(GLenum textureUnit) {
+		if (textureUnit != currActiveTexture) {
+			currActiveTexture = textureUnit;
+			callIssued();
+			glActiveTexture(textureUnit);
+		} else {
+			callAvoided();
+		}
+	}
+
+	/** \brief glBindTexture(GL_TEXTURE_2D,texture) on the active texture unit
+	 *
+	 * @param texture Texture handle
+	 */
+	void bindTexture2D(GLuint texture) {
+		unsigned const unit = currActiveTexture - GL_TEXTURE0;
+
+		if (unit < maxTextureUnits) {
+			if (texture == currTexture2D[unit]) {
+				callAvoided();
+				return;
+			}
+			currTexture2D[unit] = texture;
+		}
+
+		callIssued();
+		glBindTexture(GL_TEXTURE_2D,texture);
+	}
+
+	/** \brief Activate the texture unit, and bind a 2D texture to it
+	 *
+	 * @param textureUnit GL_TEXTURE0, GL_TEXTURE1...
+	 * @param texture Texture handle
+	 */
+	void bindTexture2D(GLenum textureUnit,GLuint texture) {
+		activeTexture(textureUnit);
+		bindTexture2D(texture);
+	}
+
+	/// \brief glEnableVertexAttribArray
+	void enableVertexAttribArray(GLuint index) {
+		setVertexAttribArray(index,true);
+	}
+
+	/// \brief glDisableVertexAttribArray
+	void disableVertexAttribArray(GLuint index) {
+		setVertexAttribArray(index,false);
+	}
+
+	/** \brief glVertexAttrib4fv
+	 *
+	 * Sets the constant value of a vertex attribute which is used when the attribute array is disabled.
+	 *
+	 * @param index Vertex attribute location
+	 * @param value 4 floats
+	 */
+	void vertexAttrib4fv(GLuint index,GLfloat const *value) {
+		if (index < maxVertexAttribs) {
+			VertexAttribValue &attrib = currVertexAttribValue[index];
+
+			if (attrib.isValid && memcmp(attrib.value,value,sizeof(attrib.value)) == 0) {
+				callAvoided();
+				return;
+			}
+			memcpy(attrib.value,value,sizeof(attrib.value));
+			attrib.isValid = true;
+		}
+
+		callIssued();
+		glVertexAttrib4fv(index,value);
+	}
+
+	/** \brief Delete a buffer, and reset the cached binding when the buffer is bound.
+	 *
+	 * @param buffer Buffer handle
+	 */
+	void deleteBuffer(GLuint buffer);
+
+	/** \brief Delete a texture, and reset the cached bindings of all units where it is bound.
+	 *
+	 * @param texture Texture handle
+	 */
+	void deleteTexture(GLuint texture);
+
+	/** \brief Delete a program, and reset the current program when it is the deleted one.
+	 *
+	 * @param program Program handle
+	 */
+	void deleteProgram(GLuint program);
+
+	/// \brief Number of state changing calls which were passed to GL
+	uint64_t getNumCallsIssued() const {
+		return numCallsIssued;
+	}
+
+	/// \brief Number of calls which were filtered out because they would not change the state
+	uint64_t getNumCallsAvoided() const {
+		return numCallsAvoided;
+	}
+
+	/// \brief Reset the call counters
+	void resetCounters() {
+		numCallsIssued = 0;
+		numCallsAvoided = 0;
+	}
+
+private:
+
+	/// \brief Handle value which means "binding unknown". It is never returned by GL.
+	static constexpr GLuint unknownHandle = ~GLuint(0);
+
+	/// \brief Enum value which means "state unknown". It is no valid GL enum.
+	static constexpr GLenum unknownEnum = ~GLenum(0);
+
+	/// \brief The cached capabilities. Index into \ref currCapabilities
+	enum Capability {
+		CapBlend,
+		CapCullFace,
+		CapDepthTest,
+		CapDither,
+		CapPolygonOffsetFill,
+		CapSampleAlphaToCoverage,
+		CapSampleCoverage,
+		CapScissorTest,
+		CapStencilTest,
+		NumCapabilities,
+		CapNotCached = NumCapabilities
+	};
+
+	/// \brief Constant value of a vertex attribute
+	struct VertexAttribValue {
+		bool isValid = false;
+		GLfloat value[4];
+	};
+
+	GLuint currProgram = unknownHandle;
+	GLuint currArrayBuffer = unknownHandle;
+	GLuint currElementArrayBuffer = unknownHandle;
+
+	/// \brief -1: unknown, 0: disabled, 1: enabled
+	int8_t currCapabilities[NumCapabilities];
+	/// \brief -1: unknown, 0: GL_FALSE, 1: GL_TRUE
+	int8_t currDepthMask = -1;
+
+	GLenum currBlendSFactor = unknownEnum;
+	GLenum currBlendDFactor = unknownEnum;
+
+	GLenum currActiveTexture = unknownEnum;
+	GLuint currTexture2D[maxTextureUnits];
+
+	/// \brief -1: unknown, 0: disabled, 1: enabled
+	int8_t currVertexAttribArray[maxVertexAttribs];
+	VertexAttribValue currVertexAttribValue[maxVertexAttribs];
+
+	uint64_t numCallsIssued = 0;
+	uint64_t numCallsAvoided = 0;
+
+	/// \brief Private constructor. Use \ref getStateCache().
+	GLStateCache();
+
+	GLStateCache(GLStateCache const&) = delete;
+	GLStateCache &operator = (GLStateCache const&) = delete;
+
+	void callIssued() {
+		numCallsIssued++;
+	}
+
+	void callAvoided() {
+		numCallsAvoided++;
+	}
+
+	static Capability capabilityIndex(GLenum cap) {
+		switch (cap) {
+		case GL_BLEND:						return CapBlend;
+		case GL_CULL_FACE:					return CapCullFace;
+		case GL_DEPTH_TEST:					return CapDepthTest;
+		case GL_DITHER:						return CapDither;
+		case GL_POLYGON_OFFSET_FILL:		return CapPolygonOffsetFill;
+		case GL_SAMPLE_ALPHA_TO_COVERAGE:	return CapSampleAlphaToCoverage;
+		case GL_SAMPLE_COVERAGE:			return CapSampleCoverage;
+		case GL_SCISSOR_TEST:				return CapScissorTest;
+		case GL_STENCIL_TEST:				return CapStencilTest;
+		default:							return CapNotCached;
+		}
+	}
+
+	void setCapability(GLenum cap,bool enabled) {
+		Capability const idx = capabilityIndex(cap);
+		int8_t const newState = enabled ? 1 : 0;
+
+		if (idx != CapNotCached) {
+			if (currCapabilities[idx] == newState) {
+				callAvoided();
+				return;
+			}
+			currCapabilities[idx] = newState;
+		}
+
+		callIssued();
+		if (enabled) {
+			glEnable(cap);
+		} else {
+			glDisable(cap);
+		}
+	}
+
+	void setVertexAttribArray(GLuint index,bool enabled) {
+		int8_t const newState = enabled ? 1 : 0;
+
+		if (index < maxVertexAttribs) {
+			if (currVertexAttribArray[index] == newState) {
+				callAvoided();
+				return;
+			}
+			currVertexAttribArray[index] = newState;
+		}
+
+		callIssued();
+		if (enabled) {
+			glEnableVertexAttribArray(index);
+		} else {
+			glDisableVertexAttribArray(index);
+		}
+	}
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLES_GLSTATECACHE_H_ */
@@ -29,8 +29,12 @@
 #endif
 
 
+#include <vector>
+#include <algorithm>
+
 #include "GLES/GLTexture.h"
 #include "GLES/ExceptionBase.h"
+#include "GLES/GLStateCache.h"
 
 namespace OevGLES {
 
@@ -41,7 +45,7 @@ GLTexture::GLTexture() {
 
 GLTexture::~GLTexture() {
 	if (textureHandle != 0) {
-		glDeleteTextures(1,&textureHandle);
+		GLStateCache::getStateCache().deleteTexture(textureHandle);
 	}
 }
 
@@ -59,20 +63,119 @@ void GLTexture::createTextureHandle() {
 }
 
 void GLTexture::setTextureData(const TextureData& textureData, GLint mipMapLevel)
+{
+	setTextureData(
+			textureData.getWidth(),
+			textureData.getHeight(),
+			textureData.getGlFormat(),
+			textureData.getDataType(),
+			textureData.getDataPtr(),
+			mipMapLevel
+			);
+}
+
+void GLTexture::setTextureData(GLsizei width, GLsizei height,TextureData::GlFormat glFormat,TextureData::DataType dataType,
+		void const *data,GLint mipMapLevel)
 {
 	createTextureHandle();
 
-	glBindTexture(GL_TEXTURE_2D,textureHandle);
+	GLStateCache::getStateCache().bindTexture2D(textureHandle);
 
 	glPixelStorei(GL_PACK_ALIGNMENT,1);
 	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
 	glTexImage2D(
 			GL_TEXTURE_2D,
 			mipMapLevel,
-			textureData.getGlFormat(),
+			glFormat,
+			width,
+			height,
+			0,
+			glFormat,
+			dataType,
+			data
+			);
+
+}
+
+void GLTexture::setCompressedTextureData(CompressedTextureData const &textureData)
+{
+	if (textureData.getNumLevels() == 0) {
+		throw TextureException("GLTexture::setCompressedTextureData: The compressed texture has no level");
+	}
+
+	for (size_t i = 0; i < textureData.getNumLevels(); i++) {
+		CompressedTextureData::Level const &level = textureData.getLevel(i);
+
+		setCompressedTextureData(
+				level.width,
+				level.height,
+				textureData.getGlInternalFormat(),
+				GLsizei(level.data.size()),
+				level.data.data(),
+				GLint(i)
+				);
+	}
+
+}
+
+void GLTexture::setCompressedTextureData(GLsizei width, GLsizei height,GLenum glInternalFormat,GLsizei dataSize,
+		void const *data,GLint mipMapLevel)
+{
+	createTextureHandle();
+
+	GLStateCache::getStateCache().bindTexture2D(textureHandle);
+
+	glCompressedTexImage2D(
+			GL_TEXTURE_2D,
+			mipMapLevel,
+			glInternalFormat,
+			width,
+			height,
+			0,
+			dataSize,
+			data
+			);
+
+}
+
+bool GLTexture::isCompressedFormatSupported(GLenum glInternalFormat)
+{
+	GLint numFormats = 0;
+
+	glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS,&numFormats);
+
+	std::vector<GLint> formats (numFormats);
+	if (numFormats > 0) {
+		glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS,formats.data());
+	}
+
+	return std::find(formats.begin(),formats.end(),GLint(glInternalFormat)) != formats.end();
+}
+
+void GLTexture::setTextureStorage(GLsizei width, GLsizei height,TextureData::GlFormat glFormat,TextureData::DataType dataType)
+{
+	createTextureHandle();
+
+	GLStateCache::getStateCache().bindTexture2D(textureHandle);
+
+	glTexImage2D(GL_TEXTURE_2D,0,glFormat,width,height,0,glFormat,dataType,0);
+
+}
+
+void GLTexture::setTextureSubData(TextureData const &textureData,GLint xOffset,GLint yOffset,GLint mipMapLevel)
+{
+	createTextureHandle();
+
+	GLStateCache::getStateCache().bindTexture2D(textureHandle);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT,1);
+	glTexSubImage2D(
+			GL_TEXTURE_2D,
+			mipMapLevel,
+			xOffset,
+			yOffset,
 			textureData.getWidth(),
 			textureData.getHeight(),
-			0,
 			textureData.getGlFormat(),
 			textureData.getDataType(),
 			textureData.getDataPtr()
@@ -83,25 +186,48 @@ void GLTexture::setTextureData(const TextureData& textureData, GLint mipMapLevel
 void GLTexture::generateMipmap()
 {
 	createTextureHandle();
-	glBindTexture(GL_TEXTURE_2D,textureHandle);
+	GLStateCache::getStateCache().bindTexture2D(textureHandle);
 
 	glGenerateMipmap(GL_TEXTURE_2D);
 }
 
 void GLTexture::setMinificationFilter(TextureFilter filterType)
 {
-	minFilterType = filterType;
+	if (minFilterType != filterType) {
+		minFilterType = filterType;
+		texParametersChanged = true;
+	}
 }
 
 void GLTexture::setMagnificationFilter(TextureFilter filterType)
 {
-	magFilterType = filterType;
+	if (magFilterType != filterType) {
+		magFilterType = filterType;
+		texParametersChanged = true;
+	}
 }
 
 void GLTexture::setWrapMode(TextureWrapMode wrapModeS, TextureWrapMode wrapModeT)
 {
-	wrapS =  wrapModeS;
-	wrapT =  wrapModeT;
+	if (wrapS != wrapModeS || wrapT != wrapModeT) {
+		wrapS =  wrapModeS;
+		wrapT =  wrapModeT;
+		texParametersChanged = true;
+	}
+}
+
+void GLTexture::applyTexParameters() {
+
+	// Filter and wrap modes are stored in the texture object. Set them only when they changed.
+	if (texParametersChanged) {
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,magFilterType);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,minFilterType);
+
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,wrapS);
+		glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,wrapT);
+
+		texParametersChanged = false;
+	}
 }
 
 void GLTexture::bindToUniformLocation(
@@ -111,15 +237,25 @@ void GLTexture::bindToUniformLocation(
 
 	createTextureHandle();
 
-	glActiveTexture(textureUnit);
-	glBindTexture(GL_TEXTURE_2D,textureHandle);
+	GLStateCache::getStateCache().bindTexture2D(textureUnit,textureHandle);
 	glUniform1i(uniformLocation,textureUnitNo);
 
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,magFilterType);
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,minFilterType);
+	applyTexParameters();
+
+}
+
+void GLTexture::bindToUniformLocation(
+		GLenum textureUnit,
+		GLint textureUnitNo,
+		GLProgram &program,
+		GLint uniformLocation) {
+
+	createTextureHandle();
+
+	GLStateCache::getStateCache().bindTexture2D(textureUnit,textureHandle);
+	program.setUniform1i(uniformLocation,textureUnitNo);
 
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,wrapS);
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,wrapT);
+	applyTexParameters();
 
 }
 
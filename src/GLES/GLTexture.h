@@ -27,6 +27,8 @@
 #define GLES_GLTEXTURE_H_
 
 #include "GLES/TexHelper/TextureData.h"
+#include "GLES/TexHelper/CompressedTextureData.h"
+#include "GLES/GLProgram.h"
 
 namespace OevGLES {
 
@@ -61,6 +63,69 @@ public:
 	 */
 	void setTextureData (TextureData const &textureData,GLint mipMapLevel = 0);
 
+	/** \brief Like \ref setTextureData(TextureData const&,GLint), but uploads texels from any memory, e.g. a mapped \ref AssetPack
+	 *
+	 * @param width Width in texels
+	 * @param height Height in texels
+	 * @param glFormat Format of the texture
+	 * @param dataType Data type of the texels
+	 * @param data Tightly packed rows of texels, first row at the bottom
+	 * @param mipMapLevel Mip level used by glTexImage2D()
+	 */
+	void setTextureData (GLsizei width, GLsizei height,TextureData::GlFormat glFormat,TextureData::DataType dataType,
+			void const *data,GLint mipMapLevel = 0);
+
+	/** \brief Upload a block compressed texture, e.g. ETC1, with all its mip levels
+	 *
+	 * Check with \ref isCompressedFormatSupported() before that the GPU supports the format.
+	 *
+	 * @param textureData The compressed texture. The object is only used during this call.
+	 * @throws TextureException when the texture has no level
+	 */
+	void setCompressedTextureData (CompressedTextureData const &textureData);
+
+	/** \brief Upload one level of a block compressed texture from any memory, e.g. a mapped \ref AssetPack
+	 *
+	 * @param width Width of the level in texels
+	 * @param height Height of the level in texels
+	 * @param glInternalFormat The compressed format, e.g. GL_ETC1_RGB8_OES
+	 * @param dataSize Size of the compressed data in bytes
+	 * @param data The compressed blocks
+	 * @param mipMapLevel Mip level used by glCompressedTexImage2D()
+	 */
+	void setCompressedTextureData (GLsizei width, GLsizei height,GLenum glInternalFormat,GLsizei dataSize,
+			void const *data,GLint mipMapLevel = 0);
+
+	/** \brief Check if the GPU can sample a compressed format
+	 *
+	 * @param glInternalFormat The compressed format, e.g. GL_ETC1_RGB8_OES
+	 * @return true when the format is in GL_COMPRESSED_TEXTURE_FORMATS
+	 */
+	static bool isCompressedFormatSupported (GLenum glInternalFormat);
+
+	/** \brief Allocate the storage of the texture without initializing it
+	 *
+	 * Used for textures which are rendered into, see \ref GLRenderTarget.
+	 *
+	 * @param width Width in texels
+	 * @param height Height in texels
+	 * @param glFormat Format of the texture
+	 * @param dataType Data type of the texels
+	 */
+	void setTextureStorage (GLsizei width, GLsizei height,TextureData::GlFormat glFormat,TextureData::DataType dataType);
+
+	/** \brief Replace a part of the texture
+	 *
+	 * The texture must have been defined with \ref setTextureData or \ref setTextureStorage before.
+	 * Format and data type must match the texture. Used to fill the pages of a \ref TextureAtlas.
+	 *
+	 * @param textureData Texels of the rectangle
+	 * @param xOffset Left edge of the rectangle in texels
+	 * @param yOffset Lower edge of the rectangle in texels
+	 * @param mipMapLevel Mip level which is updated
+	 */
+	void setTextureSubData (TextureData const &textureData,GLint xOffset,GLint yOffset,GLint mipMapLevel = 0);
+
 	/** \brief Let GL generate the mipmap chain for the texture.
 	 *
 	 */
@@ -121,7 +186,7 @@ public:
 	 *
 	 * @return GL texture ID
 	 */
-	GLuint getTextureHandle () {
+	GLuint getTextureHandle () const {
 		return textureHandle;
 	}
 
@@ -129,7 +194,7 @@ public:
 	 *
 	 * This method sets the active texture unit to textureUnit, binds the texture to the texture unit,
 	 * assigns it to the uniform location which was bound by the GL program.
-	 * The function also sets the filter and wrapping mode.
+	 * The function also sets the filter and wrapping mode when they were changed since the last call.
 	 *
 	 * @param textureUnit One of the constants GL_TEXTURE0, GL_TEXTURE1...
 	 * @param textureUnitNo The numeric number of the texture unit. Must align with textureUnit. Pass 0 for GL_TEXTURE0, 1 for GL_TEXTURE1...
@@ -137,6 +202,17 @@ public:
 	 */
 	 void bindToUniformLocation (GLenum textureUnit,GLint textureUnitNo, GLint uniformLocation);
 
+	/** \brief Like \ref bindToUniformLocation(GLenum,GLint,GLint), but sets the sampler uniform through the uniform cache of the program.
+	 *
+	 * The sampler uniform is only uploaded when the texture unit differs from the last value.
+	 *
+	 * @param textureUnit One of the constants GL_TEXTURE0, GL_TEXTURE1...
+	 * @param textureUnitNo The numeric number of the texture unit. Must align with textureUnit.
+	 * @param program The GL program which is currently in use
+	 * @param uniformLocation Location of the sampler uniform in the GL program
+	 */
+	 void bindToUniformLocation (GLenum textureUnit,GLint textureUnitNo, GLProgram &program, GLint uniformLocation);
+
 
 
 private:
@@ -147,9 +223,15 @@ private:
 	TextureWrapMode wrapS = ClampToEdge;
 	TextureWrapMode wrapT = ClampToEdge;
 
+	/// \brief Filter or wrap mode changed, and must be set in GL with the next bind.
+	bool texParametersChanged = true;
+
 
 	/// \brief Obtain a texture handle from GLES when \ref textureHandle is not yet set
 	void createTextureHandle();
+
+	/// \brief Set filter and wrap modes of the bound texture when \ref texParametersChanged is set.
+	void applyTexParameters();
 };
 
 } /* namespace OevGLES */
@@ -0,0 +1,392 @@
+/*
+ * Mesh.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Indexed triangle mesh with vertex de-duplication and vertex cache optimization
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+
+#include "OVFCommon.h"
+
+#include "GLES/Mesh.h"
+#include "GLES/GLStateCache.h"
+#include "GLES/ExceptionBase.h"
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+namespace OevGLES {
+
+// Parameters of the vertex score, see Forsyth, "Linear-Speed Vertex Cache Optimisation"
+/// \brief Size of the LRU cache which the optimization assumes. Larger than the real cache, which only shifts the scores.
+static int const forsythCacheSize = 32;
+static float const cacheDecayPower = 1.5f;
+/// \brief Score of the vertexes of the last triangle. Lower than the next ones, it does not matter in which order they are used.
+static float const lastTriangleScore = 0.75f;
+static float const valenceBoostScale = 2.0f;
+static float const valenceBoostPower = 0.5f;
+
+/// \brief Score of a vertex by its position in the cache, and by the number of triangles which still use it
+static float computeVertexScore(int cachePosition,unsigned numRemainingTriangles) {
+	float score = 0.0f;
+
+	if (numRemainingTriangles == 0) {
+		// Not used any more
+		return -1.0f;
+	}
+
+	if (cachePosition >= 0) {
+		if (cachePosition < 3) {
+			score = lastTriangleScore;
+		} else {
+			float const scale = 1.0f / float(forsythCacheSize - 3);
+			score = powf(1.0f - float(cachePosition - 3) * scale,cacheDecayPower);
+		}
+	}
+
+	// Vertexes with few remaining triangles are finished first. Else they remain as single triangles at the end.
+	score += valenceBoostScale * powf(float(numRemainingTriangles),-valenceBoostPower);
+
+	return score;
+}
+
+Mesh::Mesh(unsigned floatsPerVertex)
+	:floatsPerVertex {std::max(floatsPerVertex,1U)}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.Mesh");
+	}
+#endif
+}
+
+Mesh::~Mesh() {
+
+	if (vertexBufferHandle) {
+		GLStateCache::getStateCache().deleteBuffer(vertexBufferHandle);
+	}
+	if (indexBufferHandle) {
+		GLStateCache::getStateCache().deleteBuffer(indexBufferHandle);
+	}
+}
+
+size_t Mesh::hashVertex(GLfloat const *vertex) const {
+	uint8_t const *bytes = reinterpret_cast<uint8_t const *>(vertex);
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	// FNV-1a over the bits of the floats
+	for (size_t i = 0; i < floatsPerVertex * sizeof(GLfloat); i++) {
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+	}
+
+	return size_t(hash);
+}
+
+GLushort Mesh::addVertex(GLfloat const *vertex) {
+	size_t const hash = hashVertex(vertex);
+	auto const range = vertexLookup.equal_range(hash);
+
+	numAddedVertexes++;
+
+	for (auto it = range.first; it != range.second; ++it) {
+		if (!memcmp(getVertex(it->second),vertex,floatsPerVertex * sizeof(GLfloat))) {
+			return it->second;
+		}
+	}
+
+	size_t const index = getNumVertexes();
+	if (index > 0xffff) {
+		throw MeshException("Mesh::addVertex: More than 65536 vertexes cannot be addressed by 16 bit indexes");
+	}
+
+	vertexes.insert(vertexes.end(),vertex,vertex + floatsPerVertex);
+	vertexLookup.emplace(hash,GLushort(index));
+
+	return GLushort(index);
+}
+
+void Mesh::addTriangle(GLfloat const *vertex0,GLfloat const *vertex1,GLfloat const *vertex2) {
+	// The vertexes are numbered in the order of the triangle
+	GLushort const index0 = addVertex(vertex0);
+	GLushort const index1 = addVertex(vertex1);
+	GLushort const index2 = addVertex(vertex2);
+
+	addTriangle(index0,index1,index2);
+}
+
+void Mesh::addTriangle(GLushort index0,GLushort index1,GLushort index2) {
+	size_t const numVertexes = getNumVertexes();
+
+	if (index0 >= numVertexes || index1 >= numVertexes || index2 >= numVertexes) {
+		throw MeshException("Mesh::addTriangle: Vertex index out of range");
+	}
+
+	indexes.push_back(index0);
+	indexes.push_back(index1);
+	indexes.push_back(index2);
+}
+
+Mesh::Statistics Mesh::optimize(unsigned cacheSize) {
+	Statistics statistics;
+
+	statistics.numAddedVertexes = numAddedVertexes;
+	statistics.numVertexes = getNumVertexes();
+	statistics.numTriangles = getNumTriangles();
+	statistics.acmrBefore = computeACMR(indexes,cacheSize);
+
+	reorderTriangles();
+	reorderVertexes();
+
+	statistics.acmrAfter = computeACMR(indexes,cacheSize);
+
+	LOG4CXX_DEBUG(logger,"Mesh with " << statistics.numTriangles << " triangles: " << statistics.numAddedVertexes
+			<< " vertexes de-duplicated to " << statistics.numVertexes << ", ACMR " << statistics.acmrBefore
+			<< " -> " << statistics.acmrAfter);
+
+	return statistics;
+}
+
+void Mesh::reorderTriangles() {
+	size_t const numVertexes = getNumVertexes();
+	size_t const numTriangles = getNumTriangles();
+
+	// Triangles of each vertex. The first numRemaining[v] entries of each list are the triangles which are not drawn yet.
+	std::vector<unsigned> adjacencyOffset (numVertexes + 1,0);
+	std::vector<unsigned> numRemaining (numVertexes,0);
+	std::vector<unsigned> adjacency (indexes.size());
+
+	for (GLushort index : indexes) {
+		numRemaining[index]++;
+	}
+	for (size_t v = 0; v < numVertexes; v++) {
+		adjacencyOffset[v + 1] = adjacencyOffset[v] + numRemaining[v];
+	}
+	{
+		std::vector<unsigned> fill (adjacencyOffset.begin(),adjacencyOffset.end() - 1);
+		for (size_t i = 0; i < indexes.size(); i++) {
+			adjacency[fill[indexes[i]]++] = unsigned(i / 3);
+		}
+	}
+
+	std::vector<int> cachePosition (numVertexes,-1);
+	std::vector<float> vertexScore (numVertexes);
+	std::vector<float> triangleScore (numTriangles,0.0f);
+	std::vector<bool> triangleAdded (numTriangles,false);
+
+	for (size_t v = 0; v < numVertexes; v++) {
+		vertexScore[v] = computeVertexScore(-1,numRemaining[v]);
+	}
+	for (size_t t = 0; t < numTriangles; t++) {
+		for (unsigned k = 0; k < 3; k++) {
+			triangleScore[t] += vertexScore[indexes[t * 3 + k]];
+		}
+	}
+
+	std::vector<GLushort> newIndexes;
+	std::vector<GLushort> cache;
+	std::vector<GLushort> newCache;
+	newIndexes.reserve(indexes.size());
+	cache.reserve(forsythCacheSize + 3);
+	newCache.reserve(forsythCacheSize + 3);
+
+	int bestTriangle = -1;
+	float bestScore = -1.0f;
+	size_t scanStart = 0;
+
+	for (size_t n = 0; n < numTriangles; n++) {
+
+		if (bestTriangle < 0) {
+			// No candidate in the cache. Continue with the best of all remaining triangles.
+			bestScore = -1.0f;
+			while (scanStart < numTriangles && triangleAdded[scanStart]) {
+				scanStart++;
+			}
+			for (size_t t = scanStart; t < numTriangles; t++) {
+				if (!triangleAdded[t] && triangleScore[t] > bestScore) {
+					bestScore = triangleScore[t];
+					bestTriangle = int(t);
+				}
+			}
+		}
+
+		GLushort const *triangle = indexes.data() + bestTriangle * 3;
+		triangleAdded[bestTriangle] = true;
+		newIndexes.insert(newIndexes.end(),triangle,triangle + 3);
+
+		// The triangle is not remaining any more for its vertexes
+		for (unsigned k = 0; k < 3; k++) {
+			GLushort const v = triangle[k];
+			unsigned *list = adjacency.data() + adjacencyOffset[v];
+			unsigned *end = list + numRemaining[v];
+			unsigned *pos = std::find(list,end,unsigned(bestTriangle));
+
+			std::swap(*pos,*(end - 1));
+			numRemaining[v]--;
+		}
+
+		// The vertexes of the triangle move to the front of the LRU cache
+		newCache.assign(triangle,triangle + 3);
+		for (GLushort v : cache) {
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+				newCache.push_back(v);
+			}
+		}
+
+		for (size_t i = 0; i < newCache.size(); i++) {
+			GLushort const v = newCache[i];
+
+			cachePosition[v] = i < size_t(forsythCacheSize) ? int(i) : -1;
+			vertexScore[v] = computeVertexScore(cachePosition[v],numRemaining[v]);
+		}
+
+		// The scores of the triangles of all vertexes which were in the cache changed. The best is the next one.
+		bestTriangle = -1;
+		bestScore = -1.0f;
+		for (GLushort v : newCache) {
+			unsigned const *list = adjacency.data() + adjacencyOffset[v];
+
+			for (unsigned i = 0; i < numRemaining[v]; i++) {
+				unsigned const t = list[i];
+				float const score = vertexScore[indexes[t * 3]] + vertexScore[indexes[t * 3 + 1]] + vertexScore[indexes[t * 3 + 2]];
+
+				triangleScore[t] = score;
+				if (score > bestScore) {
+					bestScore = score;
+					bestTriangle = int(t);
+				}
+			}
+		}
+
+		if (newCache.size() > size_t(forsythCacheSize)) {
+			newCache.resize(forsythCacheSize);
+		}
+		cache.swap(newCache);
+	}
+
+	indexes.swap(newIndexes);
+}
+
+void Mesh::reorderVertexes() {
+	size_t const numVertexes = getNumVertexes();
+	std::vector<int> newIndex (numVertexes,-1);
+	std::vector<GLfloat> newVertexes;
+	GLushort nextIndex = 0;
+
+	newVertexes.reserve(vertexes.size());
+
+	for (auto &index : indexes) {
+		if (newIndex[index] < 0) {
+			newIndex[index] = nextIndex++;
+			newVertexes.insert(newVertexes.end(),getVertex(index),getVertex(index) + floatsPerVertex);
+		}
+		index = GLushort(newIndex[index]);
+	}
+
+	// Vertexes which no triangle uses are dropped
+	vertexes.swap(newVertexes);
+
+	vertexLookup.clear();
+	for (size_t i = 0; i < getNumVertexes(); i++) {
+		vertexLookup.emplace(hashVertex(getVertex(i)),GLushort(i));
+	}
+}
+
+float Mesh::computeACMR(std::vector<GLushort> const &indexes,unsigned cacheSize) {
+	std::deque<GLushort> fifo;
+	size_t misses = 0;
+
+	if (indexes.size() < 3) {
+		return 0.0f;
+	}
+
+	for (GLushort index : indexes) {
+		if (std::find(fifo.begin(),fifo.end(),index) == fifo.end()) {
+			misses++;
+			fifo.push_back(index);
+			if (fifo.size() > cacheSize) {
+				fifo.pop_front();
+			}
+		}
+	}
+
+	return float(misses) / float(indexes.size() / 3);
+}
+
+void Mesh::setupBuffers(VertexFormat const &vertexFormat) {
+	GLStateCache &stateCache = GLStateCache::getStateCache();
+	unsigned numComponents = 0;
+
+	for (size_t e = 0; e < vertexFormat.getNumElements(); e++) {
+		numComponents += unsigned(vertexFormat.getElement(e).numComponents);
+	}
+	if (numComponents != floatsPerVertex) {
+		throw MeshException("Mesh::setupBuffers: The components of the vertex format do not match the floats per vertex");
+	}
+
+	this->vertexFormat = vertexFormat;
+
+	size_t const stride = size_t(vertexFormat.getStride());
+	std::vector<uint8_t> buffer (getNumVertexes() * stride);
+
+	for (size_t i = 0; i < getNumVertexes(); i++) {
+		GLfloat const *values = getVertex(i);
+
+		for (size_t e = 0; e < vertexFormat.getNumElements(); e++) {
+			vertexFormat.writeElement(buffer.data() + i * stride,e,values);
+			values += vertexFormat.getElement(e).numComponents;
+		}
+	}
+
+	if (!vertexBufferHandle) {
+		glGenBuffers(1,&vertexBufferHandle);
+	}
+	stateCache.bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	glBufferData(GL_ARRAY_BUFFER,buffer.size(),buffer.data(),GL_STATIC_DRAW);
+
+	if (!indexBufferHandle) {
+		glGenBuffers(1,&indexBufferHandle);
+	}
+	stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER,indexBufferHandle);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER,indexes.size() * sizeof(GLushort),indexes.data(),GL_STATIC_DRAW);
+}
+
+void Mesh::bindBuffers() const {
+	GLStateCache &stateCache = GLStateCache::getStateCache();
+
+	stateCache.bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER,indexBufferHandle);
+}
+
+} /* namespace OevGLES */
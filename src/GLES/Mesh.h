@@ -0,0 +1,195 @@
+/*
+ * Mesh.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Indexed triangle mesh with vertex de-duplication and vertex cache optimization
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+
+#ifndef GLES_MESH_H_
+#define GLES_MESH_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <GLES2/gl2.h>
+
+#include "GLES/VertexFormat.h"
+
+namespace OevGLES {
+
+/** \brief Indexed triangle mesh
+ *
+ * Renderers build their geometry into the mesh triangle by triangle. Vertexes are given as floats, the components of the
+ * attributes one after the other in the order of the \ref VertexFormat which is used for the upload, e.g. 3 floats
+ * position, and 3 floats normal. Identical vertexes are stored only once, and triangles refer to them by 16 bit indexes.
+ * GLES2 does not guarantee 32 bit indexes.
+ *
+ * \ref optimize() re-orders the triangles for the post-transform vertex cache of the GPU with the algorithm of
+ * Tom Forsyth, "Linear-Speed Vertex Cache Optimisation", and then the vertexes in the order of their first use.
+ * Both the number of transformed vertexes and the vertex fetch shrink.
+ *
+ * The quality of an order is the average cache miss ratio (ACMR), i.e. the number of vertex shader runs per triangle
+ * with a FIFO cache. It is between 0.5 for large regular meshes and 3 for triangles which share no vertexes.
+ *
+ * \ref setupBuffers() converts the vertexes into the vertex format, and creates vertex and index buffer.
+ * The float vertexes are kept, e.g. for bounding boxes.
+ */
+class Mesh {
+public:
+
+	/// \brief Result of \ref optimize()
+	struct Statistics {
+		/// \brief Number of vertexes which were added, i.e. the number which glDrawArrays() would transform
+		size_t numAddedVertexes = 0;
+		/// \brief Number of distinct vertexes
+		size_t numVertexes = 0;
+		size_t numTriangles = 0;
+		/// \brief ACMR of the triangles in the order in which they were added
+		float acmrBefore = 0.0f;
+		/// \brief ACMR after the re-ordering
+		float acmrAfter = 0.0f;
+	};
+
+	/// \brief Size of the simulated post-transform cache for the ACMR. The Mali-400 and most GLES2 GPUs have at least 16 entries.
+	static constexpr unsigned defaultCacheSize = 16;
+
+	/** \brief Constructor
+	 *
+	 * @param floatsPerVertex Number of floats per vertex, i.e. the sum of the components of the attributes of the vertex format
+	 */
+	explicit Mesh(unsigned floatsPerVertex);
+
+	virtual ~Mesh();
+
+	/** \brief Add a vertex, or find a bitwise identical one
+	 *
+	 * @param vertex \ref getFloatsPerVertex() floats
+	 * @return Index of the vertex
+	 * @throws MeshException when the mesh has 65536 distinct vertexes already
+	 */
+	GLushort addVertex(GLfloat const *vertex);
+
+	/// \brief Add a triangle of 3 vertexes, counter-clockwise when seen from the front
+	void addTriangle(GLfloat const *vertex0,GLfloat const *vertex1,GLfloat const *vertex2);
+
+	/// \brief Add a triangle of existing vertexes
+	void addTriangle(GLushort index0,GLushort index1,GLushort index2);
+
+	/** \brief Re-order triangles and vertexes for the vertex cache
+	 *
+	 * Call before \ref setupBuffers(). Vertex indexes which were returned by \ref addVertex() become invalid.
+	 *
+	 * @param cacheSize Size of the FIFO cache for the ACMR in the statistics
+	 * @return Counts, and the ACMR before and after
+	 */
+	Statistics optimize(unsigned cacheSize = defaultCacheSize);
+
+	/** \brief Average cache miss ratio of a triangle list
+	 *
+	 * @param indexes 3 indexes per triangle
+	 * @param cacheSize Number of entries of the FIFO cache
+	 * @return Transformed vertexes per triangle, 0 when there are no triangles
+	 */
+	static float computeACMR(std::vector<GLushort> const &indexes,unsigned cacheSize = defaultCacheSize);
+
+	/** \brief Convert the vertexes into the format, and upload vertexes and indexes into buffers
+	 *
+	 * Can be called again, e.g. when the GL context was re-created. The mesh must not change afterwards.
+	 *
+	 * @param vertexFormat Format of the vertexes in the buffer. The sum of the components of the elements must be \ref getFloatsPerVertex().
+	 * @throws MeshException when the format does not match
+	 */
+	void setupBuffers(VertexFormat const &vertexFormat);
+
+	/// \brief Bind vertex and index buffer. Set up the attributes afterwards with \ref getVertexFormat().
+	void bindBuffers() const;
+
+	/// \brief Draw all triangles. The buffers must be bound.
+	void drawTriangles() const {
+		glDrawElements(GL_TRIANGLES,GLsizei(indexes.size()),GL_UNSIGNED_SHORT,0);
+	}
+
+	VertexFormat const &getVertexFormat() const {
+		return vertexFormat;
+	}
+
+	unsigned getFloatsPerVertex() const {
+		return floatsPerVertex;
+	}
+
+	size_t getNumVertexes() const {
+		return vertexes.size() / floatsPerVertex;
+	}
+
+	size_t getNumTriangles() const {
+		return indexes.size() / 3;
+	}
+
+	/// \brief Number of vertexes passed to \ref addVertex(), including the duplicates
+	size_t getNumAddedVertexes() const {
+		return numAddedVertexes;
+	}
+
+	/// \brief The floats of a vertex
+	GLfloat const *getVertex(size_t index) const {
+		return vertexes.data() + index * floatsPerVertex;
+	}
+
+	std::vector<GLushort> const &getIndexes() const {
+		return indexes;
+	}
+
+private:
+
+	unsigned floatsPerVertex;
+
+	/// \brief floatsPerVertex floats per vertex
+	std::vector<GLfloat> vertexes;
+	/// \brief 3 indexes per triangle
+	std::vector<GLushort> indexes;
+	size_t numAddedVertexes = 0;
+
+	/// \brief Hash of the vertex bits to the vertexes with this hash
+	std::unordered_multimap<size_t,GLushort> vertexLookup;
+
+	VertexFormat vertexFormat;
+	GLuint vertexBufferHandle = 0;
+	GLuint indexBufferHandle = 0;
+
+	size_t hashVertex(GLfloat const *vertex) const;
+
+	/// \brief Forsyth's greedy triangle order
+	void reorderTriangles();
+
+	/// \brief Number the vertexes in the order of their first use by the triangles
+	void reorderVertexes();
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLES_MESH_H_ */
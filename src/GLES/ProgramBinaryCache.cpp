@@ -0,0 +1,347 @@
+/*
+ * ProgramBinaryCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  On-disk cache of linked GL program binaries to avoid compiling the shaders at every start.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+
+#include <EGL/egl.h>
+
+#include "OVFCommon.h"
+
+#include "GLES/ProgramBinaryCache.h"
+
+#if !defined PROGRAM_CACHE_DIR
+#	define PROGRAM_CACHE_DIR "/var/cache/OpenVarioFront"
+#endif
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+/// \brief Identifies a cache file, and the version of the file layout
+static char const cacheFileMagic[8] = {'O','V','F','P','R','G','B','1'};
+static char const driverIdFileName[] = "driver.id";
+static char const binaryFileSuffix[] = ".bin";
+
+/// \brief FNV-1a 64 bit hash. Continues the hash value \p hash over \p len bytes.
+static uint64_t hashBytes(uint64_t hash,void const *data,size_t len) {
+	uint8_t const *bytes = static_cast<uint8_t const *>(data);
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+ProgramBinaryCache::ProgramBinaryCache()
+	:cacheDirectory {PROGRAM_CACHE_DIR}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.ProgramBinaryCache");
+	}
+#endif
+}
+
+ProgramBinaryCache::~ProgramBinaryCache() {
+}
+
+ProgramBinaryCache &ProgramBinaryCache::getProgramBinaryCache() {
+	static ProgramBinaryCache theProgramBinaryCache;
+
+	return theProgramBinaryCache;
+}
+
+void ProgramBinaryCache::setCacheDirectory(char const *cacheDirectory) {
+
+	this->cacheDirectory = cacheDirectory;
+	initialized = false;
+}
+
+void ProgramBinaryCache::initialize() {
+	char const *extensions = reinterpret_cast<char const *>(glGetString(GL_EXTENSIONS));
+	GLint numFormats = 0;
+
+	initialized = true;
+	available = false;
+
+	if (!extensions || !strstr(extensions,"GL_OES_get_program_binary")) {
+		LOG4CXX_INFO(logger,"GL_OES_get_program_binary is not supported. Programs are always compiled from source.");
+		return;
+	}
+
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES,&numFormats);
+	if (numFormats <= 0) {
+		LOG4CXX_INFO(logger,"The driver supports no program binary formats. Programs are always compiled from source.");
+		return;
+	}
+
+	getProgramBinaryFunc = (PFNGLGETPROGRAMBINARYOESPROC) eglGetProcAddress("glGetProgramBinaryOES");
+	programBinaryFunc = (PFNGLPROGRAMBINARYOESPROC) eglGetProcAddress("glProgramBinaryOES");
+	if (!getProgramBinaryFunc || !programBinaryFunc) {
+		LOG4CXX_WARN(logger,"glGetProgramBinaryOES or glProgramBinaryOES is not available.");
+		return;
+	}
+
+	{
+		std::ostringstream str;
+
+		str << glGetString(GL_VENDOR) << '\n' << glGetString(GL_RENDERER) << '\n' << glGetString(GL_VERSION);
+		driverId = str.str();
+	}
+
+	if (mkdir(cacheDirectory.c_str(),0755) != 0 && errno != EEXIST) {
+		LOG4CXX_WARN(logger,"Cannot create the program cache directory " << cacheDirectory << ": " << strerror(errno));
+		return;
+	}
+
+	// When the driver changed all binaries are invalid.
+	std::string const driverIdFile = cacheDirectory + '/' + driverIdFileName;
+	std::string storedDriverId;
+	{
+		std::ifstream idStream(driverIdFile,std::ios::binary);
+		std::ostringstream str;
+
+		if (idStream) {
+			str << idStream.rdbuf();
+			storedDriverId = str.str();
+		}
+	}
+
+	if (storedDriverId != driverId) {
+		LOG4CXX_INFO(logger,"GL driver changed. Purge the program cache in " << cacheDirectory);
+		purgeCache();
+
+		std::ofstream idStream(driverIdFile,std::ios::binary|std::ios::trunc);
+		idStream << driverId;
+		if (!idStream) {
+			LOG4CXX_WARN(logger,"Cannot write " << driverIdFile);
+			return;
+		}
+	}
+
+	LOG4CXX_DEBUG(logger,"Program binary cache in " << cacheDirectory << ", " << numFormats << " binary formats");
+
+	available = true;
+}
+
+void ProgramBinaryCache::purgeCache() {
+	DIR *dir = opendir(cacheDirectory.c_str());
+	struct dirent *entry;
+	size_t const suffixLen = strlen(binaryFileSuffix);
+
+	if (!dir) {
+		return;
+	}
+
+	while ((entry = readdir(dir)) != nullptr) {
+		size_t const nameLen = strlen(entry->d_name);
+
+		if (nameLen > suffixLen && strcmp(entry->d_name + nameLen - suffixLen,binaryFileSuffix) == 0) {
+			std::string const path = cacheDirectory + '/' + entry->d_name;
+
+			LOG4CXX_DEBUG(logger,"Delete " << path);
+			unlink(path.c_str());
+		}
+	}
+
+	closedir(dir);
+}
+
+std::string ProgramBinaryCache::getFileName(char const *vertexShaderCode,char const *fragmentShaderCode) const {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	std::ostringstream str;
+
+	// Include the terminating 0 bytes to separate the parts
+	hash = hashBytes(hash,vertexShaderCode,strlen(vertexShaderCode) + 1);
+	hash = hashBytes(hash,fragmentShaderCode,strlen(fragmentShaderCode) + 1);
+	hash = hashBytes(hash,driverId.data(),driverId.size());
+
+	str << cacheDirectory << '/' << std::hex << std::setw(16) << std::setfill('0') << hash << binaryFileSuffix;
+
+	return str.str();
+}
+
+bool ProgramBinaryCache::loadProgram(GLProgram &prog,char const *vertexShaderCode,char const *fragmentShaderCode) {
+
+	if (!enabled) {
+		return false;
+	}
+
+	if (!initialized) {
+		initialize();
+	}
+
+	if (!available) {
+		return false;
+	}
+
+	std::string const fileName = getFileName(vertexShaderCode,fragmentShaderCode);
+	std::ifstream file(fileName,std::ios::binary | std::ios::ate);
+
+	if (!file) {
+		LOG4CXX_DEBUG(logger,"Program " << fileName << " is not cached.");
+		numMisses++;
+		return false;
+	}
+
+	// The lengths in the file are checked against the file size. A corrupt file must not trigger huge allocations.
+	std::streamoff const fileSize = file.tellg();
+	file.seekg(0);
+
+	// File layout: magic, length of the driver ID, driver ID, binary format, length of the binary, binary
+	char magic[sizeof(cacheFileMagic)];
+	uint32_t idLen = 0;
+	std::string fileDriverId;
+	GLenum binaryFormat = 0;
+	uint32_t binaryLen = 0;
+	std::vector<uint8_t> binary;
+
+	file.read(magic,sizeof(magic));
+	file.read(reinterpret_cast<char*>(&idLen),sizeof(idLen));
+	if (file && memcmp(magic,cacheFileMagic,sizeof(magic)) == 0 && idLen == driverId.size()) {
+		fileDriverId.resize(idLen);
+		file.read(&fileDriverId[0],idLen);
+		file.read(reinterpret_cast<char*>(&binaryFormat),sizeof(binaryFormat));
+		file.read(reinterpret_cast<char*>(&binaryLen),sizeof(binaryLen));
+		if (file && fileDriverId == driverId && binaryLen > 0 && std::streamoff(binaryLen) <= fileSize - file.tellg()) {
+			binary.resize(binaryLen);
+			file.read(reinterpret_cast<char*>(binary.data()),binaryLen);
+		}
+	}
+
+	if (!file || binary.empty()) {
+		LOG4CXX_WARN(logger,"Program cache file " << fileName << " is invalid. Delete it.");
+		file.close();
+		unlink(fileName.c_str());
+		numMisses++;
+		return false;
+	}
+
+	GLuint const programHandle = glCreateProgram();
+
+	programBinaryFunc(programHandle,binaryFormat,binary.data(),GLint(binaryLen));
+
+	if (!prog.adoptLinkedProgram(programHandle)) {
+		// The driver may reject binaries e.g. after an update of the GPU firmware even when the version string is unchanged.
+		LOG4CXX_INFO(logger,"The driver rejected the cached program " << fileName << ". Delete it.");
+		glDeleteProgram(programHandle);
+		file.close();
+		unlink(fileName.c_str());
+		numMisses++;
+		return false;
+	}
+
+	LOG4CXX_DEBUG(logger,"Loaded program " << fileName << " from the cache, " << binaryLen << " bytes.");
+	numHits++;
+
+	return true;
+}
+
+void ProgramBinaryCache::storeProgram(GLProgram const &prog,char const *vertexShaderCode,char const *fragmentShaderCode) {
+
+	if (!enabled) {
+		return;
+	}
+
+	if (!initialized) {
+		initialize();
+	}
+
+	if (!available) {
+		return;
+	}
+
+	GLuint const programHandle = prog.getProgramHandle();
+	GLint binaryLen = 0;
+	GLsizei actualLen = 0;
+	GLenum binaryFormat = 0;
+	std::vector<uint8_t> binary;
+
+	glGetProgramiv(programHandle,GL_PROGRAM_BINARY_LENGTH_OES,&binaryLen);
+	if (binaryLen <= 0) {
+		LOG4CXX_WARN(logger,"Program " << programHandle << " has no binary.");
+		return;
+	}
+
+	binary.resize(binaryLen);
+	getProgramBinaryFunc(programHandle,binaryLen,&actualLen,&binaryFormat,binary.data());
+	if (actualLen <= 0) {
+		LOG4CXX_WARN(logger,"glGetProgramBinaryOES failed for program " << programHandle << ", GL error " << glGetError());
+		return;
+	}
+
+	std::string const fileName = getFileName(vertexShaderCode,fragmentShaderCode);
+	// Write into a temporary file, and rename it. Thus a crash never leaves a truncated cache file.
+	std::string const tempFileName = fileName + ".tmp";
+	{
+		std::ofstream file(tempFileName,std::ios::binary|std::ios::trunc);
+		uint32_t const idLen = driverId.size();
+		uint32_t const len = actualLen;
+
+		file.write(cacheFileMagic,sizeof(cacheFileMagic));
+		file.write(reinterpret_cast<char const*>(&idLen),sizeof(idLen));
+		file.write(driverId.data(),idLen);
+		file.write(reinterpret_cast<char const*>(&binaryFormat),sizeof(binaryFormat));
+		file.write(reinterpret_cast<char const*>(&len),sizeof(len));
+		file.write(reinterpret_cast<char const*>(binary.data()),len);
+
+		if (!file) {
+			LOG4CXX_WARN(logger,"Cannot write the program cache file " << tempFileName);
+			file.close();
+			unlink(tempFileName.c_str());
+			return;
+		}
+	}
+
+	if (rename(tempFileName.c_str(),fileName.c_str()) != 0) {
+		LOG4CXX_WARN(logger,"Cannot rename " << tempFileName << " to " << fileName << ": " << strerror(errno));
+		unlink(tempFileName.c_str());
+		return;
+	}
+
+	LOG4CXX_DEBUG(logger,"Stored program " << programHandle << " in " << fileName << ", " << actualLen << " bytes.");
+}
+
+} /* namespace OevGLES */
@@ -0,0 +1,158 @@
+/*
+ * ProgramBinaryCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  On-disk cache of linked GL program binaries to avoid compiling the shaders at every start.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef GLES_PROGRAMBINARYCACHE_H_
+#define GLES_PROGRAMBINARYCACHE_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include "GLES/GLProgram.h"
+
+namespace OevGLES {
+
+/** \brief Cache of linked program binaries
+ *
+ * Compiling and linking the shaders is a large part of the start time on small GPUs.
+ * With the extension GL_OES_get_program_binary the linked program can be retrieved from the driver,
+ * and stored in a file. At the next start the program is loaded from the file instead of compiling the shaders.
+ *
+ * The files are identified by a hash of the vertex and fragment shader sources and the driver identification
+ * (GL_VENDOR, GL_RENDERER and GL_VERSION). The driver identification is also stored in each file, and in
+ * the file driver.id in the cache directory. When the driver changes, e.g. after a system update,
+ * all cached binaries are deleted.
+ *
+ * When the extension is not available, or the driver rejects a binary, \ref loadProgram() returns false,
+ * and the program must be compiled from source as usual.
+ *
+ * The cache needs a current GL context. There is only one cache which is obtained with \ref getProgramBinaryCache().
+ */
+class ProgramBinaryCache {
+public:
+
+	/** \brief Return the only instance of the cache
+	 *
+	 * @return Reference to the cache
+	 */
+	static ProgramBinaryCache &getProgramBinaryCache();
+
+	/** \brief Set the directory of the cache files
+	 *
+	 * Must be called before the first program is created. The directory is created when it does not exist.
+	 * Default is the directory which is configured with --with-program-cache-dir, usually /var/cache/OpenVarioFront.
+	 *
+	 * @param cacheDirectory Path of the directory
+	 */
+	void setCacheDirectory(char const *cacheDirectory);
+
+	/** \brief Switch the cache on or off. Default is on.
+	 *
+	 * @param enabled When false \ref loadProgram() and \ref storeProgram() do nothing.
+	 */
+	void setEnabled(bool enabled) {
+		this->enabled = enabled;
+	}
+
+	/** \brief Load a program from the cache.
+	 *
+	 * @param prog Program object which takes over the linked program.
+	 * @param vertexShaderCode Source code of the vertex shader
+	 * @param fragmentShaderCode Source code of the fragment shader
+	 * @return true when the program was loaded and linked. false when the program must be compiled from source.
+	 */
+	bool loadProgram(GLProgram &prog,char const *vertexShaderCode,char const *fragmentShaderCode);
+
+	/** \brief Store a linked program in the cache
+	 *
+	 * Errors are logged, but otherwise ignored. The cache is only an optimization.
+	 *
+	 * @param prog The linked program
+	 * @param vertexShaderCode Source code of the vertex shader
+	 * @param fragmentShaderCode Source code of the fragment shader
+	 */
+	void storeProgram(GLProgram const &prog,char const *vertexShaderCode,char const *fragmentShaderCode);
+
+	/// \brief Is GL_OES_get_program_binary available? Only valid after the first call of \ref loadProgram().
+	bool isAvailable() const {
+		return available;
+	}
+
+	/// \brief Number of programs which were loaded from the cache
+	unsigned getNumHits() const {
+		return numHits;
+	}
+
+	/// \brief Number of programs which were not found in the cache, or were rejected by the driver
+	unsigned getNumMisses() const {
+		return numMisses;
+	}
+
+private:
+
+	ProgramBinaryCache();
+	~ProgramBinaryCache();
+
+	std::string cacheDirectory;
+	bool enabled = true;
+
+	/// \brief \ref initialize() was called
+	bool initialized = false;
+
+	/// \brief The extension is available, and the driver supports at least one binary format
+	bool available = false;
+
+	/// \brief GL_VENDOR, GL_RENDERER and GL_VERSION
+	std::string driverId;
+
+	PFNGLGETPROGRAMBINARYOESPROC getProgramBinaryFunc = nullptr;
+	PFNGLPROGRAMBINARYOESPROC programBinaryFunc = nullptr;
+
+	unsigned numHits = 0;
+	unsigned numMisses = 0;
+
+	/** \brief Check the extension, and prepare the cache directory.
+	 *
+	 * Called at the first use when the GL context exists. Purges the directory when the driver changed.
+	 */
+	void initialize();
+
+	/// \brief Delete all cached program files
+	void purgeCache();
+
+	/// \brief Path of the cache file of a program
+	std::string getFileName(char const *vertexShaderCode,char const *fragmentShaderCode) const;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLES_PROGRAMBINARYCACHE_H_ */
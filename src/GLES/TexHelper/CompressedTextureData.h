@@ -0,0 +1,129 @@
+/*
+ * CompressedTextureData.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Container for block compressed texture data with optional mip levels.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef COMPRESSEDTEXTUREDATA_H_
+#define COMPRESSEDTEXTUREDATA_H_
+
+#include <vector>
+#include <cstdint>
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+namespace OevGLES {
+
+/** \brief Block compressed texture data, e.g. ETC1
+ *
+ * Unlike \ref TextureData the texels cannot be addressed individually. The data of each mip level is passed
+ * to glCompressedTexImage2D() as it is.
+ * Like \ref TextureData the first row of blocks is the bottom of the image.
+ *
+ * The class is header-only because \ref GLTexture in the GLES library uploads it.
+ */
+class CompressedTextureData {
+public:
+
+	/// \brief One mip level
+	struct Level {
+		GLuint width;
+		GLuint height;
+		std::vector<uint8_t> data;
+	};
+
+	/** \brief Constructor
+	 *
+	 * @param glInternalFormat Compressed format, e.g. GL_ETC1_RGB8_OES
+	 */
+	CompressedTextureData(GLenum glInternalFormat = GL_ETC1_RGB8_OES)
+		:glInternalFormat{glInternalFormat}
+	{}
+
+	GLenum getGlInternalFormat() const {
+		return glInternalFormat;
+	}
+
+	/** \brief Append the next smaller mip level.
+	 *
+	 * @param width Width of the level in texels
+	 * @param height Height of the level in texels
+	 * @param data Compressed blocks of the level
+	 */
+	void addLevel(GLuint width,GLuint height,std::vector<uint8_t> data) {
+		levels.push_back(Level{width,height,std::move(data)});
+	}
+
+	size_t getNumLevels() const {
+		return levels.size();
+	}
+
+	Level const &getLevel(size_t levelNo) const {
+		return levels.at(levelNo);
+	}
+
+	/// \brief Width of level 0, 0 when there is no level
+	GLuint getWidth() const {
+		return levels.empty() ? 0 : levels[0].width;
+	}
+
+	/// \brief Height of level 0, 0 when there is no level
+	GLuint getHeight() const {
+		return levels.empty() ? 0 : levels[0].height;
+	}
+
+	/// \brief Size of all levels in bytes
+	size_t getDataSize() const {
+		size_t size = 0;
+
+		for (auto const &level : levels) {
+			size += level.data.size();
+		}
+
+		return size;
+	}
+
+	/** \brief Size of an ETC1 image in bytes. Blocks of 4x4 texels with 8 bytes each.
+	 *
+	 * @param width Width in texels
+	 * @param height Height in texels
+	 * @return Size of the compressed data
+	 */
+	static size_t getEtc1DataSize(GLuint width,GLuint height) {
+		return size_t((width + 3) / 4) * ((height + 3) / 4) * 8;
+	}
+
+private:
+
+	GLenum glInternalFormat;
+
+	std::vector<Level> levels;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* COMPRESSEDTEXTUREDATA_H_ */
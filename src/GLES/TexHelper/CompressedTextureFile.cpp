@@ -0,0 +1,330 @@
+/*
+ * CompressedTextureFile.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Reads and writes compressed textures in the KTX and PKM file formats.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <sstream>
+#include <vector>
+#include <memory>
+
+#include "GLES/TexHelper/CompressedTextureFile.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+
+static inline void initLogger() {
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.CompressedTextureFile");
+	}
+}
+#else
+static inline void initLogger() {}
+#endif
+
+static uint8_t const ktxIdentifier[12] = {0xAB,'K','T','X',' ','1','1',0xBB,'\r','\n',0x1A,'\n'};
+static uint32_t const ktxEndianness = 0x04030201;
+static char const pkmMagic[6] = {'P','K','M',' ','1','0'};
+/// \brief Format in the PKM header: ETC1 RGB without mip-maps
+static uint16_t const pkmFormatEtc1 = 0;
+/// \brief Key/value pair of the KTX header which declares the GL orientation: S to the right, T up
+static char const ktxOrientationKey[] = "KTXorientation";
+static char const ktxOrientationValue[] = "S=r,T=u";
+
+/// \brief Fields of the KTX header after identifier and endianness, in the order of the file
+enum KtxHeaderField {
+	glType,
+	glTypeSize,
+	glFormat,
+	glInternalFormat,
+	glBaseInternalFormat,
+	pixelWidth,
+	pixelHeight,
+	pixelDepth,
+	numberOfArrayElements,
+	numberOfFaces,
+	numberOfMipmapLevels,
+	bytesOfKeyValueData,
+	numKtxHeaderFields
+};
+
+/// \brief Closes the file when it goes out of scope
+struct FileCloser {
+	void operator () (FILE *file) const {
+		fclose(file);
+	}
+};
+typedef std::unique_ptr<FILE,FileCloser> FilePtr;
+
+static void throwFileError(char const *text,std::string const &fileName) {
+	std::ostringstream os;
+	os << "CompressedTextureFile: " << text << " \"" << fileName << '"';
+	throw CompressedTextureException(os.str().c_str());
+}
+
+static uint32_t swap32(uint32_t value) {
+	return (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+}
+
+static uint16_t readBigEndian16(uint8_t const *p) {
+	return uint16_t((p[0] << 8) | p[1]);
+}
+
+static void writeBigEndian16(uint8_t *p,uint16_t value) {
+	p[0] = uint8_t(value >> 8);
+	p[1] = uint8_t(value);
+}
+
+bool CompressedTextureFile::isCompressedTextureFile(std::string const &fileName) {
+
+	if (fileName.size() < 4) {
+		return false;
+	}
+
+	std::string extension = fileName.substr(fileName.size() - 4);
+	for (auto &c : extension) {
+		c = char(tolower(c));
+	}
+
+	return extension == ".ktx" || extension == ".pkm";
+}
+
+static void readKtx(FILE *file,std::string const &fileName,CompressedTextureData &textureData) {
+
+	uint32_t endianness;
+	uint32_t header[numKtxHeaderFields];
+
+	if (fread(&endianness,sizeof(endianness),1,file) != 1 ||
+			fread(header,sizeof(header),1,file) != 1) {
+		throwFileError("Truncated KTX header in",fileName);
+	}
+
+	bool const swapBytes = endianness != ktxEndianness;
+	if (swapBytes) {
+		if (swap32(endianness) != ktxEndianness) {
+			throwFileError("Invalid byte order mark in",fileName);
+		}
+		for (auto &field : header) {
+			field = swap32(field);
+		}
+	}
+
+	if (header[glType] != 0 || header[glFormat] != 0) {
+		throwFileError("Only compressed textures are supported. Uncompressed KTX file",fileName);
+	}
+
+	if (header[pixelDepth] > 1 || header[numberOfArrayElements] > 0 || header[numberOfFaces] != 1) {
+		throwFileError("Only 2D textures are supported. 3D, array or cube map KTX file",fileName);
+	}
+
+	if (fseek(file,long(header[bytesOfKeyValueData]),SEEK_CUR) != 0) {
+		throwFileError("Truncated key/value data in",fileName);
+	}
+
+	textureData = CompressedTextureData(header[glInternalFormat]);
+
+	uint32_t const numLevels = header[numberOfMipmapLevels] ? header[numberOfMipmapLevels] : 1;
+	GLuint width = header[pixelWidth];
+	GLuint height = header[pixelHeight];
+
+	for (uint32_t level = 0; level < numLevels; level++) {
+		uint32_t imageSize;
+
+		if (fread(&imageSize,sizeof(imageSize),1,file) != 1) {
+			throwFileError("Truncated mip level in",fileName);
+		}
+		if (swapBytes) {
+			imageSize = swap32(imageSize);
+		}
+
+		std::vector<uint8_t> data (imageSize);
+		if (imageSize > 0 && fread(data.data(),imageSize,1,file) != 1) {
+			throwFileError("Truncated mip level in",fileName);
+		}
+
+		// Levels are padded to 4 bytes
+		if (imageSize % 4) {
+			fseek(file,long(4 - imageSize % 4),SEEK_CUR);
+		}
+
+		textureData.addLevel(width,height,std::move(data));
+
+		width = std::max(width / 2,1U);
+		height = std::max(height / 2,1U);
+	}
+
+	LOG4CXX_DEBUG(logger,"Read KTX file " << fileName << ": " << header[pixelWidth] << 'x' << header[pixelHeight]
+			<< ", format 0x" << std::hex << header[glInternalFormat] << std::dec << ", " << numLevels << " levels");
+}
+
+static void readPkm(FILE *file,std::string const &fileName,CompressedTextureData &textureData) {
+
+	uint8_t header[10];
+
+	if (fread(header,sizeof(header),1,file) != 1) {
+		throwFileError("Truncated PKM header in",fileName);
+	}
+
+	if (readBigEndian16(header) != pkmFormatEtc1) {
+		throwFileError("Only ETC1 is supported. Other format in the PKM file",fileName);
+	}
+
+	// Header fields after the format: padded width and height, original width and height
+	GLuint const width = readBigEndian16(header + 6);
+	GLuint const height = readBigEndian16(header + 8);
+	std::vector<uint8_t> data (CompressedTextureData::getEtc1DataSize(width,height));
+
+	if (fread(data.data(),data.size(),1,file) != 1) {
+		throwFileError("Truncated data in",fileName);
+	}
+
+	textureData = CompressedTextureData(GL_ETC1_RGB8_OES);
+	textureData.addLevel(width,height,std::move(data));
+
+	LOG4CXX_DEBUG(logger,"Read PKM file " << fileName << ": " << width << 'x' << height);
+}
+
+void CompressedTextureFile::read(std::string const &fileName,CompressedTextureData &textureData) {
+
+	initLogger();
+
+	FilePtr file {fopen(fileName.c_str(),"rb")};
+	uint8_t magic[sizeof(ktxIdentifier)];
+
+	if (!file) {
+		throwFileError("Could not open",fileName);
+	}
+
+	if (fread(magic,sizeof(pkmMagic),1,file.get()) != 1) {
+		throwFileError("Truncated file",fileName);
+	}
+
+	if (!memcmp(magic,pkmMagic,sizeof(pkmMagic))) {
+		readPkm(file.get(),fileName,textureData);
+		return;
+	}
+
+	if (fread(magic + sizeof(pkmMagic),sizeof(ktxIdentifier) - sizeof(pkmMagic),1,file.get()) != 1 ||
+			memcmp(magic,ktxIdentifier,sizeof(ktxIdentifier))) {
+		throwFileError("Neither KTX nor PKM:",fileName);
+	}
+
+	readKtx(file.get(),fileName,textureData);
+}
+
+void CompressedTextureFile::writeKtx(std::string const &fileName,CompressedTextureData const &textureData) {
+
+	initLogger();
+
+	FilePtr file {fopen(fileName.c_str(),"wb")};
+	uint32_t header[numKtxHeaderFields];
+	static uint8_t const padding[4] = {0,0,0,0};
+
+	if (!file) {
+		throwFileError("Could not create",fileName);
+	}
+
+	// Key/value pair: Size of key and value, key and value with terminating 0, padded to 4 bytes
+	uint32_t const keyValueSize = uint32_t(sizeof(ktxOrientationKey) + sizeof(ktxOrientationValue));
+	uint32_t const keyValuePadding = (4 - keyValueSize % 4) % 4;
+
+	header[glType] = 0;
+	header[glTypeSize] = 1;
+	header[glFormat] = 0;
+	header[glInternalFormat] = textureData.getGlInternalFormat();
+	header[glBaseInternalFormat] = GL_RGB;
+	header[pixelWidth] = textureData.getWidth();
+	header[pixelHeight] = textureData.getHeight();
+	header[pixelDepth] = 0;
+	header[numberOfArrayElements] = 0;
+	header[numberOfFaces] = 1;
+	header[numberOfMipmapLevels] = uint32_t(textureData.getNumLevels());
+	header[bytesOfKeyValueData] = uint32_t(sizeof(keyValueSize)) + keyValueSize + keyValuePadding;
+
+	bool ok = fwrite(ktxIdentifier,sizeof(ktxIdentifier),1,file.get()) == 1 &&
+			fwrite(&ktxEndianness,sizeof(ktxEndianness),1,file.get()) == 1 &&
+			fwrite(header,sizeof(header),1,file.get()) == 1 &&
+			fwrite(&keyValueSize,sizeof(keyValueSize),1,file.get()) == 1 &&
+			fwrite(ktxOrientationKey,sizeof(ktxOrientationKey),1,file.get()) == 1 &&
+			fwrite(ktxOrientationValue,sizeof(ktxOrientationValue),1,file.get()) == 1 &&
+			fwrite(padding,1,keyValuePadding,file.get()) == keyValuePadding;
+
+	for (size_t i = 0; ok && i < textureData.getNumLevels(); i++) {
+		CompressedTextureData::Level const &level = textureData.getLevel(i);
+		uint32_t const imageSize = uint32_t(level.data.size());
+		uint32_t const levelPadding = (4 - imageSize % 4) % 4;
+
+		ok = fwrite(&imageSize,sizeof(imageSize),1,file.get()) == 1 &&
+				fwrite(level.data.data(),1,imageSize,file.get()) == imageSize &&
+				fwrite(padding,1,levelPadding,file.get()) == levelPadding;
+	}
+
+	if (!ok || fflush(file.get()) != 0) {
+		throwFileError("Could not write",fileName);
+	}
+}
+
+void CompressedTextureFile::writePkm(std::string const &fileName,CompressedTextureData const &textureData) {
+
+	initLogger();
+
+	if (textureData.getGlInternalFormat() != GL_ETC1_RGB8_OES || textureData.getNumLevels() == 0) {
+		throwFileError("PKM files can only hold ETC1 textures. Cannot write",fileName);
+	}
+
+	FilePtr file {fopen(fileName.c_str(),"wb")};
+	CompressedTextureData::Level const &level = textureData.getLevel(0);
+	uint8_t header[16];
+
+	if (!file) {
+		throwFileError("Could not create",fileName);
+	}
+
+	memcpy(header,pkmMagic,sizeof(pkmMagic));
+	writeBigEndian16(header + 6,pkmFormatEtc1);
+	writeBigEndian16(header + 8,uint16_t((level.width + 3) & ~3U));
+	writeBigEndian16(header + 10,uint16_t((level.height + 3) & ~3U));
+	writeBigEndian16(header + 12,uint16_t(level.width));
+	writeBigEndian16(header + 14,uint16_t(level.height));
+
+	if (fwrite(header,sizeof(header),1,file.get()) != 1 ||
+			fwrite(level.data.data(),1,level.data.size(),file.get()) != level.data.size() ||
+			fflush(file.get()) != 0) {
+		throwFileError("Could not write",fileName);
+	}
+}
+
+} /* namespace OevGLES */
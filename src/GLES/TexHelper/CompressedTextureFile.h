@@ -0,0 +1,87 @@
+/*
+ * CompressedTextureFile.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Reads and writes compressed textures in the KTX and PKM file formats.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef COMPRESSEDTEXTUREFILE_H_
+#define COMPRESSEDTEXTUREFILE_H_
+
+#include <string>
+
+#include "OVFCommon.h"
+
+#include "GLES/TexHelper/CompressedTextureData.h"
+
+namespace OevGLES {
+
+/** \brief KTX and PKM files of compressed textures
+ *
+ * - KTX version 1 can hold any compressed format and a mip chain. Files of both byte orders are read.
+ * - PKM is the simple ETC1 format of the Android tools with exactly one level.
+ *
+ * The blocks are stored in the order in which GL expects them, i.e. the first row of blocks is the bottom of the image.
+ * This is the convention of KTX. PKM files of other tools usually start at the top; the image appears flipped then.
+ * Flip the images with the tool which created them, or use PngToEtc1 which writes both formats in GL order.
+ */
+class CompressedTextureFile {
+public:
+
+	/** \brief Check the file name extension
+	 *
+	 * @param fileName Name of the file
+	 * @return true when the extension is .ktx or .pkm, independent of the case
+	 */
+	static bool isCompressedTextureFile(std::string const &fileName);
+
+	/** \brief Read a KTX or PKM file. The format is determined by the content.
+	 *
+	 * @param fileName Name of the file
+	 * @param[out] textureData Receives the texture. Its previous content is replaced.
+	 * @throws CompressedTextureException when the file cannot be read or is invalid
+	 */
+	static void read(std::string const &fileName,CompressedTextureData &textureData);
+
+	/** \brief Write a KTX file with all levels
+	 *
+	 * @param fileName Name of the file
+	 * @param textureData The texture
+	 * @throws CompressedTextureException when the file cannot be written
+	 */
+	static void writeKtx(std::string const &fileName,CompressedTextureData const &textureData);
+
+	/** \brief Write level 0 of an ETC1 texture into a PKM file
+	 *
+	 * @param fileName Name of the file
+	 * @param textureData The texture
+	 * @throws CompressedTextureException when the texture is not ETC1, or the file cannot be written
+	 */
+	static void writePkm(std::string const &fileName,CompressedTextureData const &textureData);
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* COMPRESSEDTEXTUREFILE_H_ */
@@ -0,0 +1,227 @@
+/*
+ * DistanceField.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Signed distance field generator for glyphs and symbols
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "GLES/TexHelper/DistanceField.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+/// \brief Squared distance of texels without a seed. Finite, the transform subtracts them from each other.
+static float const farAway = 1e20f;
+
+/** \brief One dimensional squared distance transform of a row or column, in place
+ *
+ * Lower envelope of the parabolas rooted at each texel, see Felzenszwalb and Huttenlocher,
+ * "Distance Transforms of Sampled Functions".
+ *
+ * @param grid Squared distances
+ * @param offset Index of the first texel in \p grid
+ * @param stride Distance between the texels in \p grid
+ * @param length Number of texels
+ * @param f Scratch buffer with \p length entries
+ * @param z Scratch buffer with \p length + 1 entries
+ * @param v Scratch buffer with \p length entries
+ */
+static void transform1D(float *grid,size_t offset,size_t stride,unsigned length,float *f,float *z,int *v) {
+
+	f[0] = grid[offset];
+	v[0] = 0;
+	z[0] = -farAway;
+	z[1] = farAway;
+
+	for (int q = 1, k = 0; q < int(length); q++) {
+		float s;
+
+		f[q] = grid[offset + q * stride];
+		do {
+			int const r = v[k];
+			s = (f[q] - f[r] + float(q * q - r * r)) / float(2 * (q - r));
+		} while (s <= z[k] && --k >= 0);
+
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = farAway;
+	}
+
+	for (int q = 0, k = 0; q < int(length); q++) {
+		while (z[k + 1] < float(q)) {
+			k++;
+		}
+		float const qr = float(q - v[k]);
+		grid[offset + q * stride] = f[v[k]] + qr * qr;
+	}
+}
+
+/// \brief Two dimensional squared distance transform in place, columns first, then rows
+static void transform2D(std::vector<float> &grid,unsigned width,unsigned height) {
+	unsigned const maxLength = std::max(width,height);
+	std::vector<float> f (maxLength);
+	std::vector<float> z (maxLength + 1);
+	std::vector<int> v (maxLength);
+
+	for (unsigned x = 0; x < width; x++) {
+		transform1D(grid.data(),x,width,height,f.data(),z.data(),v.data());
+	}
+	for (unsigned y = 0; y < height; y++) {
+		transform1D(grid.data(),size_t(y) * width,1,width,f.data(),z.data(),v.data());
+	}
+}
+
+DistanceField::DistanceField(unsigned spread,unsigned downscale)
+	:spread {std::max(spread,1U)},
+	 downscale {std::max(downscale,1U)}
+{
+}
+
+DistanceField::~DistanceField() {
+}
+
+std::vector<uint8_t> DistanceField::generate(uint8_t const *coverage,unsigned width,unsigned height,unsigned margin,
+		unsigned &fieldWidth,unsigned &fieldHeight) const {
+
+	fieldWidth = (width + downscale - 1) / downscale + 2 * margin;
+	fieldHeight = (height + downscale - 1) / downscale + 2 * margin;
+
+	// The source grid covers the distance field completely. The margin and the rounding have no coverage.
+	unsigned const gridWidth = fieldWidth * downscale;
+	unsigned const gridHeight = fieldHeight * downscale;
+	unsigned const gridOffset = margin * downscale;
+	size_t const gridSize = size_t(gridWidth) * gridHeight;
+
+	// Squared distances to the nearest inside texel, and to the nearest outside texel
+	std::vector<float> outside (gridSize,farAway);
+	std::vector<float> inside (gridSize,0.0f);
+
+	for (unsigned y = 0; y < height; y++) {
+		uint8_t const *src = coverage + size_t(y) * width;
+		size_t const gridRow = size_t(y + gridOffset) * gridWidth + gridOffset;
+
+		for (unsigned x = 0; x < width; x++) {
+			size_t const i = gridRow + x;
+
+			if (src[x] == 255) {
+				outside[i] = 0.0f;
+				inside[i] = farAway;
+			} else if (src[x] > 0) {
+				// The edge runs through anti-aliased texels. The coverage estimates the distance of the texel center from it.
+				float const d = 0.5f - float(src[x]) / 255.0f;
+
+				outside[i] = d > 0.0f ? d * d : 0.0f;
+				inside[i] = d < 0.0f ? d * d : 0.0f;
+			}
+		}
+	}
+
+	transform2D(outside,gridWidth,gridHeight);
+	transform2D(inside,gridWidth,gridHeight);
+
+	// Average each block of source distances, and map +-spread texels of the distance field to 0..1.
+	std::vector<uint8_t> field (size_t(fieldWidth) * fieldHeight);
+	float const scale = 1.0f / (float(downscale) * float(downscale) * float(downscale) * 2.0f * float(spread));
+
+	for (unsigned fy = 0; fy < fieldHeight; fy++) {
+		for (unsigned fx = 0; fx < fieldWidth; fx++) {
+			float distanceSum = 0.0f;
+
+			for (unsigned y = fy * downscale; y < (fy + 1) * downscale; y++) {
+				size_t const row = size_t(y) * gridWidth;
+
+				for (unsigned x = fx * downscale; x < (fx + 1) * downscale; x++) {
+					// Positive outside
+					distanceSum += sqrtf(outside[row + x]) - sqrtf(inside[row + x]);
+				}
+			}
+
+			float const value = std::max(0.0f,std::min(1.0f,0.5f - distanceSum * scale));
+			field[size_t(fy) * fieldWidth + fx] = uint8_t(lrintf(value * 255.0f));
+		}
+	}
+
+	return field;
+}
+
+TextureData DistanceField::generate(TextureData const &image) const {
+	unsigned channels;
+	unsigned coverageChannel;
+
+	if (image.getDataType() != TextureData::Byte) {
+		throw TextureException("DistanceField::generate: Only images with byte channels are supported");
+	}
+
+	switch (image.getGlFormat()) {
+	case TextureData::RGBA:
+		channels = 4;
+		coverageChannel = 3;
+		break;
+	case TextureData::LuminanceA:
+		channels = 2;
+		coverageChannel = 1;
+		break;
+	case TextureData::Luminance:
+		channels = 1;
+		coverageChannel = 0;
+		break;
+	default:
+		throw TextureException("DistanceField::generate: The image has no alpha or luminance channel for the coverage");
+	}
+
+	unsigned const width = image.getWidth();
+	unsigned const height = image.getHeight();
+	uint8_t const *texels = static_cast<uint8_t const *>(image.getDataPtr());
+	std::vector<uint8_t> coverage (size_t(width) * height);
+
+	if (!texels) {
+		throw TextureException("DistanceField::generate: The image has no texels");
+	}
+
+	for (size_t i = 0; i < coverage.size(); i++) {
+		coverage[i] = texels[i * channels + coverageChannel];
+	}
+
+	unsigned fieldWidth;
+	unsigned fieldHeight;
+	std::vector<uint8_t> field = generate(coverage.data(),width,height,0,fieldWidth,fieldHeight);
+	TextureData result (fieldWidth,fieldHeight,TextureData::Luminance,TextureData::Byte);
+
+	memcpy(result.getDataPtr(),field.data(),field.size());
+
+	return result;
+}
+
+} /* namespace OevGLES */
@@ -0,0 +1,114 @@
+/*
+ * DistanceField.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Signed distance field generator for glyphs and symbols
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+
+#ifndef DISTANCEFIELD_H_
+#define DISTANCEFIELD_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "GLES/TexHelper/TextureData.h"
+
+namespace OevGLES {
+
+/** \brief Signed distance field generator
+ *
+ * A distance field texture stores for each texel the distance to the nearest edge of the shape instead of its coverage.
+ * The edge lies at 0.5, texels inside the shape are larger, outside smaller. Linear filtering interpolates the distance, and
+ * the fragment shader cuts at 0.5. Thus the edges stay sharp when the texture is magnified, scaled, or rotated, and one small
+ * texture serves all sizes of a text or a symbol. \see GLProgTextSDF
+ *
+ * The source is a coverage bitmap, e.g. a glyph rendered by FreeType, or the alpha channel of a symbol image,
+ * rendered at \p downscale times the resolution of the distance field. The exact Euclidean distances to the inside and to
+ * the outside are computed on the source grid with the separable transform of Felzenszwalb and Huttenlocher.
+ * Anti-aliased edge texels are seeded with their sub-texel distance to the edge. Each texel of the distance field is the
+ * average of a block of \p downscale x \p downscale source distances.
+ *
+ * Distances are clamped to \p spread texels of the distance field. The spread limits the width of effects like outlines
+ * or glows, and must be covered by the margin around the shape, or the empty space between glyphs in a sheet.
+ */
+class DistanceField {
+public:
+
+	/** \brief Constructor
+	 *
+	 * @param spread Largest distance from the edge which is encoded, in texels of the distance field
+	 * @param downscale Ratio of the source resolution to the distance field resolution
+	 */
+	DistanceField(unsigned spread = 4,unsigned downscale = 4);
+
+	virtual ~DistanceField();
+
+	/** \brief Create a distance field from a coverage bitmap
+	 *
+	 * The source is extended by \p margin texels of the distance field with zero coverage on all sides.
+	 * The rows of the result are in the order of the source rows.
+	 *
+	 * @param coverage Coverage of the source texels, 255 is inside. Rows are densely packed.
+	 * @param width Width of the source in texels
+	 * @param height Height of the source in texels
+	 * @param margin Empty texels of the distance field around the shape, usually the spread
+	 * @param[out] fieldWidth Width of the distance field, (width / downscale) rounded up + 2 * margin
+	 * @param[out] fieldHeight Height of the distance field, (height / downscale) rounded up + 2 * margin
+	 * @return The distance field, one byte per texel. 128 is the edge.
+	 */
+	std::vector<uint8_t> generate(uint8_t const *coverage,unsigned width,unsigned height,unsigned margin,
+			unsigned &fieldWidth,unsigned &fieldHeight) const;
+
+	/** \brief Create a distance field texture from an image
+	 *
+	 * The coverage is the alpha channel of RGBA and luminance/alpha images, and the luminance of luminance images.
+	 * No margin is added, i.e. the shapes of the image must keep a distance of \p spread texels of the distance
+	 * field from the border.
+	 *
+	 * @param image Image with byte channels
+	 * @return Luminance texture with 1/\p downscale of the size of the image
+	 * @throws TextureException when the image has no byte channels, or is RGB without a coverage channel
+	 */
+	TextureData generate(TextureData const &image) const;
+
+	unsigned getSpread() const {
+		return spread;
+	}
+
+	unsigned getDownscale() const {
+		return downscale;
+	}
+
+private:
+
+	unsigned spread;
+	unsigned downscale;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* DISTANCEFIELD_H_ */
@@ -0,0 +1,397 @@
+/*
+ * Etc1Codec.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Encoder and decoder of ETC1 compressed textures.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <climits>
+
+#include "GLES/TexHelper/Etc1Codec.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+/// \brief The modifier tables of ETC1. The modifiers are +a, +b, -a, -b for the pixel indexes 0..3.
+static int const modifierTables[8][2] = {
+		{ 2,  8},
+		{ 5, 17},
+		{ 9, 29},
+		{13, 42},
+		{18, 60},
+		{24, 80},
+		{33,106},
+		{47,183}
+};
+
+static inline int modifier(unsigned table,unsigned index) {
+	int const value = modifierTables[table][index & 1];
+
+	return (index & 2) ? -value : value;
+}
+
+static inline int clamp255(int value) {
+	return std::min(std::max(value,0),255);
+}
+
+/** \brief Sub-block of a texel
+ *
+ * @param flip false: 2x4 sub-blocks side by side. true: 4x2 sub-blocks on top of each other.
+ * @param i Texel in the block, row by row
+ */
+static inline unsigned subBlockOf(bool flip,unsigned i) {
+	return flip ? (i / 4 >= 2) : (i % 4 >= 2);
+}
+
+/** \brief Choose the best modifier table for the texels of a sub-block
+ *
+ * @param[out] table The best table
+ * @param[out] indexes Pixel indexes of the texels of the sub-block
+ * @return Squared error
+ */
+static unsigned long fitSubBlock(
+		uint8_t const texels[16][3],
+		bool flip,
+		unsigned subBlock,
+		int const base[3],
+		unsigned &table,
+		unsigned indexes[16]) {
+
+	unsigned long bestError = ULONG_MAX;
+
+	for (unsigned t = 0; t < 8; t++) {
+		unsigned long error = 0;
+		unsigned tableIndexes[16];
+
+		for (unsigned i = 0; i < 16 && error < bestError; i++) {
+			if (subBlockOf(flip,i) != subBlock) {
+				continue;
+			}
+
+			unsigned long bestTexelError = ULONG_MAX;
+			for (unsigned m = 0; m < 4; m++) {
+				int const mod = modifier(t,m);
+				unsigned long texelError = 0;
+
+				for (unsigned c = 0; c < 3; c++) {
+					int const diff = clamp255(base[c] + mod) - texels[i][c];
+					texelError += (unsigned long)(diff * diff);
+				}
+
+				if (texelError < bestTexelError) {
+					bestTexelError = texelError;
+					tableIndexes[i] = m;
+				}
+			}
+			error += bestTexelError;
+		}
+
+		if (error < bestError) {
+			bestError = error;
+			table = t;
+			for (unsigned i = 0; i < 16; i++) {
+				if (subBlockOf(flip,i) == subBlock) {
+					indexes[i] = tableIndexes[i];
+				}
+			}
+		}
+	}
+
+	return bestError;
+}
+
+void Etc1Codec::encodeBlock(uint8_t const texels[16][3],uint8_t block[8]) {
+
+	unsigned long bestError = ULONG_MAX;
+	uint32_t bestHigh = 0;
+	uint32_t bestLow = 0;
+
+	for (unsigned f = 0; f < 2; f++) {
+		bool const flip = f != 0;
+		unsigned sum[2][3] = {{0,0,0},{0,0,0}};
+
+		for (unsigned i = 0; i < 16; i++) {
+			for (unsigned c = 0; c < 3; c++) {
+				sum[subBlockOf(flip,i)][c] += texels[i][c];
+			}
+		}
+
+		// Base colors in 5 bit for the differential mode, and 4 bit for the individual mode. Sums are of 8 texels.
+		int color5[2][3];
+		int color4[2][3];
+		bool diffPossible = true;
+		for (unsigned s = 0; s < 2; s++) {
+			for (unsigned c = 0; c < 3; c++) {
+				color5[s][c] = int((sum[s][c] * 31 + 255 * 4) / (255 * 8));
+				color4[s][c] = int((sum[s][c] * 15 + 255 * 4) / (255 * 8));
+			}
+		}
+		for (unsigned c = 0; c < 3; c++) {
+			int const delta = color5[1][c] - color5[0][c];
+			if (delta < -4 || delta > 3) {
+				diffPossible = false;
+			}
+		}
+
+		for (unsigned diffMode = 0; diffMode < 2; diffMode++) {
+			int base[2][3];
+			unsigned tables[2];
+			unsigned indexes[16];
+			unsigned long error = 0;
+
+			if (diffMode && !diffPossible) {
+				continue;
+			}
+
+			for (unsigned s = 0; s < 2; s++) {
+				for (unsigned c = 0; c < 3; c++) {
+					base[s][c] = diffMode ?
+							((color5[s][c] << 3) | (color5[s][c] >> 2)) :
+							((color4[s][c] << 4) | color4[s][c]);
+				}
+				error += fitSubBlock(texels,flip,s,base[s],tables[s],indexes);
+			}
+
+			if (error >= bestError) {
+				continue;
+			}
+
+			bestError = error;
+
+			uint32_t high;
+			if (diffMode) {
+				high = (uint32_t(color5[0][0]) << 27) | (uint32_t((color5[1][0] - color5[0][0]) & 7) << 24) |
+						(uint32_t(color5[0][1]) << 19) | (uint32_t((color5[1][1] - color5[0][1]) & 7) << 16) |
+						(uint32_t(color5[0][2]) << 11) | (uint32_t((color5[1][2] - color5[0][2]) & 7) << 8);
+			} else {
+				high = (uint32_t(color4[0][0]) << 28) | (uint32_t(color4[1][0]) << 24) |
+						(uint32_t(color4[0][1]) << 20) | (uint32_t(color4[1][1]) << 16) |
+						(uint32_t(color4[0][2]) << 12) | (uint32_t(color4[1][2]) << 8);
+			}
+			high |= (tables[0] << 5) | (tables[1] << 2) | (diffMode << 1) | f;
+
+			// The pixel indexes are stored column by column, the MSBs in the upper half word
+			uint32_t low = 0;
+			for (unsigned i = 0; i < 16; i++) {
+				unsigned const bit = (i % 4) * 4 + i / 4;
+				low |= (uint32_t(indexes[i] >> 1) << (bit + 16)) | (uint32_t(indexes[i] & 1) << bit);
+			}
+
+			bestHigh = high;
+			bestLow = low;
+		}
+	}
+
+	for (unsigned i = 0; i < 4; i++) {
+		block[i] = uint8_t(bestHigh >> (24 - i * 8));
+		block[i + 4] = uint8_t(bestLow >> (24 - i * 8));
+	}
+}
+
+void Etc1Codec::decodeBlock(uint8_t const block[8],uint8_t texels[16][3]) {
+
+	uint32_t const high = (uint32_t(block[0]) << 24) | (uint32_t(block[1]) << 16) | (uint32_t(block[2]) << 8) | block[3];
+	uint32_t const low = (uint32_t(block[4]) << 24) | (uint32_t(block[5]) << 16) | (uint32_t(block[6]) << 8) | block[7];
+	bool const flip = high & 1;
+	unsigned const tables[2] = {(high >> 5) & 7,(high >> 2) & 7};
+	int base[2][3];
+
+	for (unsigned c = 0; c < 3; c++) {
+		unsigned const shift = 27 - c * 8;
+
+		if (high & 2) {
+			int const color1 = int((high >> shift) & 0x1f);
+			int delta = int((high >> (shift - 3)) & 7);
+			if (delta >= 4) {
+				delta -= 8;
+			}
+			int const color2 = (color1 + delta) & 0x1f;
+
+			base[0][c] = (color1 << 3) | (color1 >> 2);
+			base[1][c] = (color2 << 3) | (color2 >> 2);
+		} else {
+			int const color1 = int((high >> (shift + 1)) & 0xf);
+			int const color2 = int((high >> (shift - 3)) & 0xf);
+
+			base[0][c] = (color1 << 4) | color1;
+			base[1][c] = (color2 << 4) | color2;
+		}
+	}
+
+	for (unsigned i = 0; i < 16; i++) {
+		unsigned const bit = (i % 4) * 4 + i / 4;
+		unsigned const index = (((low >> (bit + 16)) & 1) << 1) | ((low >> bit) & 1);
+		unsigned const s = subBlockOf(flip,i);
+		int const mod = modifier(tables[s],index);
+
+		for (unsigned c = 0; c < 3; c++) {
+			texels[i][c] = uint8_t(clamp255(base[s][c] + mod));
+		}
+	}
+}
+
+template <class GetTexel>
+CompressedTextureData Etc1Codec::encodeImage(GLuint width,GLuint height,GetTexel getTexel) {
+
+	CompressedTextureData compressed;
+	std::vector<uint8_t> data (CompressedTextureData::getEtc1DataSize(width,height));
+	uint8_t *block = data.data();
+
+	for (GLuint by = 0; by < height; by += 4) {
+		for (GLuint bx = 0; bx < width; bx += 4, block += 8) {
+			uint8_t texels[16][3];
+
+			for (unsigned i = 0; i < 16; i++) {
+				// Texels outside of the image repeat the edge
+				GLuint const x = std::min(bx + i % 4,width - 1);
+				GLuint const y = std::min(by + i / 4,height - 1);
+
+				getTexel(x,y,texels[i]);
+			}
+
+			encodeBlock(texels,block);
+		}
+	}
+
+	compressed.addLevel(width,height,std::move(data));
+
+	return compressed;
+}
+
+/// \brief Number of byte channels, and position of alpha or 0 without alpha
+static void getChannels(TextureData const &image,unsigned &numChannels,unsigned &alphaChannel) {
+
+	if (image.getDataType() != TextureData::Byte || !image.getDataPtr()) {
+		throw CompressedTextureException("Etc1Codec: The image must have byte channels");
+	}
+
+	switch (image.getGlFormat()) {
+	case TextureData::Luminance:
+		numChannels = 1;
+		alphaChannel = 0;
+		break;
+	case TextureData::LuminanceA:
+		numChannels = 2;
+		alphaChannel = 1;
+		break;
+	case TextureData::RGB:
+		numChannels = 3;
+		alphaChannel = 0;
+		break;
+	case TextureData::RGBA:
+		numChannels = 4;
+		alphaChannel = 3;
+		break;
+	default:
+		throw CompressedTextureException("Etc1Codec: Unsupported image format");
+	}
+}
+
+CompressedTextureData Etc1Codec::encode(TextureData const &image) {
+
+	unsigned numChannels;
+	unsigned alphaChannel;
+	GLuint const width = image.getWidth();
+	uint8_t const *src = static_cast<uint8_t const*>(image.getDataPtr());
+
+	getChannels(image,numChannels,alphaChannel);
+
+	return encodeImage(width,image.getHeight(),[src,width,numChannels] (GLuint x,GLuint y,uint8_t texel[3]) {
+		uint8_t const *p = src + (y * width + x) * numChannels;
+
+		if (numChannels <= 2) {
+			texel[0] = texel[1] = texel[2] = p[0];
+		} else {
+			texel[0] = p[0];
+			texel[1] = p[1];
+			texel[2] = p[2];
+		}
+	});
+}
+
+CompressedTextureData Etc1Codec::encodeAlpha(TextureData const &image) {
+
+	unsigned numChannels;
+	unsigned alphaChannel;
+	GLuint const width = image.getWidth();
+	uint8_t const *src = static_cast<uint8_t const*>(image.getDataPtr());
+
+	getChannels(image,numChannels,alphaChannel);
+
+	if (alphaChannel == 0) {
+		throw CompressedTextureException("Etc1Codec: The image has no alpha channel");
+	}
+
+	return encodeImage(width,image.getHeight(),[src,width,numChannels,alphaChannel] (GLuint x,GLuint y,uint8_t texel[3]) {
+		texel[0] = texel[1] = texel[2] = src[(y * width + x) * numChannels + alphaChannel];
+	});
+}
+
+TextureData Etc1Codec::decode(CompressedTextureData const &data,size_t levelNo) {
+
+	if (data.getGlInternalFormat() != GL_ETC1_RGB8_OES || levelNo >= data.getNumLevels()) {
+		throw CompressedTextureException("Etc1Codec: The texture is not ETC1, or the level does not exist");
+	}
+
+	CompressedTextureData::Level const &level = data.getLevel(levelNo);
+	GLuint const width = level.width;
+	GLuint const height = level.height;
+
+	if (level.data.size() < CompressedTextureData::getEtc1DataSize(width,height)) {
+		throw CompressedTextureException("Etc1Codec: The compressed data is too short");
+	}
+
+	TextureData image {width,height,TextureData::RGB,TextureData::Byte};
+	uint8_t *dest = static_cast<uint8_t*>(image.getDataPtr());
+	uint8_t const *block = level.data.data();
+
+	for (GLuint by = 0; by < height; by += 4) {
+		for (GLuint bx = 0; bx < width; bx += 4, block += 8) {
+			uint8_t texels[16][3];
+
+			decodeBlock(block,texels);
+
+			for (unsigned i = 0; i < 16; i++) {
+				GLuint const x = bx + i % 4;
+				GLuint const y = by + i / 4;
+
+				if (x < width && y < height) {
+					uint8_t *p = dest + (y * width + x) * 3;
+					p[0] = texels[i][0];
+					p[1] = texels[i][1];
+					p[2] = texels[i][2];
+				}
+			}
+		}
+	}
+
+	return image;
+}
+
+} /* namespace OevGLES */
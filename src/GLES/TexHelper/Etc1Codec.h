@@ -0,0 +1,105 @@
+/*
+ * Etc1Codec.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Encoder and decoder of ETC1 compressed textures.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef ETC1CODEC_H_
+#define ETC1CODEC_H_
+
+#include <cstdint>
+
+#include "GLES/TexHelper/TextureData.h"
+#include "GLES/TexHelper/CompressedTextureData.h"
+
+namespace OevGLES {
+
+/** \brief ETC1 block compression
+ *
+ * ETC1 stores blocks of 4x4 RGB texels in 8 bytes. It is supported by every GLES2 GPU of Mali,
+ * and reduces the texture memory and the bandwidth of sampling to 1/6 of RGB bytes.
+ * ETC1 has no alpha. Images with alpha are stored as two ETC1 textures, the colors and the alpha as gray image.
+ *
+ * The encoder is used by the tool PngToEtc1 which converts the images at build time.
+ * It tries both block orientations, the individual and the differential mode, and all modifier tables
+ * with the average colors of the sub-blocks as base colors. This is fast and good enough for instrument faces.
+ *
+ * The decoder is the fallback when the GPU does not support ETC1, or when an image goes into a \ref TextureAtlas.
+ */
+class Etc1Codec {
+public:
+
+	/** \brief Compress a texture
+	 *
+	 * Images with sizes which are not a multiple of 4 are padded by repeating the edge texels.
+	 *
+	 * @param image Luminance, LuminanceA, RGB or RGBA image with byte channels. Alpha is ignored.
+	 * @return ETC1 data with one level
+	 * @throws CompressedTextureException for other formats
+	 */
+	static CompressedTextureData encode(TextureData const &image);
+
+	/** \brief Compress the alpha channel of a texture as gray image
+	 *
+	 * @param image LuminanceA or RGBA image with byte channels
+	 * @return ETC1 data with one level. The alpha is in all color channels.
+	 * @throws CompressedTextureException for images without alpha
+	 */
+	static CompressedTextureData encodeAlpha(TextureData const &image);
+
+	/** \brief Decompress a level of an ETC1 texture
+	 *
+	 * @param data ETC1 texture
+	 * @param levelNo The mip level
+	 * @return RGB image with byte channels
+	 * @throws CompressedTextureException when the data is not ETC1 or too short
+	 */
+	static TextureData decode(CompressedTextureData const &data,size_t levelNo = 0);
+
+	/** \brief Compress a block of 4x4 texels
+	 *
+	 * @param texels RGB texels, row by row. The first row is the lowest row of the image.
+	 * @param[out] block 8 bytes of the compressed block
+	 */
+	static void encodeBlock(uint8_t const texels[16][3],uint8_t block[8]);
+
+	/** \brief Decompress a block
+	 *
+	 * @param block 8 bytes of the compressed block
+	 * @param[out] texels RGB texels, row by row
+	 */
+	static void decodeBlock(uint8_t const block[8],uint8_t texels[16][3]);
+
+private:
+
+	/// \brief Compress an image which is delivered by the texel accessor into RGB
+	template <class GetTexel>
+	static CompressedTextureData encodeImage(GLuint width,GLuint height,GetTexel getTexel);
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* ETC1CODEC_H_ */
@@ -0,0 +1,349 @@
+/*
+ * MipMapGenerator.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Creates the mip-map chain of a texture on the CPU.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined __ARM_NEON || defined __ARM_NEON__
+#	include <arm_neon.h>
+#	define MIPGEN_USE_NEON 1
+#elif defined __SSE__
+#	include <xmmintrin.h>
+#	define MIPGEN_USE_SSE 1
+#endif
+
+#include "GLES/TexHelper/MipMapGenerator.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+// Operations on the 4 channels of a texel
+#if defined MIPGEN_USE_NEON
+
+typedef float32x4_t Texel4;
+
+static inline Texel4 loadTexel(float const *p) {
+	return vld1q_f32(p);
+}
+
+static inline void storeTexel(float *p,Texel4 texel) {
+	vst1q_f32(p,texel);
+}
+
+static inline Texel4 zeroTexel() {
+	return vdupq_n_f32(0.0f);
+}
+
+/// \brief acc + texel * weight
+static inline Texel4 addWeighted(Texel4 acc,Texel4 texel,float weight) {
+	return vmlaq_n_f32(acc,texel,weight);
+}
+
+#elif defined MIPGEN_USE_SSE
+
+typedef __m128 Texel4;
+
+static inline Texel4 loadTexel(float const *p) {
+	return _mm_loadu_ps(p);
+}
+
+static inline void storeTexel(float *p,Texel4 texel) {
+	_mm_storeu_ps(p,texel);
+}
+
+static inline Texel4 zeroTexel() {
+	return _mm_setzero_ps();
+}
+
+/// \brief acc + texel * weight
+static inline Texel4 addWeighted(Texel4 acc,Texel4 texel,float weight) {
+	return _mm_add_ps(acc,_mm_mul_ps(texel,_mm_set1_ps(weight)));
+}
+
+#else
+
+struct Texel4 {
+	float c[4];
+};
+
+static inline Texel4 loadTexel(float const *p) {
+	return Texel4{{p[0],p[1],p[2],p[3]}};
+}
+
+static inline void storeTexel(float *p,Texel4 texel) {
+	p[0] = texel.c[0];
+	p[1] = texel.c[1];
+	p[2] = texel.c[2];
+	p[3] = texel.c[3];
+}
+
+static inline Texel4 zeroTexel() {
+	return Texel4{{0.0f,0.0f,0.0f,0.0f}};
+}
+
+/// \brief acc + texel * weight
+static inline Texel4 addWeighted(Texel4 acc,Texel4 texel,float weight) {
+	for (int i = 0; i < 4; i++) {
+		acc.c[i] += texel.c[i] * weight;
+	}
+	return acc;
+}
+
+#endif
+
+/// \brief Number of entries of the table which encodes linear values to sRGB
+static unsigned const linearToSrgbSize = 4096;
+
+/// \brief Tables for the conversion between sRGB bytes and linear light
+struct SrgbTables {
+	float toLinear[256];
+	uint8_t toSrgb[linearToSrgbSize];
+
+	SrgbTables() {
+		for (unsigned i = 0; i < 256; i++) {
+			float const v = float(i) / 255.0f;
+			toLinear[i] = (v <= 0.04045f) ? v / 12.92f : std::pow((v + 0.055f) / 1.055f,2.4f);
+		}
+
+		for (unsigned i = 0; i < linearToSrgbSize; i++) {
+			float const v = float(i) / float(linearToSrgbSize - 1);
+			float const srgb = (v <= 0.0031308f) ? v * 12.92f : 1.055f * std::pow(v,1.0f / 2.4f) - 0.055f;
+			toSrgb[i] = uint8_t(std::min(std::max(srgb * 255.0f + 0.5f,0.0f),255.0f));
+		}
+	}
+};
+
+static SrgbTables const &getSrgbTables() {
+	static SrgbTables const tables;
+
+	return tables;
+}
+
+/// \brief Modified Bessel function of the first kind, order 0
+static double besselI0(double x) {
+	double sum = 1.0;
+	double term = 1.0;
+
+	for (int k = 1; k < 30; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+
+	return sum;
+}
+
+MipMapGenerator::MipMapGenerator(Filter filter,bool linearLight)
+	:filter{filter},
+	 linearLight{linearLight}
+{
+
+	if (filter == Box) {
+		tapOffsets = {0,1};
+		tapWeights = {0.5f,0.5f};
+	} else {
+		// Sinc with the cutoff at half the source frequency, windowed by Kaiser. Radius 4 source texels, alpha 4.
+		double const radius = 4.0;
+		double const beta = 4.0;
+		double sum = 0.0;
+		std::vector<double> weights;
+
+		for (int offset = -3; offset <= 4; offset++) {
+			// Distance from the center between the pair of source texels
+			double const d = offset - 0.5;
+			double const t = M_PI * d / 2.0;
+			double const sinc = std::sin(t) / t;
+			double const window = besselI0(beta * std::sqrt(1.0 - (d / radius) * (d / radius))) / besselI0(beta);
+
+			tapOffsets.push_back(offset);
+			weights.push_back(sinc * window);
+			sum += sinc * window;
+		}
+
+		for (double weight : weights) {
+			tapWeights.push_back(float(weight / sum));
+		}
+	}
+
+	// Initialize the tables before the generator is used by several threads
+	if (linearLight) {
+		getSrgbTables();
+	}
+}
+
+MipMapGenerator::~MipMapGenerator() {
+}
+
+std::vector<TextureData> MipMapGenerator::createMipChain(TextureData const &level0) const {
+	std::vector<TextureData> levels;
+	TextureData const *level = &level0;
+
+	while (level->getWidth() > 1 || level->getHeight() > 1) {
+		levels.push_back(createNextLevel(*level));
+		level = &levels.back();
+	}
+
+	return levels;
+}
+
+TextureData MipMapGenerator::createNextLevel(TextureData const &level) const {
+
+	unsigned numChannels;
+	bool hasAlpha;
+
+	if (level.getDataType() != TextureData::Byte || !level.getDataPtr()) {
+		throw TextureException("MipMapGenerator: The texture must have byte channels");
+	}
+
+	switch (level.getGlFormat()) {
+	case TextureData::Luminance:
+		numChannels = 1;
+		hasAlpha = false;
+		break;
+	case TextureData::LuminanceA:
+		numChannels = 2;
+		hasAlpha = true;
+		break;
+	case TextureData::RGB:
+		numChannels = 3;
+		hasAlpha = false;
+		break;
+	case TextureData::RGBA:
+		numChannels = 4;
+		hasAlpha = true;
+		break;
+	default:
+		throw TextureException("MipMapGenerator: Unsupported texture format");
+	}
+
+	SrgbTables const &srgb = getSrgbTables();
+	int const srcWidth = int(level.getWidth());
+	int const srcHeight = int(level.getHeight());
+	GLuint const width = std::max(level.getWidth() / 2,1U);
+	GLuint const height = std::max(level.getHeight() / 2,1U);
+	TextureData nextLevel {width,height,level.getGlFormat(),TextureData::Byte};
+	uint8_t const *srcData = static_cast<uint8_t const*>(level.getDataPtr());
+	uint8_t *destData = static_cast<uint8_t*>(nextLevel.getDataPtr());
+
+	// A dimension of 1 texel is not filtered
+	static int const singleOffset = 0;
+	static float const singleWeight = 1.0f;
+	size_t const numTapsX = (srcWidth > 1) ? tapOffsets.size() : 1;
+	size_t const numTapsY = (srcHeight > 1) ? tapOffsets.size() : 1;
+	int const *offsetsX = (srcWidth > 1) ? tapOffsets.data() : &singleOffset;
+	int const *offsetsY = (srcHeight > 1) ? tapOffsets.data() : &singleOffset;
+	float const *weightsX = (srcWidth > 1) ? tapWeights.data() : &singleWeight;
+	float const *weightsY = (srcHeight > 1) ? tapWeights.data() : &singleWeight;
+
+	// Source row as 4 floats per texel, and a ring of horizontally filtered rows for the vertical filter
+	std::vector<float> srcRow (size_t(srcWidth) * 4);
+	std::vector<float> filteredRows (numTapsY * width * 4);
+	std::vector<int> filteredRowNo (numTapsY,-1);
+	std::vector<float> destRow (width * 4);
+
+	auto getFilteredRow = [&] (int rowNo) -> float const * {
+		size_t const slot = size_t(rowNo) % numTapsY;
+		float *filtered = &filteredRows[slot * width * 4];
+
+		if (filteredRowNo[slot] == rowNo) {
+			return filtered;
+		}
+
+		// Convert the row to linear floats with colors weighted by alpha
+		uint8_t const *src = srcData + size_t(rowNo) * srcWidth * numChannels;
+		for (int x = 0; x < srcWidth; x++, src += numChannels) {
+			float *texel = &srcRow[size_t(x) * 4];
+			float const alpha = hasAlpha ? src[numChannels - 1] / 255.0f : 1.0f;
+
+			for (unsigned c = 0; c < 3; c++) {
+				uint8_t const value = src[(numChannels >= 3) ? c : 0];
+				texel[c] = (linearLight ? srgb.toLinear[value] : value / 255.0f) * alpha;
+			}
+			texel[3] = alpha;
+		}
+
+		for (GLuint x = 0; x < width; x++) {
+			Texel4 acc = zeroTexel();
+
+			for (size_t k = 0; k < numTapsX; k++) {
+				int const srcX = std::min(std::max(int(x) * 2 + offsetsX[k],0),srcWidth - 1);
+				acc = addWeighted(acc,loadTexel(&srcRow[size_t(srcX) * 4]),weightsX[k]);
+			}
+			storeTexel(filtered + x * 4,acc);
+		}
+
+		filteredRowNo[slot] = rowNo;
+		return filtered;
+	};
+
+	for (GLuint y = 0; y < height; y++) {
+		float const *rows[8];
+
+		for (size_t k = 0; k < numTapsY; k++) {
+			rows[k] = getFilteredRow(std::min(std::max(int(y) * 2 + offsetsY[k],0),srcHeight - 1));
+		}
+
+		for (GLuint x = 0; x < width; x++) {
+			Texel4 acc = zeroTexel();
+
+			for (size_t k = 0; k < numTapsY; k++) {
+				acc = addWeighted(acc,loadTexel(rows[k] + x * 4),weightsY[k]);
+			}
+			storeTexel(&destRow[x * 4],acc);
+		}
+
+		// Back to bytes in the format of the level
+		uint8_t *dest = destData + size_t(y) * width * numChannels;
+		for (GLuint x = 0; x < width; x++, dest += numChannels) {
+			float const *texel = &destRow[x * 4];
+			float const alpha = std::min(std::max(texel[3],0.0f),1.0f);
+			// Colors of fully transparent texels do not matter
+			float const unweight = (hasAlpha && alpha > 0.5f / 255.0f) ? 1.0f / alpha : 1.0f;
+			unsigned const numColors = (numChannels >= 3) ? 3 : 1;
+
+			for (unsigned c = 0; c < numColors; c++) {
+				float const value = std::min(std::max(texel[c] * unweight,0.0f),1.0f);
+
+				dest[c] = linearLight ?
+						srgb.toSrgb[unsigned(value * float(linearToSrgbSize - 1) + 0.5f)] :
+						uint8_t(value * 255.0f + 0.5f);
+			}
+			if (hasAlpha) {
+				dest[numChannels - 1] = uint8_t(alpha * 255.0f + 0.5f);
+			}
+		}
+	}
+
+	return nextLevel;
+}
+
+} /* namespace OevGLES */
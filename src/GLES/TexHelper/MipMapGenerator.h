@@ -0,0 +1,109 @@
+/*
+ * MipMapGenerator.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Creates the mip-map chain of a texture on the CPU.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef MIPMAPGENERATOR_H_
+#define MIPMAPGENERATOR_H_
+
+#include <vector>
+
+#include "GLES/TexHelper/TextureData.h"
+
+namespace OevGLES {
+
+/** \brief Mip-map chain generator
+ *
+ * glGenerateMipmap() runs on the GL thread, is slow on some GLES2 drivers, filters with a plain box,
+ * and averages the gamma encoded values which makes fine bright lines on dark ground, like the text of the dials,
+ * thin and dim. The generator creates the levels on the CPU, usually on a worker thread of the \ref TextureLoader.
+ * The levels are then uploaded with \ref GLTexture::setTextureData() one by one.
+ *
+ * Each level is created from the previous one by halving width and height:
+ * - Box: 2x2 average. Fast, but blurs and aliases.
+ * - Kaiser: Kaiser windowed sinc with 8 taps in each direction. Keeps edges sharp. The slight overshoot at edges is clamped.
+ *
+ * Optionally the color channels are filtered in linear light: They are decoded from sRGB before, and encoded again after filtering.
+ * Colors are weighted with alpha. Thus transparent texels do not darken the edges of symbols.
+ *
+ * The filters work on 4 floats per texel. They use NEON or SSE where available.
+ * Only textures with byte channels are supported. Convert the levels to 16 bit formats afterwards with \ref TextureConverter.
+ */
+class MipMapGenerator {
+public:
+
+	enum Filter {
+		Box,
+		Kaiser
+	};
+
+	/** \brief Constructor
+	 *
+	 * @param filter Filter for the down-sampling
+	 * @param linearLight Filter the color channels in linear light. The textures must be sRGB encoded, like all PNG images of the instruments.
+	 */
+	MipMapGenerator(Filter filter = Kaiser,bool linearLight = true);
+
+	virtual ~MipMapGenerator();
+
+	/** \brief Create the next smaller level
+	 *
+	 * @param level Level with byte channels
+	 * @return Level with half width and height, at least 1 texel, in the format of the source
+	 * @throws TextureException when the level does not have byte channels
+	 */
+	TextureData createNextLevel(TextureData const &level) const;
+
+	/** \brief Create all levels from level 1 to the level with 1x1 texels
+	 *
+	 * @param level0 The texture
+	 * @return Levels 1..n. Level 0 is not copied.
+	 * @throws TextureException when the level does not have byte channels
+	 */
+	std::vector<TextureData> createMipChain(TextureData const &level0) const;
+
+	Filter getFilter() const {
+		return filter;
+	}
+
+	bool isLinearLight() const {
+		return linearLight;
+	}
+
+private:
+
+	Filter filter;
+	bool linearLight;
+
+	/// \brief Offsets of the taps from the left or lower texel of a pair of source texels, and their weights
+	std::vector<int> tapOffsets;
+	std::vector<float> tapWeights;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* MIPMAPGENERATOR_H_ */
@@ -32,6 +32,9 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <sstream>
+#include <vector>
+#include <memory>
+#include <cstdint>
 #include <libpng16/png.h>
 
 #include "GLES/TexHelper/PngReader.h"
@@ -55,14 +58,15 @@ PngReader::PngReader(char const *fileName)
 
 PngReader::~PngReader() {}
 
-void PngReader::readPngToTexture(TextureData &textureData) {
+void PngReader::readPngToTexture(TextureData &textureData,OutputFormat outputFormat,TextureConverter::Dithering dithering) {
 
 	FILE			*pngFile = 0;
 	png_structp 	pngPtr = 0;
 	png_infop   	pngInfo = 0;
-	TextureData 	*result = 0;
-	png_bytep	 	*rowPointers = 0;
-
+	// Decoded row before the conversion to 16 bit texels, or the complete image for interlaced images
+	std::vector<png_byte> convBuffer;
+	// Conversion to 16 bit texels. Lives outside the scope of setjmp like the buffer.
+	std::unique_ptr<TextureConverter> converter;
 
 	try {
 
@@ -87,76 +91,76 @@ void PngReader::readPngToTexture(TextureData &textureData) {
 			throw PngReaderException("png_create_info_struct() failed");
 		}
 
+		// Objects with destructors must not be alive during the libpng calls below. longjmp would skip them.
 		if (setjmp(png_jmpbuf(pngPtr))) {
 			LOG4CXX_ERROR(logger,"LibPng called longjmp during reading PNG file");
 			throw PngReaderException("longjmp called due to internal png error");
 		}
 
 		png_init_io(pngPtr,pngFile);
-		LOG4CXX_DEBUG(logger,"Called png_init_io");
-
 		png_set_sig_bytes(pngPtr,0);
-		LOG4CXX_DEBUG(logger,"Called png_set_sig_bytes");
 
-		png_read_png(pngPtr,pngInfo,PNG_TRANSFORM_EXPAND|PNG_TRANSFORM_STRIP_16|PNG_TRANSFORM_PACKING,0);
-		LOG4CXX_DEBUG(logger,"Called png_read_png");
+		png_read_info(pngPtr,pngInfo);
+
+		// The same transformations as PNG_TRANSFORM_EXPAND|PNG_TRANSFORM_STRIP_16|PNG_TRANSFORM_PACKING
+		png_set_expand(pngPtr);
+		png_set_strip_16(pngPtr);
+		png_set_packing(pngPtr);
+
+		// The 16 bit formats are converted from RGB or RGBA bytes
+		if (outputFormat != Native) {
+			png_byte const fileColorType = png_get_color_type(pngPtr,pngInfo);
+
+			if (!(fileColorType & PNG_COLOR_MASK_COLOR)) {
+				png_set_gray_to_rgb(pngPtr);
+			}
+
+			if (outputFormat == RGB565) {
+				if ((fileColorType & PNG_COLOR_MASK_ALPHA) || png_get_valid(pngPtr,pngInfo,PNG_INFO_tRNS)) {
+					png_set_strip_alpha(pngPtr);
+				}
+			} else {
+				png_set_add_alpha(pngPtr,0xff,PNG_FILLER_AFTER);
+			}
+		}
+
+		int const numPasses = png_set_interlace_handling(pngPtr);
 
-		png_uint_32 width = 0,height =0;
-		int bitDepth = 0, colorType = 0;
-		png_get_IHDR(pngPtr,pngInfo,&width,&height,&bitDepth,&colorType,NULL,NULL,NULL);
-		LOG4CXX_DEBUG(logger,"Called png_get_IHDR");
-		LOG4CXX_DEBUG(logger,"width = "<< width << ", height = "<< height << ", bitDepth = "<< bitDepth << ", colorType = "<< colorType );
+		png_read_update_info(pngPtr,pngInfo);
+
+		png_uint_32 const width = png_get_image_width(pngPtr,pngInfo);
+		png_uint_32 const height = png_get_image_height(pngPtr,pngInfo);
+		int const bitDepth = png_get_bit_depth(pngPtr,pngInfo);
+		int const colorType = png_get_color_type(pngPtr,pngInfo);
+		png_size_t const bytesPerRow = png_get_rowbytes(pngPtr,pngInfo);
+
+		LOG4CXX_DEBUG(logger,"width = "<< width << ", height = "<< height << ", bitDepth = "<< bitDepth
+				<< ", colorType = "<< colorType << ", passes = " << numPasses << ", bytes per row = " << bytesPerRow);
+
+		if (bitDepth != 8) {
+			std::ostringstream os;
+			os << "Bit depth " << bitDepth << " of color type " << colorType << " is not supported.";
+			throw PngReaderException(os.str().c_str());
+		}
 
 		TextureData::GlFormat textureFormat;
-		TextureData::DataType textureDataType;
+		TextureData::DataType textureDataType = TextureData::Byte;
 		// Build the texture buffer object according to the information from the PNG file
 		switch (colorType) {
 		case PNG_COLOR_TYPE_GRAY:
-			LOG4CXX_DEBUG(logger,"Color type is PNG_COLOR_TYPE_GRAY");
-			if (bitDepth != 8) {
-				std::ostringstream os;
-				os << "Bit depth of color type PNG_COLOR_TYPE_GRAY is " << bitDepth << ". This depth is not supported.";
-				throw PngReaderException(os.str().c_str());
-			} else {
-				textureFormat = TextureData::Luminance;
-				textureDataType = TextureData::Byte;
-			}
+			textureFormat = TextureData::Luminance;
 			break;
 
 		case PNG_COLOR_TYPE_GRAY_ALPHA:
-			LOG4CXX_DEBUG(logger,"Color type is PNG_COLOR_TYPE_GRAY_ALPHA");
-			if (bitDepth != 8) {
-				std::ostringstream os;
-				os << "Bit depth of color type PNG_COLOR_TYPE_GRAY_ALPHA is " << bitDepth << ". This depth is not supported.";
-				throw PngReaderException(os.str().c_str());
-			} else {
-				textureFormat = TextureData::LuminanceA;
-				textureDataType = TextureData::Byte;
-			}
+			textureFormat = TextureData::LuminanceA;
 			break;
 
 		case PNG_COLOR_TYPE_RGB:
-			LOG4CXX_DEBUG(logger,"Color type is PNG_COLOR_TYPE_RGB");
-			if (bitDepth != 8) {
-				std::ostringstream os;
-				os << "Bit depth of color type PNG_COLOR_TYPE_RGB is " << bitDepth << ". This depth is not supported.";
-				throw PngReaderException(os.str().c_str());
-			} else {
-				textureFormat = TextureData::RGB;
-				textureDataType = TextureData::Byte;
-			}
+			textureFormat = TextureData::RGB;
 			break;
 
 		case PNG_COLOR_TYPE_RGB_ALPHA:
-			LOG4CXX_DEBUG(logger,"Color type is PNG_COLOR_TYPE_RGBA");
-			if (bitDepth != 8) {
-				std::ostringstream os;
-				os << "Bit depth of color type PNG_COLOR_TYPE_RGB_ALPHA is " << bitDepth << ". This depth is not supported.";
-				throw PngReaderException(os.str().c_str());
-			} else {
-				textureFormat = TextureData::RGBA;
-				textureDataType = TextureData::Byte;
-			}
+			textureFormat = TextureData::RGBA;
 			break;
 
 		default:
@@ -169,36 +173,68 @@ void PngReader::readPngToTexture(TextureData &textureData) {
 
 		}
 
-		textureData = TextureData(width,height,textureFormat,textureDataType);
-		png_bytep texDataPtr = png_bytep (textureData.getDataPtr());
-		LOG4CXX_DEBUG(logger,"PNG buffer length is " << (png_get_rowbytes(pngPtr,pngInfo) * height) <<
-				", the length of the texturedata buffer is " << textureData.getDataBufferLength());
-		if (textureData.getDataBufferLength() != png_get_rowbytes(pngPtr,pngInfo) * height) {
-			std::ostringstream os;
-			os << "Error in PngReader: PNG buffer length is " << (png_get_rowbytes(pngPtr,pngInfo) * height) <<
-					" whereas the length of the texturedata buffer is " << textureData.getDataBufferLength();
-			throw PngReaderException(os.str().c_str());
+		if (outputFormat == RGB565) {
+			textureDataType = TextureData::Short565;
+		} else if (outputFormat == RGBA4444) {
+			textureDataType = TextureData::Short4444;
+		} else if (outputFormat == RGBA5551) {
+			textureDataType = TextureData::Short5551;
 		}
 
-		rowPointers = png_get_rows(pngPtr,pngInfo);
-		LOG4CXX_DEBUG(logger,"Read image into rows");
+		textureData = TextureData(width,height,textureFormat,textureDataType);
+		png_bytep const texDataPtr = png_bytep (textureData.getDataPtr());
+		png_size_t const texBytesPerRow = textureData.getDataBufferLength() / height;
 
+		if (outputFormat == Native) {
 
-		png_bytep currRow = texDataPtr;
-		png_size_t bytesPerRow = png_get_rowbytes(pngPtr,pngInfo);
+			if (textureData.getDataBufferLength() != bytesPerRow * height) {
+				std::ostringstream os;
+				os << "Error in PngReader: PNG buffer length is " << (bytesPerRow * height) <<
+						" whereas the length of the texturedata buffer is " << textureData.getDataBufferLength();
+				throw PngReaderException(os.str().c_str());
+			}
 
-		LOG4CXX_DEBUG(logger,"Bytes per row = " << bytesPerRow);
-		LOG4CXX_DEBUG(logger,"Bytes per pixel = " << bytesPerRow/width);
+			// Decode the rows directly into the texture buffer, bottom to top.
+			// Interlace passes combine their pixels with the content of the row.
+			for (int pass = 0; pass < numPasses; pass++) {
+				for (png_uint_32 i = 0; i < height; i++) {
+					png_read_row(pngPtr,texDataPtr + (height - 1 - i) * texBytesPerRow,NULL);
+				}
+			}
 
+		} else {
+
+			if (numPasses > 1) {
+				// Interlaced images need all rows until the last pass
+				LOG4CXX_DEBUG(logger,"Interlaced image. Decode the complete image before the conversion.");
+				convBuffer.resize(bytesPerRow * height);
+				for (int pass = 0; pass < numPasses; pass++) {
+					for (png_uint_32 i = 0; i < height; i++) {
+						png_read_row(pngPtr,convBuffer.data() + i * bytesPerRow,NULL);
+					}
+				}
+			} else {
+				convBuffer.resize(bytesPerRow);
+			}
+
+			converter = std::make_unique<TextureConverter>(width,png_get_channels(pngPtr,pngInfo),textureDataType,dithering);
+
+			for (png_uint_32 i = 0; i < height; i++) {
+				png_const_bytep srcRow;
+				uint16_t *destRow = reinterpret_cast<uint16_t*>(texDataPtr + (height - 1 - i) * texBytesPerRow);
 
-		// Read the rows bottom to top into the texture buffer
-		for (int i = height - 1; i >= 0; i--) {
-			LOG4CXX_TRACE(logger,"Copy from line " << i << " to line " << ((currRow - texDataPtr) / bytesPerRow));
-			memcpy (currRow,rowPointers[i],bytesPerRow);
-			currRow += bytesPerRow;
+				if (numPasses > 1) {
+					srcRow = convBuffer.data() + i * bytesPerRow;
+				} else {
+					png_read_row(pngPtr,convBuffer.data(),NULL);
+					srcRow = convBuffer.data();
+				}
+
+				converter->convertRow(srcRow,destRow);
+			}
 		}
 
-		LOG4CXX_DEBUG(logger,"Copied the buffer");
+		LOG4CXX_DEBUG(logger,"Decoded the image into the texture buffer");
 
 		// Cleanup
 		png_destroy_read_struct(&pngPtr,&pngInfo,NULL);
@@ -212,16 +248,8 @@ void PngReader::readPngToTexture(TextureData &textureData) {
 
 		// Perform internal cleanup before re-throwing the exception
 
-		if (rowPointers) {
-			delete rowPointers;
-		}
-
-		if (pngInfo) {
-			png_destroy_info_struct(pngPtr,&pngInfo);
-		}
-
 		if (pngPtr) {
-			png_destroy_read_struct(&pngPtr,NULL,NULL);
+			png_destroy_read_struct(&pngPtr,pngInfo ? &pngInfo : NULL,NULL);
 		}
 
 		if (pngFile) {
@@ -231,9 +259,6 @@ void PngReader::readPngToTexture(TextureData &textureData) {
 		throw;
 	}
 
-
-
-
 }
 
 
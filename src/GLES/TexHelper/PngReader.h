@@ -31,15 +31,50 @@
 #include "OVFCommon.h"
 
 #include "GLES/TexHelper/TextureData.h"
+#include "GLES/TexHelper/TextureConverter.h"
 
 namespace OevGLES {
 
+/** \brief Reads PNG files into texture buffers
+ *
+ * The image is decoded row by row with png_read_row() directly into the buffer of the \ref TextureData.
+ * libpng does not allocate an image buffer of its own, thus the image never exists twice in memory.
+ * The rows are stored bottom to top as GL expects them.
+ *
+ * Palette images and gray images with less than 8 bit are expanded, 16 bit channels are reduced to 8 bit.
+ */
 class PngReader {
 public:
+
+	/// \brief Format of the texture which is created from the image
+	enum OutputFormat {
+		/// \brief Byte channels in the format of the file, i.e. Luminance, LuminanceA, RGB or RGBA
+		Native,
+		/// \brief RGB in 16 bit texels 5-6-5. Alpha is discarded, gray is expanded to RGB.
+		RGB565,
+		/// \brief RGBA in 16 bit texels 4-4-4-4. Images without alpha become opaque, gray is expanded to RGB.
+		RGBA4444,
+		/// \brief RGBA in 16 bit texels 5-5-5-1. Alpha is reduced to a single bit, otherwise as RGBA4444.
+		RGBA5551
+	};
+
 	PngReader(char const *fileName);
 	virtual ~PngReader();
 
-	void readPngToTexture(TextureData &textureData);
+	/** \brief Decode the image into a texture buffer
+	 *
+	 * The 16 bit formats are converted while the rows are decoded with only one row of temporary memory.
+	 * Only interlaced images which are converted need a temporary buffer of the complete image.
+	 *
+	 * @param[out] textureData Receives the image. Its previous content is replaced.
+	 * @param outputFormat Format of the texture
+	 * @param dithering Dithering of the color channels for the 16 bit formats. Ignored for \ref Native.
+	 * @throws PngReaderException
+	 */
+	void readPngToTexture(
+			TextureData &textureData,
+			OutputFormat outputFormat = Native,
+			TextureConverter::Dithering dithering = TextureConverter::NoDithering);
 
 private:
 
@@ -0,0 +1,141 @@
+/*
+ * SkylinePacker.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Skyline rectangle packer for texture atlases.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+
+#include "GLES/TexHelper/SkylinePacker.h"
+
+namespace OevGLES {
+
+SkylinePacker::SkylinePacker(unsigned width,unsigned height)
+	:width{width},
+	 height{height}
+{
+	clear();
+}
+
+SkylinePacker::~SkylinePacker() {
+}
+
+void SkylinePacker::clear() {
+	skyline.clear();
+	skyline.push_back(Segment{0,0,width});
+	usedArea = 0;
+}
+
+bool SkylinePacker::fitsAt(size_t index,unsigned width,unsigned height,unsigned &y) const {
+
+	unsigned const x = skyline[index].x;
+
+	if (x + width > this->width) {
+		return false;
+	}
+
+	// The rectangle rests on the highest segment below it
+	unsigned remainingWidth = width;
+	y = 0;
+	for (size_t i = index; remainingWidth > 0; i++) {
+		y = std::max(y,skyline[i].y);
+		if (skyline[i].width >= remainingWidth) {
+			break;
+		}
+		remainingWidth -= skyline[i].width;
+	}
+
+	return y + height <= this->height;
+}
+
+bool SkylinePacker::insert(unsigned width,unsigned height,unsigned &x,unsigned &y) {
+
+	size_t bestIndex = skyline.size();
+	unsigned bestTop = ~0U;
+	unsigned bestWidth = ~0U;
+
+	if (width == 0 || height == 0) {
+		return false;
+	}
+
+	for (size_t i = 0; i < skyline.size(); i++) {
+		unsigned segY;
+
+		if (fitsAt(i,width,height,segY)) {
+			unsigned const top = segY + height;
+
+			if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+				bestIndex = i;
+				bestTop = top;
+				bestWidth = skyline[i].width;
+			}
+		}
+	}
+
+	if (bestIndex == skyline.size()) {
+		return false;
+	}
+
+	Segment const newSegment {skyline[bestIndex].x,bestTop,width};
+	x = newSegment.x;
+	y = bestTop - height;
+
+	skyline.insert(skyline.begin() + bestIndex,newSegment);
+
+	// Shorten or remove the segments which are now covered by the new one
+	unsigned const right = newSegment.x + newSegment.width;
+	size_t i = bestIndex + 1;
+	while (i < skyline.size() && skyline[i].x < right) {
+		unsigned const segRight = skyline[i].x + skyline[i].width;
+
+		if (segRight <= right) {
+			skyline.erase(skyline.begin() + i);
+		} else {
+			skyline[i].width = segRight - right;
+			skyline[i].x = right;
+			break;
+		}
+	}
+
+	// Merge neighbours of equal height
+	for (i = 0; i + 1 < skyline.size();) {
+		if (skyline[i].y == skyline[i + 1].y) {
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		} else {
+			i++;
+		}
+	}
+
+	usedArea += (unsigned long)width * height;
+
+	return true;
+}
+
+} /* namespace OevGLES */
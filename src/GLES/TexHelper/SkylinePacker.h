@@ -0,0 +1,111 @@
+/*
+ * SkylinePacker.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Skyline rectangle packer for texture atlases.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef SKYLINEPACKER_H_
+#define SKYLINEPACKER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace OevGLES {
+
+/** \brief Packs rectangles into a fixed area with the skyline bottom-left heuristic
+ *
+ * The packer tracks the upper edge of the occupied area as a list of horizontal segments, the skyline.
+ * A new rectangle is placed on the skyline where its top edge is lowest. Ties are resolved by the narrowest segment.
+ * Space below overhanging rectangles is lost, however the packer is fast and needs only a few bytes of state.
+ * For the mostly similar sized images of instruments the waste is small.
+ *
+ * The packer does not know texels. The caller can work in units of aligned blocks.
+ */
+class SkylinePacker {
+public:
+
+	/** \brief Constructor
+	 *
+	 * @param width Width of the area
+	 * @param height Height of the area
+	 */
+	SkylinePacker(unsigned width,unsigned height);
+
+	virtual ~SkylinePacker();
+
+	/** \brief Find a place for a rectangle, and mark it occupied.
+	 *
+	 * @param width Width of the rectangle
+	 * @param height Height of the rectangle
+	 * @param[out] x Left edge of the placed rectangle
+	 * @param[out] y Lower edge of the placed rectangle
+	 * @return false when the rectangle does not fit any more. x and y are unchanged then.
+	 */
+	bool insert(unsigned width,unsigned height,unsigned &x,unsigned &y);
+
+	/// \brief Remove all rectangles
+	void clear();
+
+	/// \brief Area which is covered by inserted rectangles
+	unsigned long getUsedArea() const {
+		return usedArea;
+	}
+
+	unsigned getWidth() const {
+		return width;
+	}
+
+	unsigned getHeight() const {
+		return height;
+	}
+
+private:
+
+	/// \brief Horizontal segment of the skyline
+	struct Segment {
+		unsigned x;
+		unsigned y;
+		unsigned width;
+	};
+
+	unsigned width;
+	unsigned height;
+
+	/// \brief The skyline from left to right. The segments cover the complete width.
+	std::vector<Segment> skyline;
+
+	unsigned long usedArea = 0;
+
+	/** \brief Lowest y where a rectangle can be placed on the skyline, starting at segment \p index
+	 *
+	 * @return false when the rectangle exceeds the area at this position
+	 */
+	bool fitsAt(size_t index,unsigned width,unsigned height,unsigned &y) const;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* SKYLINEPACKER_H_ */
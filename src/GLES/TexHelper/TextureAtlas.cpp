@@ -0,0 +1,316 @@
+/*
+ * TextureAtlas.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Packs many images into a few large textures, and hands out their texture coordinates.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "OVFCommon.h"
+
+#include "GLES/TexHelper/TextureAtlas.h"
+#include "GLES/TexHelper/TextureConverter.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+/// \brief Number of byte channels of a format
+static unsigned numChannels(TextureData::GlFormat glFormat) {
+
+	switch (glFormat) {
+	case TextureData::Luminance:
+		return 1;
+	case TextureData::LuminanceA:
+		return 2;
+	case TextureData::RGB:
+		return 3;
+	case TextureData::RGBA:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+static bool isPowerOf2(GLuint value) {
+	return (value & (value - 1)) == 0;
+}
+
+TextureAtlas::TextureAtlas(
+		GLuint pageSize,
+		TextureData::GlFormat glFormat,
+		TextureData::DataType dataType,
+		GLuint gutter)
+	:pageSize{pageSize},
+	 glFormat{glFormat},
+	 dataType{dataType},
+	 gutter{gutter},
+	 cellSize{std::max(gutter,1U)}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.TextureAtlas");
+	}
+#endif
+
+	if (pageSize == 0 || !isPowerOf2(pageSize)) {
+		std::ostringstream os;
+		os << "TextureAtlas: Page size " << pageSize << " is not a power of 2";
+		throw TextureException(os.str().c_str());
+	}
+
+	if (!isPowerOf2(cellSize) || cellSize * 4 > pageSize) {
+		std::ostringstream os;
+		os << "TextureAtlas: Gutter " << gutter << " is not a power of 2 or too large for the page size " << pageSize;
+		throw TextureException(os.str().c_str());
+	}
+}
+
+TextureAtlas::~TextureAtlas() {
+}
+
+TextureAtlas &TextureAtlas::getTextureAtlas() {
+	static TextureAtlas theTextureAtlas;
+
+	return theTextureAtlas;
+}
+
+TextureAtlas::Region TextureAtlas::addImage(TextureData const &image) {
+
+	Region region;
+	GLuint const width = image.getWidth();
+	GLuint const height = image.getHeight();
+
+	// Size of the image with gutters, rounded up to whole cells
+	GLuint const numCellsX = (width + 2 * gutter + cellSize - 1) / cellSize;
+	GLuint const numCellsY = (height + 2 * gutter + cellSize - 1) / cellSize;
+
+	if (!image.getDataPtr()) {
+		throw TextureException("TextureAtlas: Image has no texel data");
+	}
+
+	if (width == 0 || height == 0 || numCellsX * cellSize > pageSize || numCellsY * cellSize > pageSize) {
+		std::ostringstream os;
+		os << "TextureAtlas: Image of " << width << 'x' << height << " texels does not fit into a page of "
+				<< pageSize << 'x' << pageSize;
+		throw TextureException(os.str().c_str());
+	}
+
+	TextureData const padded = padImage(convertImage(image),numCellsX * cellSize,numCellsY * cellSize);
+
+	// Try the existing pages first, the last one is the most likely to have space.
+	unsigned cellX = 0;
+	unsigned cellY = 0;
+	size_t pageNo = pages.size();
+	while (pageNo > 0) {
+		if (pages[pageNo - 1]->packer.insert(numCellsX,numCellsY,cellX,cellY)) {
+			break;
+		}
+		pageNo--;
+	}
+
+	if (pageNo == 0) {
+		Page &page = addPage();
+		page.packer.insert(numCellsX,numCellsY,cellX,cellY);
+		pageNo = pages.size();
+	}
+
+	region.page = unsigned(pageNo - 1);
+	region.x = cellX * cellSize + gutter;
+	region.y = cellY * cellSize + gutter;
+	region.width = width;
+	region.height = height;
+	region.u0 = GLfloat(region.x) / GLfloat(pageSize);
+	region.v0 = GLfloat(region.y) / GLfloat(pageSize);
+	region.u1 = GLfloat(region.x + width) / GLfloat(pageSize);
+	region.v1 = GLfloat(region.y + height) / GLfloat(pageSize);
+
+	pages[region.page]->texture->setTextureSubData(padded,cellX * cellSize,cellY * cellSize);
+
+	LOG4CXX_DEBUG(logger,"Added image of " << width << 'x' << height << " to page " << region.page
+			<< " at " << region.x << ',' << region.y << ". Occupancy is " << getOccupancy());
+
+	return region;
+}
+
+TextureAtlas::Region const &TextureAtlas::getPlaceholderRegion() {
+
+	if (!placeholderRegion.isValid()) {
+		TextureData placeholder {1,1,TextureData::RGBA,TextureData::Byte};
+
+		// Neutral gray like the placeholder of the TextureLoader
+		GLubyte *texel = static_cast<GLubyte*>(placeholder.getDataPtr());
+		texel[0] = 0x80;
+		texel[1] = 0x80;
+		texel[2] = 0x80;
+		texel[3] = 0xff;
+
+		placeholderRegion = addImage(placeholder);
+	}
+
+	return placeholderRegion;
+}
+
+void TextureAtlas::setFilters(GLTexture::TextureFilter minFilter,GLTexture::TextureFilter magFilter) {
+
+	this->minFilter = minFilter;
+	this->magFilter = magFilter;
+
+	for (auto &page : pages) {
+		page->texture->setMinificationFilter(minFilter);
+		page->texture->setMagnificationFilter(magFilter);
+	}
+}
+
+void TextureAtlas::generateMipmaps() {
+
+	for (auto &page : pages) {
+		page->texture->generateMipmap();
+	}
+}
+
+void TextureAtlas::clear() {
+
+	LOG4CXX_DEBUG(logger,"Delete " << pages.size() << " pages");
+
+	pages.clear();
+	placeholderRegion = Region();
+}
+
+float TextureAtlas::getOccupancy() const {
+	unsigned long used = 0;
+
+	if (pages.empty()) {
+		return 0.0f;
+	}
+
+	for (auto const &page : pages) {
+		used += page->packer.getUsedArea();
+	}
+
+	return float(used) * float(cellSize * cellSize) / (float(pageSize) * float(pageSize) * float(pages.size()));
+}
+
+TextureAtlas::Page &TextureAtlas::addPage() {
+
+	std::unique_ptr<Page> page {new Page(pageSize / cellSize)};
+
+	page->texture->setTextureStorage(pageSize,pageSize,glFormat,dataType);
+	page->texture->setMinificationFilter(minFilter);
+	page->texture->setMagnificationFilter(magFilter);
+
+	LOG4CXX_INFO(logger,"Create atlas page #" << pages.size() << " of " << pageSize << 'x' << pageSize << " texels");
+
+	pages.push_back(std::move(page));
+
+	return *pages.back();
+}
+
+TextureData TextureAtlas::convertImage(TextureData const &image) const {
+
+	if (image.getGlFormat() == glFormat && image.getDataType() == dataType) {
+		return image;
+	}
+
+	if (image.getDataType() != TextureData::Byte) {
+		throw TextureException("TextureAtlas: 16 bit images must have the data type of the atlas");
+	}
+
+	if (dataType != TextureData::Byte) {
+		// Packed atlas. The converter accepts RGB and RGBA.
+		return TextureConverter::convert(image,dataType);
+	}
+
+	unsigned const srcChannels = numChannels(image.getGlFormat());
+	unsigned const destChannels = numChannels(glFormat);
+	GLuint const numTexels = image.getWidth() * image.getHeight();
+	TextureData converted {image.getWidth(),image.getHeight(),glFormat,dataType};
+	GLubyte const *src = static_cast<GLubyte const*>(image.getDataPtr());
+	GLubyte *dest = static_cast<GLubyte*>(converted.getDataPtr());
+
+	for (GLuint i = 0; i < numTexels; i++, src += srcChannels, dest += destChannels) {
+		GLubyte rgba[4];
+
+		if (srcChannels <= 2) {
+			rgba[0] = rgba[1] = rgba[2] = src[0];
+			rgba[3] = (srcChannels == 2) ? src[1] : 0xff;
+		} else {
+			rgba[0] = src[0];
+			rgba[1] = src[1];
+			rgba[2] = src[2];
+			rgba[3] = (srcChannels == 4) ? src[3] : 0xff;
+		}
+
+		if (destChannels <= 2) {
+			dest[0] = GLubyte((rgba[0] * 77U + rgba[1] * 150U + rgba[2] * 29U + 128U) >> 8);
+			if (destChannels == 2) {
+				dest[1] = rgba[3];
+			}
+		} else {
+			memcpy(dest,rgba,destChannels);
+		}
+	}
+
+	return converted;
+}
+
+TextureData TextureAtlas::padImage(TextureData const &image,GLuint paddedWidth,GLuint paddedHeight) const {
+
+	GLuint const width = image.getWidth();
+	GLuint const height = image.getHeight();
+	GLuint const bytesPerTexel = image.getDataBufferLength() / (width * height);
+	TextureData padded {paddedWidth,paddedHeight,glFormat,dataType};
+	char const *src = static_cast<char const*>(image.getDataPtr());
+	char *dest = static_cast<char*>(padded.getDataPtr());
+
+	for (GLuint y = 0; y < paddedHeight; y++) {
+		// Rows outside of the image repeat the nearest edge row
+		GLuint const srcY = GLuint(std::min(std::max(int(y) - int(gutter),0),int(height) - 1));
+		char const *srcRow = src + srcY * width * bytesPerTexel;
+		char *destRow = dest + y * paddedWidth * bytesPerTexel;
+		GLuint const rightGutter = paddedWidth - gutter - width;
+
+		for (GLuint x = 0; x < gutter; x++) {
+			memcpy(destRow + x * bytesPerTexel,srcRow,bytesPerTexel);
+		}
+		memcpy(destRow + gutter * bytesPerTexel,srcRow,width * bytesPerTexel);
+		for (GLuint x = 0; x < rightGutter; x++) {
+			memcpy(destRow + (gutter + width + x) * bytesPerTexel,srcRow + (width - 1) * bytesPerTexel,bytesPerTexel);
+		}
+	}
+
+	return padded;
+}
+
+} /* namespace OevGLES */
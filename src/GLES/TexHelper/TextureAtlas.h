@@ -0,0 +1,222 @@
+/*
+ * TextureAtlas.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Packs many images into a few large textures, and hands out their texture coordinates.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef TEXTUREATLAS_H_
+#define TEXTUREATLAS_H_
+
+#include <vector>
+#include <memory>
+
+#include "GLES/TexHelper/TextureData.h"
+#include "GLES/TexHelper/SkylinePacker.h"
+#include "GLES/GLTexture.h"
+
+namespace OevGLES {
+
+/** \brief Texture atlas
+ *
+ * Instrument faces, needles and symbols are small images. When each owns a texture every textured draw binds
+ * another texture, and the draws cannot be combined. The atlas packs the images into a few large textures, the pages.
+ * Renderers use the \ref Region of their image, i.e. the page texture and the texture coordinates within the page.
+ * Draws of images on the same page can be batched.
+ *
+ * Each image is surrounded by a gutter which repeats its edge texels. Thus linear filtering at the edge of the image
+ * behaves like GL_CLAMP_TO_EDGE, and does not pick up the neighbour image.
+ * The images are placed on a grid of the gutter size. When the gutter is 2^n texels wide the mip levels 0..n
+ * do not mix neighbouring images either.
+ * Repeating wrap modes are not possible with atlas images.
+ *
+ * New pages are created when an image does not fit any more. Images are never removed, only all at once with \ref clear().
+ * All methods must be called on the GL thread.
+ */
+class TextureAtlas {
+public:
+
+	/// \brief Location of an image in the atlas
+	struct Region {
+		/// \brief Index of the page, see \ref getPageTexture()
+		unsigned page = 0;
+		/// \brief Rectangle of the image in the page in texels, without the gutter
+		GLuint x = 0;
+		GLuint y = 0;
+		GLuint width = 0;
+		GLuint height = 0;
+		/// \brief Texture coordinates of the lower left and the upper right corner of the image
+		GLfloat u0 = 0.0f;
+		GLfloat v0 = 0.0f;
+		GLfloat u1 = 0.0f;
+		GLfloat v1 = 0.0f;
+
+		/// \brief The region was assigned by an atlas
+		bool isValid() const {
+			return width > 0;
+		}
+
+		/// \brief Map the texture coordinate s of the image (0..1) into the page
+		GLfloat mapS(GLfloat s) const {
+			return u0 + s * (u1 - u0);
+		}
+
+		/// \brief Map the texture coordinate t of the image (0..1) into the page
+		GLfloat mapT(GLfloat t) const {
+			return v0 + t * (v1 - v0);
+		}
+	};
+
+	/** \brief Constructor
+	 *
+	 * Pages are created when the first image is added.
+	 *
+	 * @param pageSize Width and height of the pages in texels. A power of 2.
+	 * @param glFormat Format of the pages
+	 * @param dataType Data type of the pages
+	 * @param gutter Width of the gutter around each image in texels. 0 or a power of 2.
+	 * @throws TextureException for invalid sizes
+	 */
+	TextureAtlas(
+			GLuint pageSize = 1024,
+			TextureData::GlFormat glFormat = TextureData::RGBA,
+			TextureData::DataType dataType = TextureData::Byte,
+			GLuint gutter = 4);
+
+	virtual ~TextureAtlas();
+
+	/** \brief The atlas which is shared by the instruments
+	 *
+	 * Call \ref clear() before the GL context is destroyed.
+	 *
+	 * @return Reference to the shared atlas
+	 */
+	static TextureAtlas &getTextureAtlas();
+
+	/** \brief Add an image, and upload it into its page.
+	 *
+	 * Byte images of any format are converted to the format of the atlas. RGB and RGBA byte images are converted
+	 * to the 16 bit types without dithering; use \ref TextureConverter beforehand for dithering.
+	 * Images of 16 bit types must have the type of the atlas.
+	 *
+	 * @param image The image. It is not used after the call.
+	 * @return Region of the image
+	 * @throws TextureException when the image is larger than a page, or cannot be converted
+	 */
+	Region addImage(TextureData const &image);
+
+	/** \brief Region with a single gray texel, for images which are not loaded yet
+	 *
+	 * @return Region of the placeholder
+	 */
+	Region const &getPlaceholderRegion();
+
+	/// \brief Number of pages
+	unsigned getNumPages() const {
+		return unsigned(pages.size());
+	}
+
+	/** \brief Texture of a page
+	 *
+	 * @param page Index of the page, see \ref Region::page
+	 * @return The texture
+	 */
+	GLTexture &getPageTexture(unsigned page) {
+		return *pages.at(page)->texture;
+	}
+
+	/** \brief Set the filters of all pages, also of pages which are created later.
+	 *
+	 * @param minFilter Minification filter. Mip-map filters require \ref generateMipmaps().
+	 * @param magFilter Magnification filter
+	 */
+	void setFilters(GLTexture::TextureFilter minFilter,GLTexture::TextureFilter magFilter);
+
+	/// \brief Let GL generate the mip-maps of all pages. Call again after images were added.
+	void generateMipmaps();
+
+	/** \brief Delete all pages and images.
+	 *
+	 * Regions which were handed out become invalid.
+	 */
+	void clear();
+
+	/// \brief Ratio of the area covered by images and gutters to the area of all pages
+	float getOccupancy() const;
+
+	GLuint getPageSize() const {
+		return pageSize;
+	}
+
+	/// \brief Data type of the pages. 16 bit images must have this type.
+	TextureData::DataType getDataType() const {
+		return dataType;
+	}
+
+private:
+
+	struct Page {
+		std::unique_ptr<GLTexture> texture;
+		/// \brief Packs in units of the gutter
+		SkylinePacker packer;
+
+		Page(unsigned numCells)
+			:texture{new GLTexture},
+			 packer{numCells,numCells}
+		{}
+	};
+
+	GLuint pageSize;
+	TextureData::GlFormat glFormat;
+	TextureData::DataType dataType;
+	GLuint gutter;
+	/// \brief Images are placed on a grid of this size. It is the gutter width, minimum 1.
+	GLuint cellSize;
+
+	GLTexture::TextureFilter minFilter = GLTexture::Nearest;
+	GLTexture::TextureFilter magFilter = GLTexture::Nearest;
+
+	std::vector<std::unique_ptr<Page>> pages;
+
+	Region placeholderRegion;
+
+	/// \brief Convert an image to the format and data type of the atlas
+	TextureData convertImage(TextureData const &image) const;
+
+	/** \brief Copy the image into a buffer of the placed size, and extrude its edges into the gutter
+	 *
+	 * @param image Image in the format of the atlas
+	 * @param paddedWidth Width of the buffer, a multiple of the cell size
+	 * @param paddedHeight Height of the buffer, a multiple of the cell size
+	 */
+	TextureData padImage(TextureData const &image,GLuint paddedWidth,GLuint paddedHeight) const;
+
+	/// \brief Append a new empty page
+	Page &addPage();
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* TEXTUREATLAS_H_ */
@@ -0,0 +1,375 @@
+/*
+ * TextureConverter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Converts RGB(A) byte textures to packed 16 bit texels, optionally with ordered or error diffusion dithering.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <sstream>
+
+#if defined __ARM_NEON || defined __ARM_NEON__
+#	include <arm_neon.h>
+#	define TEXCONV_USE_NEON 1
+#elif defined __SSE2__
+#	include <emmintrin.h>
+#	define TEXCONV_USE_SSE2 1
+#endif
+
+#include "GLES/TexHelper/TextureConverter.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+/// \brief 4x4 Bayer matrix. The ranks 0..15 become rounding biases between 8 and 247.
+static unsigned const bayerMatrix[4][4] = {
+		{ 0, 8, 2,10},
+		{12, 4,14, 6},
+		{ 3,11, 1, 9},
+		{15, 7,13, 5}
+};
+
+/// \brief Bias for rounding to the nearest value
+static uint16_t const roundingBias[4] = {127,127,127,127};
+
+TextureConverter::TextureConverter(
+		unsigned width,
+		unsigned srcChannels,
+		TextureData::DataType targetType,
+		Dithering dithering)
+	:width{width},
+	 srcChannels{srcChannels},
+	 targetType{targetType},
+	 dithering{dithering}
+{
+
+	if (srcChannels != 3 && srcChannels != 4) {
+		std::ostringstream os;
+		os << "TextureConverter: Source texels must have 3 or 4 channels, not " << srcChannels;
+		throw TextureException(os.str().c_str());
+	}
+
+	switch (targetType) {
+	case TextureData::Short565:
+		maxR = 31; maxG = 63; maxB = 31; maxA = 0;
+		shiftR = 11; shiftG = 5; shiftB = 0;
+		break;
+
+	case TextureData::Short4444:
+		maxR = 15; maxG = 15; maxB = 15; maxA = 15;
+		shiftR = 12; shiftG = 8; shiftB = 4;
+		break;
+
+	case TextureData::Short5551:
+		maxR = 31; maxG = 31; maxB = 31; maxA = 1;
+		shiftR = 11; shiftG = 6; shiftB = 1;
+		break;
+
+	default:
+		{
+			std::ostringstream os;
+			os << "TextureConverter: Target data type 0x" << std::hex << targetType << " is not a packed 16 bit type";
+			throw TextureException(os.str().c_str());
+		}
+	}
+
+	if (dithering == FloydSteinberg) {
+		errorCurr.assign((width + 2) * 3,0);
+		errorNext.assign((width + 2) * 3,0);
+	}
+
+}
+
+TextureConverter::~TextureConverter() {}
+
+void TextureConverter::convertRow(uint8_t const *src,uint16_t *dest) {
+
+	switch (dithering) {
+	case OrderedDithering:
+		{
+			uint16_t bias[4];
+			for (unsigned i = 0; i < 4; i++) {
+				bias[i] = uint16_t(((2 * bayerMatrix[rowNo & 3][i] + 1) * 255 + 16) / 32);
+			}
+			unsigned const start = convertRowSimd(src,dest,bias);
+			convertRowScalar(src,dest,start,bias);
+		}
+		break;
+
+	case FloydSteinberg:
+		convertRowErrorDiffusion(src,dest);
+		break;
+
+	default:
+		{
+			unsigned const start = convertRowSimd(src,dest,roundingBias);
+			convertRowScalar(src,dest,start,roundingBias);
+		}
+	}
+
+	rowNo++;
+}
+
+TextureData TextureConverter::convert(TextureData const &source,TextureData::DataType targetType,Dithering dithering) {
+
+	unsigned srcChannels;
+	// Channels of a luminance source. Its rows are expanded to RGB or RGBA before the conversion.
+	unsigned grayChannels = 0;
+
+	if (source.getDataType() != TextureData::Byte || !source.getDataPtr()) {
+		throw TextureException("TextureConverter: Source texture must have byte channels");
+	}
+
+	switch (source.getGlFormat()) {
+	case TextureData::Luminance:
+		grayChannels = 1;
+		srcChannels = 3;
+		break;
+	case TextureData::LuminanceA:
+		grayChannels = 2;
+		srcChannels = 4;
+		break;
+	case TextureData::RGB:
+		srcChannels = 3;
+		break;
+	case TextureData::RGBA:
+		srcChannels = 4;
+		break;
+	default:
+		throw TextureException("TextureConverter: Source texture must be Luminance, LuminanceA, RGB or RGBA");
+	}
+
+	GLuint const width = source.getWidth();
+	GLuint const height = source.getHeight();
+	TextureConverter converter(width,srcChannels,targetType,dithering);
+	TextureData target(width,height,getTargetFormat(targetType),targetType);
+	std::vector<uint8_t> expandedRow (grayChannels ? width * srcChannels : 0);
+
+	uint8_t const *srcData = static_cast<uint8_t const*>(source.getDataPtr());
+	uint16_t *destData = static_cast<uint16_t*>(target.getDataPtr());
+
+	// Rows are stored bottom to top
+	for (GLuint i = height; i > 0; i--) {
+		uint8_t const *srcRow = srcData + (i - 1) * width * (grayChannels ? grayChannels : srcChannels);
+
+		if (grayChannels) {
+			for (GLuint x = 0; x < width; x++) {
+				uint8_t *texel = &expandedRow[x * srcChannels];
+				texel[0] = texel[1] = texel[2] = srcRow[x * grayChannels];
+				if (grayChannels == 2) {
+					texel[3] = srcRow[x * 2 + 1];
+				}
+			}
+			srcRow = expandedRow.data();
+		}
+
+		converter.convertRow(srcRow,destData + (i - 1) * width);
+	}
+
+	return target;
+}
+
+TextureData::GlFormat TextureConverter::getTargetFormat(TextureData::DataType targetType) {
+
+	if (targetType == TextureData::Short565) {
+		return TextureData::RGB;
+	}
+
+	return TextureData::RGBA;
+}
+
+void TextureConverter::convertRowScalar(uint8_t const *src,uint16_t *dest,unsigned start,uint16_t const bias[4]) {
+
+	src += start * srcChannels;
+
+	for (unsigned i = start; i < width; i++, src += srcChannels) {
+		unsigned const b = bias[i & 3];
+		unsigned const alpha = (srcChannels == 4) ? (src[3] * maxA + 127U) / 255U : maxA;
+
+		dest[i] = uint16_t(
+				(((src[0] * maxR + b) / 255U) << shiftR) |
+				(((src[1] * maxG + b) / 255U) << shiftG) |
+				(((src[2] * maxB + b) / 255U) << shiftB) |
+				alpha);
+	}
+
+}
+
+#if defined TEXCONV_USE_NEON
+
+/// \brief Exact division by 255 of values up to 255*255
+static inline uint16x8_t div255(uint16x8_t x) {
+	return vshrq_n_u16(vaddq_u16(vaddq_u16(x,vdupq_n_u16(1)),vshrq_n_u16(x,8)),8);
+}
+
+unsigned TextureConverter::convertRowSimd(uint8_t const *src,uint16_t *dest,uint16_t const bias[4]) {
+
+	unsigned const n = width & ~7U;
+	uint16_t const biasLanes[8] = {bias[0],bias[1],bias[2],bias[3],bias[0],bias[1],bias[2],bias[3]};
+	uint16x8_t const biasVec = vld1q_u16(biasLanes);
+	uint16x8_t const alphaBias = vdupq_n_u16(127);
+	uint8x8_t const mulR = vdup_n_u8(uint8_t(maxR));
+	uint8x8_t const mulG = vdup_n_u8(uint8_t(maxG));
+	uint8x8_t const mulB = vdup_n_u8(uint8_t(maxB));
+	uint8x8_t const mulA = vdup_n_u8(uint8_t(maxA));
+	int16x8_t const shR = vdupq_n_s16(int16_t(shiftR));
+	int16x8_t const shG = vdupq_n_s16(int16_t(shiftG));
+	int16x8_t const shB = vdupq_n_s16(int16_t(shiftB));
+
+	for (unsigned i = 0; i < n; i += 8) {
+		uint8x8_t r,g,b;
+		uint16x8_t a;
+
+		if (srcChannels == 4) {
+			uint8x8x4_t const texels = vld4_u8(src + i * 4);
+			r = texels.val[0];
+			g = texels.val[1];
+			b = texels.val[2];
+			a = div255(vaddq_u16(vmull_u8(texels.val[3],mulA),alphaBias));
+		} else {
+			uint8x8x3_t const texels = vld3_u8(src + i * 3);
+			r = texels.val[0];
+			g = texels.val[1];
+			b = texels.val[2];
+			a = vdupq_n_u16(uint16_t(maxA));
+		}
+
+		uint16x8_t texel = vshlq_u16(div255(vaddq_u16(vmull_u8(r,mulR),biasVec)),shR);
+		texel = vorrq_u16(texel,vshlq_u16(div255(vaddq_u16(vmull_u8(g,mulG),biasVec)),shG));
+		texel = vorrq_u16(texel,vshlq_u16(div255(vaddq_u16(vmull_u8(b,mulB),biasVec)),shB));
+		texel = vorrq_u16(texel,a);
+
+		vst1q_u16(dest + i,texel);
+	}
+
+	return n;
+}
+
+#elif defined TEXCONV_USE_SSE2
+
+/// \brief Exact division by 255 of values up to 255*255
+static inline __m128i div255(__m128i x) {
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x,_mm_set1_epi16(1)),_mm_srli_epi16(x,8)),8);
+}
+
+/// \brief Channel \p c of 8 RGB texels. SSE2 has no byte shuffle, therefore the channels are gathered.
+static inline __m128i gatherChannel(uint8_t const *src,unsigned c) {
+	return _mm_setr_epi16(
+			src[c],src[c + 3],src[c + 6],src[c + 9],
+			src[c + 12],src[c + 15],src[c + 18],src[c + 21]);
+}
+
+unsigned TextureConverter::convertRowSimd(uint8_t const *src,uint16_t *dest,uint16_t const bias[4]) {
+
+	unsigned const n = width & ~7U;
+	__m128i const biasVec = _mm_setr_epi16(
+			short(bias[0]),short(bias[1]),short(bias[2]),short(bias[3]),
+			short(bias[0]),short(bias[1]),short(bias[2]),short(bias[3]));
+	__m128i const alphaBias = _mm_set1_epi16(127);
+	__m128i const byteMask = _mm_set1_epi32(0xff);
+	__m128i const mulR = _mm_set1_epi16(short(maxR));
+	__m128i const mulG = _mm_set1_epi16(short(maxG));
+	__m128i const mulB = _mm_set1_epi16(short(maxB));
+	__m128i const mulA = _mm_set1_epi16(short(maxA));
+	__m128i const shR = _mm_cvtsi32_si128(int(shiftR));
+	__m128i const shG = _mm_cvtsi32_si128(int(shiftG));
+	__m128i const shB = _mm_cvtsi32_si128(int(shiftB));
+
+	for (unsigned i = 0; i < n; i += 8) {
+		__m128i r,g,b,a;
+
+		if (srcChannels == 4) {
+			// 4 texels per register, one channel per byte of each 32 bit lane
+			__m128i const t0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i * 4));
+			__m128i const t1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i * 4 + 16));
+			r = _mm_packs_epi32(_mm_and_si128(t0,byteMask),_mm_and_si128(t1,byteMask));
+			g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(t0,8),byteMask),_mm_and_si128(_mm_srli_epi32(t1,8),byteMask));
+			b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(t0,16),byteMask),_mm_and_si128(_mm_srli_epi32(t1,16),byteMask));
+			a = _mm_packs_epi32(_mm_srli_epi32(t0,24),_mm_srli_epi32(t1,24));
+			a = div255(_mm_add_epi16(_mm_mullo_epi16(a,mulA),alphaBias));
+		} else {
+			uint8_t const *texels = src + i * 3;
+			r = gatherChannel(texels,0);
+			g = gatherChannel(texels,1);
+			b = gatherChannel(texels,2);
+			a = mulA;
+		}
+
+		__m128i texel = _mm_sll_epi16(div255(_mm_add_epi16(_mm_mullo_epi16(r,mulR),biasVec)),shR);
+		texel = _mm_or_si128(texel,_mm_sll_epi16(div255(_mm_add_epi16(_mm_mullo_epi16(g,mulG),biasVec)),shG));
+		texel = _mm_or_si128(texel,_mm_sll_epi16(div255(_mm_add_epi16(_mm_mullo_epi16(b,mulB),biasVec)),shB));
+		texel = _mm_or_si128(texel,a);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),texel);
+	}
+
+	return n;
+}
+
+#else
+
+unsigned TextureConverter::convertRowSimd(uint8_t const *,uint16_t *,uint16_t const [4]) {
+	return 0;
+}
+
+#endif
+
+void TextureConverter::convertRowErrorDiffusion(uint8_t const *src,uint16_t *dest) {
+
+	unsigned const maxC[3] = {maxR,maxG,maxB};
+	unsigned const shiftC[3] = {shiftR,shiftG,shiftB};
+
+	std::fill(errorNext.begin(),errorNext.end(),0);
+
+	for (unsigned i = 0; i < width; i++, src += srcChannels) {
+		unsigned texel = (srcChannels == 4) ? (src[3] * maxA + 127U) / 255U : maxA;
+		// Error index of this texel. Index 0 is the margin left of the row
+		unsigned const e = (i + 1) * 3;
+
+		for (unsigned c = 0; c < 3; c++) {
+			int const value = std::min(std::max(int(src[c]) + ((errorCurr[e + c] + 8) >> 4),0),255);
+			unsigned const quant = (unsigned(value) * maxC[c] + 127U) / 255U;
+			int const err = value - int((quant * 255U + maxC[c] / 2U) / maxC[c]);
+
+			// Floyd-Steinberg weights 7/16 right, 3/16 below left, 5/16 below, 1/16 below right
+			errorCurr[e + 3 + c] += err * 7;
+			errorNext[e - 3 + c] += err * 3;
+			errorNext[e + c]     += err * 5;
+			errorNext[e + 3 + c] += err;
+
+			texel |= quant << shiftC[c];
+		}
+
+		dest[i] = uint16_t(texel);
+	}
+
+	errorCurr.swap(errorNext);
+
+}
+
+} /* namespace OevGLES */
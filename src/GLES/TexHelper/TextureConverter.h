@@ -0,0 +1,147 @@
+/*
+ * TextureConverter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Converts RGB(A) byte textures to packed 16 bit texels, optionally with ordered or error diffusion dithering.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef TEXTURECONVERTER_H_
+#define TEXTURECONVERTER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "GLES/TexHelper/TextureData.h"
+
+namespace OevGLES {
+
+/** \brief Conversion of 8 bit RGB and RGBA texels to the packed formats 5-6-5, 4-4-4-4 and 5-5-5-1
+ *
+ * The packed formats halve the texture memory and the bandwidth of the GPU.
+ * To hide the banding of the reduced color depth the conversion can dither the color channels:
+ * - Ordered dithering with a 4x4 Bayer matrix. Fast, the pattern is stable, and does not crawl when only parts of the image change.
+ * - Floyd-Steinberg error diffusion. Best quality for smooth gradients, but cannot be vectorized.
+ *
+ * Alpha is never dithered, it is rounded.
+ *
+ * The conversion works row by row, thus it can be applied while an image is decoded.
+ * Rows must be passed from the top of the image to the bottom. Without dithering and with ordered dithering
+ * the rows are converted with NEON or SSE2 where available.
+ */
+class TextureConverter {
+public:
+
+	enum Dithering {
+		NoDithering,
+		OrderedDithering,
+		FloydSteinberg
+	};
+
+	/** \brief Constructor
+	 *
+	 * @param width Width of the rows in texels
+	 * @param srcChannels Bytes per source texel, 3 for RGB, 4 for RGBA. The alpha of RGBA is ignored for Short565.
+	 *                    RGB becomes opaque for formats with alpha.
+	 * @param targetType Short565, Short4444 or Short5551
+	 * @param dithering Dithering of the color channels
+	 * @throws TextureException for other channel counts or data types
+	 */
+	TextureConverter(
+			unsigned width,
+			unsigned srcChannels,
+			TextureData::DataType targetType,
+			Dithering dithering = NoDithering);
+
+	virtual ~TextureConverter();
+
+	/** \brief Convert the next row.
+	 *
+	 * @param src Source texels, width * srcChannels bytes
+	 * @param dest Packed texels, width values
+	 */
+	void convertRow(uint8_t const *src,uint16_t *dest);
+
+	/** \brief Convert a complete texture
+	 *
+	 * The rows of TextureData are stored bottom to top. The dithering runs from the top of the image.
+	 *
+	 * @param source Luminance, LuminanceA, RGB or RGBA texture with Byte channels. Luminance is expanded to RGB.
+	 * @param targetType Short565, Short4444 or Short5551
+	 * @param dithering Dithering of the color channels
+	 * @return Converted texture. Format is RGB for Short565, RGBA otherwise.
+	 * @throws TextureException for unsupported formats
+	 */
+	static TextureData convert(TextureData const &source,TextureData::DataType targetType,Dithering dithering = NoDithering);
+
+	/// \brief GL format of a packed data type, RGB for Short565, RGBA for the others
+	static TextureData::GlFormat getTargetFormat(TextureData::DataType targetType);
+
+private:
+
+	unsigned width;
+	unsigned srcChannels;
+	TextureData::DataType targetType;
+	Dithering dithering;
+
+	/// \brief Maximum value of the color channels and of alpha in the target format
+	unsigned maxR;
+	unsigned maxG;
+	unsigned maxB;
+	unsigned maxA;
+
+	/// \brief Bit positions of the channels in the target texel
+	unsigned shiftR;
+	unsigned shiftG;
+	unsigned shiftB;
+
+	/// \brief Number of the current row, selects the row of the dither matrix
+	unsigned rowNo = 0;
+
+	/** \brief Accumulated errors of Floyd-Steinberg for the current and the next row
+	 *
+	 * Three channels per texel, with one texel margin on each side. In units of 1/16.
+	 */
+	std::vector<int32_t> errorCurr;
+	std::vector<int32_t> errorNext;
+
+	/** \brief Convert the texels [start,width) of a row with a constant bias per column
+	 *
+	 * @param bias Rounding bias of the color channels of each column modulo 4. 127 rounds to the nearest value.
+	 */
+	void convertRowScalar(uint8_t const *src,uint16_t *dest,unsigned start,uint16_t const bias[4]);
+
+	/** \brief Convert the texels [0,n) of a row with SIMD instructions, n is a multiple of 8.
+	 *
+	 * @return n. 0 when no SIMD implementation is available.
+	 */
+	unsigned convertRowSimd(uint8_t const *src,uint16_t *dest,uint16_t const bias[4]);
+
+	/// \brief Floyd-Steinberg error diffusion of a row
+	void convertRowErrorDiffusion(uint8_t const *src,uint16_t *dest);
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* TEXTURECONVERTER_H_ */
@@ -120,6 +120,43 @@ TextureData::TextureData( TextureData const &source)
 
 }
 
+TextureData::TextureData( TextureData &&source) noexcept
+	: width{source.width},
+	  height{source.height},
+	  glFormat{source.glFormat},
+	  dataType{source.dataType},
+	  data{source.data},
+	  lenData{source.lenData},
+	  bytesPerTexel{source.bytesPerTexel}
+{
+	source.width = 0;
+	source.height = 0;
+	source.data = 0;
+	source.lenData = 0;
+}
+
+TextureData &TextureData::operator = ( TextureData &&source) noexcept {
+
+	if (this != &source) {
+		delete [] data;
+
+		width = source.width;
+		height = source.height;
+		glFormat = source.glFormat;
+		dataType = source.dataType;
+		data = source.data;
+		lenData = source.lenData;
+		bytesPerTexel = source.bytesPerTexel;
+
+		source.width = 0;
+		source.height = 0;
+		source.data = 0;
+		source.lenData = 0;
+	}
+
+	return *this;
+}
+
 void *TextureData::getDataPtr() {
 
 	if (!data) {
@@ -97,6 +97,23 @@ public:
 	 */
 	TextureData( TextureData const &source);
 
+	/** \brief Move constructor
+	 *
+	 * Takes over the data buffer of the source without copying. The source is left without buffer and dimensions.
+	 *
+	 * @param source Source buffer object.
+	 */
+	TextureData( TextureData &&source) noexcept;
+
+	/** \brief Move assignment
+	 *
+	 * Releases the own buffer, and takes over the data buffer of the source without copying.
+	 *
+	 * @param source Source buffer object.
+	 * @return This object
+	 */
+	TextureData &operator = ( TextureData &&source) noexcept;
+
 	/** \brief destructor
 	 *
 	 * Deletes the internal buffer.
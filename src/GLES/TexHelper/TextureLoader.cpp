@@ -0,0 +1,425 @@
+/*
+ * TextureLoader.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Loads textures in the background. Decodes on worker threads, and uploads on the GL thread within a time budget.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <cstring>
+
+#include "OVFCommon.h"
+
+#include "GLES/TexHelper/TextureLoader.h"
+#include "GLES/TexHelper/CompressedTextureFile.h"
+#include "GLES/TexHelper/Etc1Codec.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+TextureLoader::TextureLoader()
+	:placeholder {1,1,TextureData::RGBA,TextureData::Byte}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.TextureLoader");
+	}
+#endif
+
+	// Neutral gray. It does not flash on dark nor on bright backgrounds.
+	GLubyte *texel = static_cast<GLubyte*>(placeholder.getDataPtr());
+	texel[0] = 0x80;
+	texel[1] = 0x80;
+	texel[2] = 0x80;
+	texel[3] = 0xff;
+}
+
+TextureLoader::~TextureLoader() {
+	// Join the workers before the members which decode() uses are destroyed.
+	workerPool.reset();
+}
+
+TextureLoader &TextureLoader::getTextureLoader() {
+	static TextureLoader theTextureLoader;
+
+	return theTextureLoader;
+}
+
+void TextureLoader::loadTexture(GLTexture &texture,char const *fileName,LoadedCallback onLoaded,
+		PngReader::OutputFormat outputFormat,
+		TextureConverter::Dithering dithering,
+		bool generateMipMaps) {
+	RequestPtr request {new Request};
+
+	request->texture = &texture;
+	request->generateMipMaps = generateMipMaps;
+	request->fileName = fileName;
+	request->outputFormat = outputFormat;
+	request->dithering = dithering;
+	request->onLoaded = std::move(onLoaded);
+
+	texture.setTextureData(placeholder);
+
+	queueRequest(std::move(request));
+}
+
+void TextureLoader::loadIntoAtlas(TextureAtlas &atlas,TextureAtlas::Region &region,char const *fileName,LoadedCallback onLoaded,
+		PngReader::OutputFormat outputFormat,
+		TextureConverter::Dithering dithering) {
+	RequestPtr request {new Request};
+
+	request->atlas = &atlas;
+	request->region = &region;
+	request->fileName = fileName;
+	request->outputFormat = outputFormat;
+	request->dithering = dithering;
+	request->onLoaded = std::move(onLoaded);
+
+	region = atlas.getPlaceholderRegion();
+
+	queueRequest(std::move(request));
+}
+
+/// \brief Packed data type of an output format, or undefType for Native
+static TextureData::DataType getPackedDataType(PngReader::OutputFormat outputFormat) {
+
+	switch (outputFormat) {
+	case PngReader::RGB565:
+		return TextureData::Short565;
+	case PngReader::RGBA4444:
+		return TextureData::Short4444;
+	case PngReader::RGBA5551:
+		return TextureData::Short5551;
+	default:
+		return TextureData::undefType;
+	}
+}
+
+/// \brief Can the texture of the pack be used as it is instead of decoding the file?
+static bool isPackEntryUsable(AssetPack::Entry const &entry,PngReader::OutputFormat outputFormat,
+		bool generateMipMaps,TextureAtlas const *atlas,bool etc1Supported) {
+	TextureData::DataType const dataType = TextureData::DataType(entry.dataType);
+
+	switch (entry.type) {
+	case AssetPack::CompressedTexture:
+		return !atlas && etc1Supported && entry.glFormat == GL_ETC1_RGB8_OES;
+	case AssetPack::Texture:
+		if (generateMipMaps && entry.numLevels < 2) {
+			return false;
+		}
+		// The atlas converts byte images, but not images of another 16 bit type
+		if (atlas && dataType != TextureData::Byte && dataType != atlas->getDataType()) {
+			return false;
+		}
+		return outputFormat == PngReader::Native || dataType == getPackedDataType(outputFormat);
+	default:
+		return false;
+	}
+}
+
+void TextureLoader::queueRequest(RequestPtr request) {
+
+	if (!workerPool) {
+		workerPool.reset(new OevUtils::WorkerPool(numThreads));
+	}
+
+	if (etc1Supported < 0) {
+		etc1Supported = GLTexture::isCompressedFormatSupported(GL_ETC1_RGB8_OES) ? 1 : 0;
+		LOG4CXX_INFO(logger,"ETC1 textures are " << (etc1Supported ? "supported" : "not supported. They are decoded."));
+	}
+	request->etc1Supported = etc1Supported != 0;
+
+	// Precooked textures of the asset pack skip the workers. They are uploaded from the mapping.
+	AssetPack::Entry const *packEntry = AssetPack::getAssetPack().findEntry(request->fileName.c_str());
+	if (packEntry && isPackEntryUsable(*packEntry,request->outputFormat,request->generateMipMaps,
+			request->atlas,request->etc1Supported)) {
+		LOG4CXX_DEBUG(logger,"Load " << request->fileName << " from the asset pack");
+		request->packEntry = packEntry;
+
+		// The atlas pads and converts the image anyway. Copy it while the pages of the mapping are warm.
+		if (request->atlas) {
+			std::unique_ptr<TextureData> textureData {new TextureData(packEntry->width,packEntry->height,
+					TextureData::GlFormat(packEntry->glFormat),TextureData::DataType(packEntry->dataType))};
+			// The buffer is allocated by getDataPtr(). Before that the buffer length is 0.
+			void *texels = textureData->getDataPtr();
+			memcpy(texels,AssetPack::getAssetPack().getLevelData(*packEntry),
+					std::min<size_t>(textureData->getDataBufferLength(),AssetPack::getLevelSize(*packEntry,0)));
+			request->textureData = std::move(textureData);
+		}
+
+		pending.push_back(request);
+		{
+			std::lock_guard<std::mutex> lock(decodedMutex);
+
+			decoded.push_back(std::move(request));
+		}
+		decodedAvailable.notify_one();
+		return;
+	}
+
+	LOG4CXX_DEBUG(logger,"Queue " << request->fileName << " for decoding");
+
+	pending.push_back(request);
+	workerPool->submit([this,request] {
+		decode(request);
+	});
+}
+
+void TextureLoader::decodeWithoutPack(RequestPtr request) {
+
+	request->packEntry = nullptr;
+	request->textureData.reset();
+
+	pending.push_back(request);
+	workerPool->submit([this,request] {
+		decode(request);
+	});
+}
+
+void TextureLoader::cancel(GLTexture &texture) {
+	cancelTarget(&texture);
+}
+
+void TextureLoader::cancel(TextureAtlas::Region &region) {
+	cancelTarget(&region);
+}
+
+void TextureLoader::cancelTarget(void const *target) {
+
+	for (auto it = pending.begin(); it != pending.end();) {
+		if ((*it)->texture == target || (*it)->region == target) {
+			LOG4CXX_DEBUG(logger,"Cancel loading " << (*it)->fileName);
+			// The worker may still decode it. The result is discarded when it arrives.
+			(*it)->cancelled = true;
+			it = pending.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void TextureLoader::decode(RequestPtr request) {
+
+	try {
+		if (CompressedTextureFile::isCompressedTextureFile(request->fileName)) {
+			decodeCompressed(*request);
+		} else {
+			decodePng(*request);
+		}
+	} catch (std::exception const &e) {
+		request->errorText = e.what();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(decodedMutex);
+
+		decoded.push_back(std::move(request));
+	}
+	decodedAvailable.notify_one();
+}
+
+void TextureLoader::decodePng(Request &request) {
+
+	PngReader reader (request.fileName.c_str());
+	std::unique_ptr<TextureData> textureData {new TextureData(8,8,TextureData::RGB,TextureData::Byte)};
+	TextureData::DataType const packedType = getPackedDataType(request.outputFormat);
+
+	if (!request.generateMipMaps) {
+		reader.readPngToTexture(*textureData,request.outputFormat,request.dithering);
+		request.textureData = std::move(textureData);
+		return;
+	}
+
+	// The levels are filtered in bytes, and converted to the 16 bit formats afterwards
+	reader.readPngToTexture(*textureData);
+	request.mipLevels = mipMapGenerator.createMipChain(*textureData);
+
+	if (packedType != TextureData::undefType) {
+		*textureData = TextureConverter::convert(*textureData,packedType,request.dithering);
+		for (auto &level : request.mipLevels) {
+			level = TextureConverter::convert(level,packedType,request.dithering);
+		}
+	}
+
+	request.textureData = std::move(textureData);
+}
+
+void TextureLoader::decodeCompressed(Request &request) {
+
+	std::unique_ptr<CompressedTextureData> compressedData {new CompressedTextureData};
+
+	CompressedTextureFile::read(request.fileName,*compressedData);
+
+	// Other compressed formats than ETC1 cannot be decoded. They are uploaded, and GL decides.
+	if (request.texture && (request.etc1Supported || compressedData->getGlInternalFormat() != GL_ETC1_RGB8_OES)) {
+		request.compressedData = std::move(compressedData);
+		return;
+	}
+
+	std::unique_ptr<TextureData> textureData {new TextureData(Etc1Codec::decode(*compressedData))};
+	TextureData::DataType const packedType = getPackedDataType(request.outputFormat);
+
+	if (packedType != TextureData::undefType) {
+		*textureData = TextureConverter::convert(*textureData,packedType,request.dithering);
+	}
+
+	request.textureData = std::move(textureData);
+}
+
+TextureLoader::RequestPtr TextureLoader::popDecoded(bool wait) {
+	std::unique_lock<std::mutex> lock(decodedMutex);
+	RequestPtr request;
+
+	if (wait) {
+		decodedAvailable.wait(lock,[this] {
+			return !decoded.empty();
+		});
+	}
+
+	if (!decoded.empty()) {
+		request = std::move(decoded.front());
+		decoded.pop_front();
+	}
+
+	return request;
+}
+
+void TextureLoader::upload(Request &request) {
+	auto const it = std::find_if(pending.begin(),pending.end(),[&request] (RequestPtr const &p) {
+		return p.get() == &request;
+	});
+	// Keeps the request when it goes back to the workers
+	RequestPtr const requestPtr = *it;
+
+	pending.erase(it);
+
+	if (request.packEntry && !request.atlas) {
+		try {
+			AssetPack::getAssetPack().uploadTexture(*request.packEntry,*request.texture);
+		} catch (std::exception const &e) {
+			LOG4CXX_WARN(logger,"Cannot upload texture " << request.fileName << " from the asset pack: " << e.what()
+					<< ". Decode the file.");
+			decodeWithoutPack(requestPtr);
+			return;
+		}
+
+		LOG4CXX_DEBUG(logger,"Uploaded " << request.fileName << " from the asset pack, "
+				<< request.packEntry->width << 'x' << request.packEntry->height);
+	} else if (!request.textureData && !request.compressedData) {
+		LOG4CXX_ERROR(logger,"Cannot load texture " << request.fileName << ": " << request.errorText);
+		numFailures++;
+		return;
+	} else if (request.compressedData) {
+		request.texture->setCompressedTextureData(*request.compressedData);
+
+		LOG4CXX_DEBUG(logger,"Uploaded compressed " << request.fileName << ", "
+				<< request.compressedData->getWidth() << 'x' << request.compressedData->getHeight());
+	} else {
+		if (request.atlas) {
+			try {
+				*request.region = request.atlas->addImage(*request.textureData);
+			} catch (std::exception const &e) {
+				if (request.packEntry) {
+					LOG4CXX_WARN(logger,"Cannot add texture " << request.fileName << " from the asset pack to the atlas: "
+							<< e.what() << ". Decode the file.");
+					decodeWithoutPack(requestPtr);
+					return;
+				}
+				LOG4CXX_ERROR(logger,"Cannot add texture " << request.fileName << " to the atlas: " << e.what());
+				numFailures++;
+				return;
+			}
+		} else {
+			request.texture->setTextureData(*request.textureData);
+
+			for (size_t i = 0; i < request.mipLevels.size(); i++) {
+				request.texture->setTextureData(request.mipLevels[i],GLint(i + 1));
+			}
+		}
+
+		LOG4CXX_DEBUG(logger,"Uploaded " << request.fileName << ", "
+				<< request.textureData->getWidth() << 'x' << request.textureData->getHeight());
+	}
+	numUploads++;
+
+	// Release the buffers before the callback, it may start other loads.
+	request.textureData.reset();
+	request.compressedData.reset();
+	request.mipLevels.clear();
+
+	if (request.onLoaded) {
+		request.onLoaded();
+	}
+}
+
+unsigned TextureLoader::processUploads(std::chrono::microseconds budget) {
+	auto const start = std::chrono::steady_clock::now();
+	unsigned numUploaded = 0;
+
+	while (!pending.empty()) {
+		RequestPtr const request = popDecoded(false);
+
+		if (!request) {
+			break;
+		}
+
+		if (request->cancelled) {
+			continue;
+		}
+
+		upload(*request);
+		numUploaded++;
+
+		if (std::chrono::steady_clock::now() - start >= budget) {
+			break;
+		}
+	}
+
+	return numUploaded;
+}
+
+void TextureLoader::finishAll() {
+
+	while (!pending.empty()) {
+		RequestPtr const request = popDecoded(true);
+
+		if (!request->cancelled) {
+			upload(*request);
+		}
+	}
+
+	// Drop the results of cancelled requests which arrived in the meantime
+	while (popDecoded(false)) {
+	}
+}
+
+} /* namespace OevGLES */
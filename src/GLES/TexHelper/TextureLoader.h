@@ -0,0 +1,269 @@
+/*
+ * TextureLoader.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Loads textures in the background. Decodes on worker threads, and uploads on the GL thread within a time budget.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef TEXTURELOADER_H_
+#define TEXTURELOADER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+#include "GLES/TexHelper/TextureData.h"
+#include "GLES/TexHelper/PngReader.h"
+#include "GLES/TexHelper/TextureAtlas.h"
+#include "GLES/TexHelper/CompressedTextureData.h"
+#include "GLES/TexHelper/MipMapGenerator.h"
+#include "GLES/GLTexture.h"
+#include "GLES/AssetPack.h"
+#include "Utils/WorkerPool.h"
+
+namespace OevGLES {
+
+/** \brief Asynchronous texture loader
+ *
+ * \ref loadTexture() binds a small placeholder image to the texture immediately, and queues decoding of the image
+ * file to a pool of worker threads. The render loop calls \ref processUploads() once per frame on the GL thread.
+ * It uploads the decoded images into their textures until the time budget of the frame is used up.
+ * Thus neither file I/O and decoding nor a burst of uploads delays a frame.
+ *
+ * When the upload is done an optional callback is called on the GL thread, e.g. to mark the renderer dirty.
+ * When decoding fails the error is logged, and the texture keeps the placeholder.
+ *
+ * Besides PNG the loader reads ETC1 textures from KTX and PKM files, see \ref CompressedTextureFile.
+ * They are uploaded compressed when the GPU supports ETC1. Otherwise, and for atlas regions, they are decoded to RGB.
+ *
+ * When the \ref AssetPack is open, and contains the file name in the requested format, the texture is not decoded.
+ * It is uploaded from the mapped pack, again within the time budget. Keep the pack open until the loads are done.
+ *
+ * Except for the worker threads all methods must be called on the GL thread.
+ * There is only one loader in the program which is obtained with \ref getTextureLoader().
+ */
+class TextureLoader {
+public:
+
+	typedef std::function<void()> LoadedCallback;
+
+	/** \brief Return the only instance of the loader
+	 *
+	 * @return Reference to the loader
+	 */
+	static TextureLoader &getTextureLoader();
+
+	/** \brief Set the number of decoder threads
+	 *
+	 * Only effective before the first call of \ref loadTexture(). Default 0 uses all hardware threads except one.
+	 *
+	 * @param numThreads Number of threads
+	 */
+	void setNumThreads(unsigned numThreads) {
+		this->numThreads = numThreads;
+	}
+
+	/** \brief Set the generator of the mip-maps
+	 *
+	 * Only effective before the first call of \ref loadTexture(). Default is Kaiser in linear light.
+	 *
+	 * @param generator The generator
+	 */
+	void setMipMapGenerator(MipMapGenerator const &generator) {
+		mipMapGenerator = generator;
+	}
+
+	/** \brief Bind the placeholder to the texture, and start loading the image.
+	 *
+	 * @param texture The texture. Must stay valid until the image is uploaded, or until \ref cancel() is called.
+	 * @param fileName Path of the PNG, KTX or PKM file
+	 * @param onLoaded Optional callback which is called on the GL thread after the upload.
+	 * @param outputFormat Texel format of the texture. The 16 bit formats halve the memory of the decoded image.
+	 *                     Compressed textures keep their format unless they must be decoded.
+	 * @param dithering Dithering for the 16 bit formats. Gradients and anti-aliased edges need it to avoid banding.
+	 * @param generateMipMaps Create the mip-map chain of PNG images on the worker thread, and upload all levels.
+	 *                        Set a mip-map minification filter on the texture to use them.
+	 */
+	void loadTexture(GLTexture &texture,char const *fileName,LoadedCallback onLoaded = nullptr,
+			PngReader::OutputFormat outputFormat = PngReader::Native,
+			TextureConverter::Dithering dithering = TextureConverter::NoDithering,
+			bool generateMipMaps = false);
+
+	/** \brief Assign the placeholder region of the atlas to the region, and start loading the image into the atlas.
+	 *
+	 * When the image is decoded it is added to the atlas, and the region is updated. The texture coordinates
+	 * of the renderer usually change then. Update them in the callback.
+	 *
+	 * @param atlas The atlas. Must stay valid until the image is uploaded.
+	 * @param region Receives the region of the image. Must stay valid until the image is uploaded, or until \ref cancel() is called.
+	 * @param fileName Path of the PNG, KTX or PKM file
+	 * @param onLoaded Optional callback which is called on the GL thread after the upload.
+	 * @param outputFormat Texel format of the decoded image. It is converted to the format of the atlas when it differs.
+	 * @param dithering Dithering for the 16 bit formats
+	 */
+	void loadIntoAtlas(TextureAtlas &atlas,TextureAtlas::Region &region,char const *fileName,LoadedCallback onLoaded = nullptr,
+			PngReader::OutputFormat outputFormat = PngReader::Native,
+			TextureConverter::Dithering dithering = TextureConverter::NoDithering);
+
+	/** \brief Discard all pending loads of a texture, e.g. before it is destroyed.
+	 *
+	 * @param texture The texture
+	 */
+	void cancel(GLTexture &texture);
+
+	/** \brief Discard all pending loads into an atlas region.
+	 *
+	 * @param region The region which was passed to \ref loadIntoAtlas()
+	 */
+	void cancel(TextureAtlas::Region &region);
+
+	/** \brief Upload decoded images on the GL thread.
+	 *
+	 * At least one image is uploaded when one is ready, even when it takes longer than the budget.
+	 *
+	 * @param budget Time after which no further upload is started
+	 * @return Number of uploaded images
+	 */
+	unsigned processUploads(std::chrono::microseconds budget);
+
+	/** \brief Wait until all pending images are decoded, and upload them.
+	 *
+	 * For start-up, tests and benchmarks which need the complete textures.
+	 */
+	void finishAll();
+
+	/// \brief Number of textures which were requested, but are not uploaded yet
+	size_t getNumPending() const {
+		return pending.size();
+	}
+
+	/// \brief Number of uploaded images since the start
+	unsigned getNumUploads() const {
+		return numUploads;
+	}
+
+	/// \brief Number of images which could not be decoded
+	unsigned getNumFailures() const {
+		return numFailures;
+	}
+
+private:
+
+	/// \brief One texture to be loaded
+	struct Request {
+		/// \brief Target texture, or nullptr when the image goes into an atlas
+		GLTexture *texture = nullptr;
+		TextureAtlas *atlas = nullptr;
+		TextureAtlas::Region *region = nullptr;
+		std::string fileName;
+		PngReader::OutputFormat outputFormat;
+		TextureConverter::Dithering dithering;
+		LoadedCallback onLoaded;
+		/// \brief The GPU can sample ETC1. Determined on the GL thread when the request is created.
+		bool etc1Supported = false;
+		/// \brief Result of the decoder. Empty when decoding failed, or when the compressed texture is uploaded as it is.
+		std::unique_ptr<TextureData> textureData;
+		/// \brief Compressed texture which is uploaded without decoding
+		std::unique_ptr<CompressedTextureData> compressedData;
+		/// \brief Precooked texture in the \ref AssetPack which is uploaded from the mapping
+		AssetPack::Entry const *packEntry = nullptr;
+		bool generateMipMaps = false;
+		/// \brief Mip levels 1..n when \ref generateMipMaps is set
+		std::vector<TextureData> mipLevels;
+		/// \brief Message of the decoder exception
+		std::string errorText;
+		/// \brief Set by \ref cancel(). Only accessed by the GL thread.
+		bool cancelled = false;
+	};
+
+	typedef std::shared_ptr<Request> RequestPtr;
+
+	TextureLoader();
+	~TextureLoader();
+
+	unsigned numThreads = 0;
+
+	/// \brief Created at the first load. The destructor stops it first because the workers use the members below.
+	std::unique_ptr<OevUtils::WorkerPool> workerPool;
+
+	/// \brief Requests which are not uploaded yet. Only accessed by the GL thread.
+	std::vector<RequestPtr> pending;
+
+	/// \brief Requests which are decoded, and wait for the upload
+	std::deque<RequestPtr> decoded;
+	std::mutex decodedMutex;
+	std::condition_variable decodedAvailable;
+
+	/// \brief Image which is bound to the textures until the real image arrives
+	TextureData placeholder;
+
+	MipMapGenerator mipMapGenerator;
+
+	/// \brief Support of ETC1 by the GPU. -1 until it was queried.
+	int etc1Supported = -1;
+
+	unsigned numUploads = 0;
+	unsigned numFailures = 0;
+
+	/// \brief Read a PNG file, and create the mip-maps when requested. Runs on a worker thread.
+	void decodePng(Request &request);
+
+	/// \brief Read a KTX or PKM file, and decode it when it cannot be uploaded compressed. Runs on a worker thread.
+	void decodeCompressed(Request &request);
+
+	/// \brief Add the request to \ref pending, and queue it for decoding
+	void queueRequest(RequestPtr request);
+
+	/// \brief Cancel the pending requests which load into the texture or region \p target
+	void cancelTarget(void const *target);
+
+	/// \brief Decode the image of a request. Runs on a worker thread.
+	void decode(RequestPtr request);
+
+	/** \brief Take the next decoded request from the queue.
+	 *
+	 * @param wait Wait for the next decoded request
+	 * @return The request, or an empty pointer when no request is decoded
+	 */
+	RequestPtr popDecoded(bool wait);
+
+	/// \brief Upload the image of a decoded request, and remove it from \ref pending
+	void upload(Request &request);
+
+	/** \brief Decode the file of a request whose asset pack entry could not be used
+	 *
+	 * The request is added to \ref pending again, and queued for the workers.
+	 */
+	void decodeWithoutPack(RequestPtr request);
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* TEXTURELOADER_H_ */
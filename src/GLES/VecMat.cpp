@@ -54,10 +54,7 @@ Mat4 translationMatrix (GLfloat x, GLfloat y, GLfloat z ) {
 
 	initLogger();
 
-	rc << 	1.0f, 0.0f, 0.0f, x,
-			0.0f, 1.0f, 0.0f, y,
-			0.0f, 0.0f, 1.0f, z,
-			0.0f, 0.0f, 0.0f, 1.0f;
+	translationMatrix(rc,x,y,z);
 
 	LOG4CXX_DEBUG(logger,"translationMatrix (x = " << x << ", y " << y << ", z = " << z << ") =\n" << rc );
 
@@ -81,11 +78,91 @@ Mat4 scalingMatrix (GLfloat x, GLfloat y, GLfloat z ) {
 
 Mat4 rotationMatrixX (GLfloat adX) {
 	Mat4 rc;
-	GLfloat sinX = sinf(adX/180.0*M_PI);
-	GLfloat cosX = cosf(adX/180.0*M_PI);
 
 	initLogger();
 
+	rotationMatrixX(rc,adX);
+
+	LOG4CXX_DEBUG(logger,"rotationMatrixX (adX = " << adX << ") =\n" << rc );
+
+	return rc;
+}
+
+Mat4 rotationMatrixY (GLfloat adY) {
+	Mat4 rc;
+
+	initLogger();
+
+	rotationMatrixY(rc,adY);
+
+	LOG4CXX_DEBUG(logger,"rotationMatrixY (adY = " << adY << ") =\n" << rc );
+
+	return rc;
+}
+
+Mat4 rotationMatrixZ (GLfloat adZ) {
+	Mat4 rc;
+
+	initLogger();
+
+	rotationMatrixZ(rc,adZ);
+
+	LOG4CXX_DEBUG(logger,"rotationMatrixZ (adZ = " << adZ << ") =\n" << rc );
+
+	return rc;
+}
+
+Mat4 viewMatrix (Vec3 const& camPos, Vec3 const &lookAt, Vec3 const & up) {
+	Mat4 rc;
+
+	initLogger();
+
+	viewMatrix(rc,camPos,lookAt,up);
+
+	LOG4CXX_DEBUG(logger,"viewMatrix (camPos = " << camPos.transpose() << ", lookAt = " << lookAt.transpose() << ", up = " << up.transpose() << ")" );
+	LOG4CXX_DEBUG(logger,"viewMatrix: rc = \n" << rc);
+	return rc;
+}
+
+Mat4 projectionMatrix (GLfloat near, GLfloat far, GLfloat aspect, GLfloat fieldOfViewAngle) {
+	Mat4 rc;
+
+	initLogger();
+
+	projectionMatrix(rc,near,far,aspect,fieldOfViewAngle);
+
+	LOG4CXX_DEBUG(logger,"projectionMatrix (near = " << near << ", far = " << far << ", aspect = " << aspect << ", fieldOfViewAngle = " << fieldOfViewAngle << ")" );
+	LOG4CXX_DEBUG(logger,"projectionMatrix = \n" << rc);
+
+	return rc;
+
+}
+
+void sinCosDeg (GLfloat angleDeg, GLfloat &sinA, GLfloat &cosA) {
+	GLfloat const angleRad = angleDeg/180.0*M_PI;
+
+#if defined HAVE_SINCOSF
+	sincosf(angleRad,&sinA,&cosA);
+#else
+	sinA = sinf(angleRad);
+	cosA = cosf(angleRad);
+#endif
+}
+
+void translationMatrix (Mat4 &rc, GLfloat x, GLfloat y, GLfloat z ) {
+
+	rc << 	1.0f, 0.0f, 0.0f, x,
+			0.0f, 1.0f, 0.0f, y,
+			0.0f, 0.0f, 1.0f, z,
+			0.0f, 0.0f, 0.0f, 1.0f;
+
+}
+
+void rotationMatrixX (Mat4 &rc, GLfloat adX) {
+	GLfloat sinX;
+	GLfloat cosX;
+
+	sinCosDeg(adX,sinX,cosX);
 
 	/*
 	 * 		1		0		0		0
@@ -99,18 +176,13 @@ Mat4 rotationMatrixX (GLfloat adX) {
 			0.0f,	sinX,	cosX,	0.0f,
 			0.0f,	0.0f,	0.0f,	1.0f;
 
-	LOG4CXX_DEBUG(logger,"rotationMatrixX (adX = " << adX << ") =\n" << rc );
-
-	return rc;
 }
 
-Mat4 rotationMatrixY (GLfloat adY) {
-	Mat4 rc;
-	GLfloat sinY = sinf(adY/180.0*M_PI);
-	GLfloat cosY = cosf(adY/180.0*M_PI);
-
-	initLogger();
+void rotationMatrixY (Mat4 &rc, GLfloat adY) {
+	GLfloat sinY;
+	GLfloat cosY;
 
+	sinCosDeg(adY,sinY,cosY);
 
 	/*
 	 * 		cos(θ)	0		sin(θ)	0
@@ -124,18 +196,13 @@ Mat4 rotationMatrixY (GLfloat adY) {
 		   -sinY,	0.0f,	cosY,	0.0f,
 			0.0f,	0.0f,	0.0f,	1.0f;
 
-	LOG4CXX_DEBUG(logger,"rotationMatrixY (adY = " << adY << ") =\n" << rc );
-
-	return rc;
 }
 
-Mat4 rotationMatrixZ (GLfloat adZ) {
-	Mat4 rc;
-	GLfloat sinZ = sinf(adZ/180.0*M_PI);
-	GLfloat cosZ = cosf(adZ/180.0*M_PI);
-
-	initLogger();
+void rotationMatrixZ (Mat4 &rc, GLfloat adZ) {
+	GLfloat sinZ;
+	GLfloat cosZ;
 
+	sinCosDeg(adZ,sinZ,cosZ);
 
 	/*
 	 * 		cos(θ)	−sin(θ)	0		0
@@ -149,19 +216,41 @@ Mat4 rotationMatrixZ (GLfloat adZ) {
 			0.0f,	0.0f,	1.0f,	0.0f,
 			0.0f,	0.0f,	0.0f,	1.0f;
 
-	LOG4CXX_DEBUG(logger,"rotationMatrixZ (adZ = " << adZ << ") =\n" << rc );
+}
+
+void rotationZTranslationMatrix (Mat4 &rc, GLfloat adZ, GLfloat x, GLfloat y, GLfloat z) {
+	GLfloat sinZ;
+	GLfloat cosZ;
+
+	sinCosDeg(adZ,sinZ,cosZ);
+
+	// The translation matrix only adds the translation column to the rotation
+	rc <<	cosZ,	-sinZ,	0.0f,	x,
+			sinZ,	cosZ,	0.0f,	y,
+			0.0f,	0.0f,	1.0f,	z,
+			0.0f,	0.0f,	0.0f,	1.0f;
 
-	return rc;
 }
 
-Mat4 viewMatrix (Vec3 const& camPos, Vec3 const &lookAt, Vec3 const & up) {
-	Mat4 rc;
+void multiplyRotationZ (Mat4 &m, GLfloat adZ) {
+	GLfloat sinZ;
+	GLfloat cosZ;
+
+	sinCosDeg(adZ,sinZ,cosZ);
+
+	// Columns 2 and 3 of the rotation are unit vectors, and leave the columns 2 and 3 of m unchanged.
+	Vec4 const col0 = m.col(0);
+	Vec4 const col1 = m.col(1);
+
+	m.col(0) = col0 * cosZ + col1 * sinZ;
+	m.col(1) = col1 * cosZ - col0 * sinZ;
+
+}
+
+void viewMatrix (Mat4 &rc, Vec3 const& camPos, Vec3 const &lookAt, Vec3 const & up) {
 	Vec3 forwardVec = (lookAt - camPos).normalized();
 	Vec3 rightVec = (forwardVec.cross(up.normalized())).normalized();
 	Vec3 myUp = (rightVec.cross(forwardVec)).normalized();
-	Mat4 R,T;
-
-	initLogger();
 
 	/*
 	 *
@@ -173,31 +262,17 @@ Mat4 viewMatrix (Vec3 const& camPos, Vec3 const &lookAt, Vec3 const & up) {
 	 * Where U is a vector pointing up, F forward, and P is world position of camera
 	 * R is the right vector. This is the cross product of
 	 *
+	 * The last column is the rotation R applied to −P, i.e. the product R * T is not needed.
 	 */
 
-	R << 	rightVec(0),	rightVec(1),	rightVec(2),	0.0f,
-			myUp(0),		myUp(1),		myUp(2),		0.0f,
-			-forwardVec(0),	-forwardVec(1),	-forwardVec(2),	0.0f,
+	rc << 	rightVec(0),	rightVec(1),	rightVec(2),	-rightVec.dot(camPos),
+			myUp(0),		myUp(1),		myUp(2),		-myUp.dot(camPos),
+			-forwardVec(0),	-forwardVec(1),	-forwardVec(2),	forwardVec.dot(camPos),
 			0.0f,			0.0f,			0.0f,			1.0f;
 
-	T << 	1.0f,	0.0f,	0.0f,	-camPos(0),
-			0.0f,	1.0f,	0.0f,	-camPos(1),
-			0.0f,	0.0f,	1.0f,	-camPos(2),
-			0.0f,	0.0f,	0.0f,	1.0f;
-
-	rc = R * T;
-
-	LOG4CXX_DEBUG(logger,"viewMatrix (camPos = " << camPos.transpose() << ", lookAt = " << lookAt.transpose() << ", up = " << up.transpose() << ")" );
-	LOG4CXX_DEBUG(logger,"viewMatrix: forwardVec = " << forwardVec.transpose());
-	LOG4CXX_DEBUG(logger,"viewMatrix: rightVec = " << rightVec.transpose());
-	LOG4CXX_DEBUG(logger,"viewMatrix: myUp = " << myUp.transpose());
-	LOG4CXX_DEBUG(logger,"viewMatrix: R = \n" << R);
-	LOG4CXX_DEBUG(logger,"viewMatrix: T = \n" << T);
-	LOG4CXX_DEBUG(logger,"viewMatrix: rc = \n" << rc);
-	return rc;
 }
 
-Mat4 projectionMatrix (GLfloat near, GLfloat far, GLfloat aspect, GLfloat fieldOfViewAngle) {
+void projectionMatrix (Mat4 &rc, GLfloat near, GLfloat far, GLfloat aspect, GLfloat fieldOfViewAngle) {
 	/*
 	 *
 	 * range = tan(fov/2) ∗ near
@@ -214,26 +289,17 @@ Mat4 projectionMatrix (GLfloat near, GLfloat far, GLfloat aspect, GLfloat fieldO
 	 * }
 	 */
 
-	Mat4 rc;
 	GLfloat range  = tanf((fieldOfViewAngle / 180.0 * M_PI) / 2.0f) * near;
 	GLfloat Sx = (2.0f * near) / (range * aspect + range * aspect);
 	GLfloat Sy = near / range;
 	GLfloat Sz = -(far + near) / (far - near);
 	GLfloat Pz = -(2.0f * far * near) / (far - near);
 
-	initLogger();
-
 	rc <<	Sx,		0.0f,	0.0f,	0.0f,
 			0.0f,	Sy,		0.0f,	0.0f,
 			0.0f,	0.0f,	Sz,		Pz,
 			0.0f,	0.0f,	-1.0f,	0.0f;
 
-	LOG4CXX_DEBUG(logger,"projectionMatrix (near = " << near << ", far = " << far << ", aspect = " << aspect << ", fieldOfViewAngle = " << fieldOfViewAngle << ")" );
-	LOG4CXX_DEBUG(logger,"projectionMatrix: range = " << range);
-	LOG4CXX_DEBUG(logger,"projectionMatrix = \n" << rc);
-
-	return rc;
-
 }
 
 
@@ -34,6 +34,14 @@
 
 #include "Eigen"
 
+#if defined __ARM_NEON || defined __ARM_NEON__
+#	include <arm_neon.h>
+#	define VECMAT_USE_NEON 1
+#elif defined __SSE__
+#	include <xmmintrin.h>
+#	define VECMAT_USE_SSE 1
+#endif
+
 namespace OevGLES {
 
 // vector and matrix type definitions like in OpenGL
@@ -46,6 +54,8 @@ typedef Eigen::Matrix<GLfloat,2,2> Mat2;
 typedef Eigen::Matrix<GLfloat,3,3> Mat3;
 typedef Eigen::Matrix<GLfloat,4,4> Mat4;
 
+static_assert(!Mat4::IsRowMajor,"multiplyMat4 expects column major matrices");
+
 /** \brief Constructs and returns a translation matrix
  *
  * \see <a href="http://antongerdelan.net/teaching/3dprog1/maths_cheat_sheet.pdf" >Dr Anton Gerdelan's 3d Math cheat sheet</a>
@@ -118,6 +128,158 @@ Mat4 viewMatrix (Vec3 const& camPos, Vec3 const &lookAt, Vec3 const & up);
  */
 Mat4 projectionMatrix (GLfloat near, GLfloat far, GLfloat aspect, GLfloat fieldOfViewAngle);
 
+/*
+ * In-place variants of the matrix builders.
+ *
+ * They write into storage of the caller instead of returning a temporary matrix, and do not log.
+ * Use them in the render loop where the matrices are re-computed for every instrument in every frame.
+ * The results are identical to the functions above.
+ */
+
+/** \brief Sine and cosine of an angle in degrees, evaluated in one call
+ *
+ * @param[in] angleDeg Angle in degrees
+ * @param[out] sinA Sine of the angle
+ * @param[out] cosA Cosine of the angle
+ */
+void sinCosDeg (GLfloat angleDeg, GLfloat &sinA, GLfloat &cosA);
+
+/** \brief Writes a translation matrix into rc
+ *
+ * \see translationMatrix (GLfloat,GLfloat,GLfloat)
+ */
+void translationMatrix (Mat4 &rc, GLfloat x, GLfloat y, GLfloat z );
+
+/** \brief Writes a rotation matrix around the X axis into rc
+ *
+ * \see rotationMatrixX (GLfloat)
+ */
+void rotationMatrixX (Mat4 &rc, GLfloat adX);
+
+/** \brief Writes a rotation matrix around the Y axis into rc
+ *
+ * \see rotationMatrixY (GLfloat)
+ */
+void rotationMatrixY (Mat4 &rc, GLfloat adY);
+
+/** \brief Writes a rotation matrix around the Z axis into rc
+ *
+ * \see rotationMatrixZ (GLfloat)
+ */
+void rotationMatrixZ (Mat4 &rc, GLfloat adZ);
+
+/** \brief Writes a combined rotation around the Z axis and translation into rc
+ *
+ * Same as translationMatrix(x,y,z) * rotationMatrixZ(adZ), i.e. the object is rotated first, and moved afterwards.
+ * No matrix multiplication is involved.
+ *
+ * @param[out] rc Result matrix
+ * @param adZ Angle in Degrees around the Z-Axis
+ * @param x Shift by x
+ * @param y Shift by y
+ * @param z Shift by z
+ */
+void rotationZTranslationMatrix (Mat4 &rc, GLfloat adZ, GLfloat x, GLfloat y, GLfloat z);
+
+/** \brief Rotate a model matrix around its local Z axis in place
+ *
+ * Same as m = m * rotationMatrixZ(adZ), but only the first two columns are re-computed.
+ * Typically used for needles which are rotated around their mounting point.
+ *
+ * @param[in,out] m Matrix which is multiplied with the rotation
+ * @param adZ Angle in Degrees around the Z-Axis
+ */
+void multiplyRotationZ (Mat4 &m, GLfloat adZ);
+
+/** \brief Writes the View matrix of a virtual camera into rc
+ *
+ * \see viewMatrix (Vec3 const&,Vec3 const&,Vec3 const&)
+ */
+void viewMatrix (Mat4 &rc, Vec3 const& camPos, Vec3 const &lookAt, Vec3 const & up);
+
+/** \brief Writes a projection matrix into rc
+ *
+ * \see projectionMatrix (GLfloat,GLfloat,GLfloat,GLfloat)
+ */
+void projectionMatrix (Mat4 &rc, GLfloat near, GLfloat far, GLfloat aspect, GLfloat fieldOfViewAngle);
+
+/** \brief Multiply two 4x4 matrices: rc = a * b
+ *
+ * Uses NEON on ARM and SSE on x86 when the compiler targets them, and a plain loop otherwise.
+ * Inline because it is called for every object in every frame.
+ * rc may be the same object as a or b.
+ *
+ * @param[out] rc Product
+ * @param a Left matrix
+ * @param b Right matrix
+ */
+inline void multiplyMat4 (Mat4 &rc, Mat4 const &a, Mat4 const &b) {
+	GLfloat const *pa = a.data();
+	GLfloat const *pb = b.data();
+	GLfloat *pr = rc.data();
+
+	/*
+	 * Column major storage: Column j of the product is the sum of the columns of a,
+	 * weighted with the elements of column j of b.
+	 * All columns of a, and column j of b are loaded before column j of the product is stored.
+	 * Therefore rc can be a or b.
+	 */
+
+#if defined VECMAT_USE_NEON
+	float32x4_t const a0 = vld1q_f32(pa);
+	float32x4_t const a1 = vld1q_f32(pa + 4);
+	float32x4_t const a2 = vld1q_f32(pa + 8);
+	float32x4_t const a3 = vld1q_f32(pa + 12);
+
+	for (int j = 0; j < 4; j++) {
+		float32x4_t const bj = vld1q_f32(pb + 4 * j);
+		float32x4_t r;
+
+		r = vmulq_lane_f32(a0,vget_low_f32(bj),0);
+		r = vmlaq_lane_f32(r,a1,vget_low_f32(bj),1);
+		r = vmlaq_lane_f32(r,a2,vget_high_f32(bj),0);
+		r = vmlaq_lane_f32(r,a3,vget_high_f32(bj),1);
+
+		vst1q_f32(pr + 4 * j,r);
+	}
+#elif defined VECMAT_USE_SSE
+	__m128 const a0 = _mm_loadu_ps(pa);
+	__m128 const a1 = _mm_loadu_ps(pa + 4);
+	__m128 const a2 = _mm_loadu_ps(pa + 8);
+	__m128 const a3 = _mm_loadu_ps(pa + 12);
+
+	for (int j = 0; j < 4; j++) {
+		__m128 const bj = _mm_loadu_ps(pb + 4 * j);
+		__m128 r;
+
+		r = _mm_mul_ps(a0,_mm_shuffle_ps(bj,bj,_MM_SHUFFLE(0,0,0,0)));
+		r = _mm_add_ps(r,_mm_mul_ps(a1,_mm_shuffle_ps(bj,bj,_MM_SHUFFLE(1,1,1,1))));
+		r = _mm_add_ps(r,_mm_mul_ps(a2,_mm_shuffle_ps(bj,bj,_MM_SHUFFLE(2,2,2,2))));
+		r = _mm_add_ps(r,_mm_mul_ps(a3,_mm_shuffle_ps(bj,bj,_MM_SHUFFLE(3,3,3,3))));
+
+		_mm_storeu_ps(pr + 4 * j,r);
+	}
+#else
+	GLfloat aCopy[16];
+
+	for (int i = 0; i < 16; i++) {
+		aCopy[i] = pa[i];
+	}
+
+	for (int j = 0; j < 4; j++) {
+		GLfloat const b0 = pb[4 * j];
+		GLfloat const b1 = pb[4 * j + 1];
+		GLfloat const b2 = pb[4 * j + 2];
+		GLfloat const b3 = pb[4 * j + 3];
+
+		for (int i = 0; i < 4; i++) {
+			pr[4 * j + i] = aCopy[i] * b0 + aCopy[4 + i] * b1 + aCopy[8 + i] * b2 + aCopy[12 + i] * b3;
+		}
+	}
+#endif
+
+}
+
 }
 
 #endif /* VECMAT_H_ */
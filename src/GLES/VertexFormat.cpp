@@ -0,0 +1,196 @@
+/*
+ * VertexFormat.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Descriptor of the layout of interleaved vertex attributes in a buffer
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "OVFCommon.h"
+
+#include "GLES/VertexFormat.h"
+#include "GLES/ExceptionBase.h"
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+namespace OevGLES {
+
+/// \brief Offset alignment of the elements, and of the stride
+static GLuint const elementAlignment = 4;
+
+/// \brief Round and clamp a value to an integer type
+template <typename T>
+static inline T convertInteger(GLfloat value,GLfloat minValue,GLfloat maxValue) {
+	return T(lrintf(std::max(minValue,std::min(maxValue,value))));
+}
+
+VertexFormat::VertexFormat(std::initializer_list<Element> elements)
+	:elements {elements}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.VertexFormat");
+	}
+#endif
+
+	GLuint offset = 0;
+	bool const halfFloatSupported = isHalfFloatSupported();
+
+	for (auto &e : this->elements) {
+		if (e.numComponents < 1 || e.numComponents > 4) {
+			throw VertexFormatException("VertexFormat: An attribute must have 1 to 4 components");
+		}
+
+		if (e.type == HalfFloat && !halfFloatSupported) {
+			LOG4CXX_DEBUG(logger,"OES_vertex_half_float is not supported. Attribute " << e.attribute << " is stored as float.");
+			e.type = Float;
+		}
+
+		e.offset = offset;
+		offset += (e.numComponents * getComponentSize(e.type) + elementAlignment - 1) / elementAlignment * elementAlignment;
+	}
+
+	stride = GLsizei(offset);
+}
+
+void VertexFormat::writeElement(void *vertex,size_t element,GLfloat const *values) const {
+	Element const &e = elements.at(element);
+	uint8_t *dest = static_cast<uint8_t*>(vertex) + e.offset;
+
+	for (GLint i = 0; i < e.numComponents; i++) {
+		GLfloat const value = values[i];
+
+		switch (e.type) {
+		case Float:
+			memcpy(dest + i * sizeof(GLfloat),&value,sizeof(GLfloat));
+			break;
+
+		case HalfFloat: {
+			GLushort const half = floatToHalf(value);
+			memcpy(dest + i * sizeof(GLushort),&half,sizeof(GLushort));
+			break;
+		}
+
+		case Short: {
+			GLshort const s = e.normalized ? convertInteger<GLshort>(value * 32767.0f,-32767.0f,32767.0f) :
+					convertInteger<GLshort>(value,-32768.0f,32767.0f);
+			memcpy(dest + i * sizeof(GLshort),&s,sizeof(GLshort));
+			break;
+		}
+
+		case UnsignedShort: {
+			GLushort const s = e.normalized ? convertInteger<GLushort>(value * 65535.0f,0.0f,65535.0f) :
+					convertInteger<GLushort>(value,0.0f,65535.0f);
+			memcpy(dest + i * sizeof(GLushort),&s,sizeof(GLushort));
+			break;
+		}
+
+		case Byte:
+			reinterpret_cast<GLbyte*>(dest)[i] = e.normalized ? convertInteger<GLbyte>(value * 127.0f,-127.0f,127.0f) :
+					convertInteger<GLbyte>(value,-128.0f,127.0f);
+			break;
+
+		case UnsignedByte:
+			dest[i] = e.normalized ? convertInteger<GLubyte>(value * 255.0f,0.0f,255.0f) :
+					convertInteger<GLubyte>(value,0.0f,255.0f);
+			break;
+		}
+	}
+}
+
+bool VertexFormat::isHalfFloatSupported() {
+	static bool queried = false;
+	static bool supported = false;
+
+	if (!queried) {
+		char const *extensions = reinterpret_cast<char const *>(glGetString(GL_EXTENSIONS));
+
+		// Without a current context the question is asked again later
+		if (extensions) {
+			queried = true;
+			supported = strstr(extensions,"GL_OES_vertex_half_float") != nullptr;
+		}
+	}
+
+	return supported;
+}
+
+GLushort VertexFormat::floatToHalf(GLfloat value) {
+	uint32_t bits;
+
+	memcpy(&bits,&value,sizeof(bits));
+
+	uint32_t const sign = (bits >> 16) & 0x8000;
+	uint32_t const floatExponent = (bits >> 23) & 0xff;
+	int32_t const exponent = int32_t(floatExponent) - 127 + 15;
+	uint32_t const mantissa = bits & 0x7fffff;
+
+	if (floatExponent == 0xff) {
+		// Infinite, or NaN
+		return GLushort(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+	}
+	if (exponent <= 0) {
+		return GLushort(sign);
+	}
+	if (exponent >= 31) {
+		return GLushort(sign | 0x7c00);
+	}
+
+	uint32_t half = sign | (uint32_t(exponent) << 10) | (mantissa >> 13);
+
+	// Round to nearest even. A carry into the exponent is correct, and becomes infinite beyond the largest value.
+	uint32_t const rest = mantissa & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+		half++;
+	}
+
+	return GLushort(half);
+}
+
+GLuint VertexFormat::getComponentSize(ComponentType type) {
+
+	switch (type) {
+	case Float:
+		return sizeof(GLfloat);
+	case HalfFloat:
+	case Short:
+	case UnsignedShort:
+		return sizeof(GLshort);
+	default:
+		return sizeof(GLbyte);
+	}
+}
+
+} /* namespace OevGLES */
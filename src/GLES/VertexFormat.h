@@ -0,0 +1,179 @@
+/*
+ * VertexFormat.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Descriptor of the layout of interleaved vertex attributes in a buffer
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+
+#ifndef GLES_VERTEXFORMAT_H_
+#define GLES_VERTEXFORMAT_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include "GLES/GLStateCache.h"
+
+namespace OevGLES {
+
+/** \brief Layout of interleaved vertex attributes in a buffer
+ *
+ * A renderer declares the attributes of its vertexes once, each with the number of components,
+ * the component type, and whether integer components are normalized. The format computes offsets and stride,
+ * converts float values into the components with \ref writeElement(), and sets up the attribute pointers
+ * with \ref setupAttributes().
+ *
+ * Smaller vertexes save vertex fetch bandwidth, which is scarce on the vertex processor of the Mali-400. Useful choices are
+ * - Positions as \ref HalfFloat with OES_vertex_half_float, 6 instead of 12 bytes. Exact for small integers and halves.
+ * - Packed normals as 3 normalized \ref Byte, 4 bytes with the padding. Precise to about 1/2 degree.
+ * - Texture coordinates as 2 normalized \ref UnsignedShort. Exact to 1/64 texel of a 1024 texel atlas.
+ *   Half floats are too coarse for texture coordinates in an atlas.
+ *
+ * Each element starts at a multiple of 4 bytes, which GLES2 GPUs fetch fastest.
+ * When the GPU does not support OES_vertex_half_float \ref HalfFloat elements are stored as \ref Float.
+ * Therefore construct a format with half floats only when the GL context is current.
+ *
+ * Attributes which are not in the buffer keep their constant values, see \ref GLStateCache::vertexAttrib4fv().
+ */
+class VertexFormat {
+public:
+
+	/// \brief Types of the components of an attribute. Enums correspond with the GL constants.
+	enum ComponentType {
+		Float			= GL_FLOAT,
+		HalfFloat		= GL_HALF_FLOAT_OES,
+		Short			= GL_SHORT,
+		UnsignedShort	= GL_UNSIGNED_SHORT,
+		Byte			= GL_BYTE,
+		UnsignedByte	= GL_UNSIGNED_BYTE
+	};
+
+	/// \brief One attribute in the vertex
+	struct Element {
+		/// \brief The attribute in the Attribute enumeration of the program, e.g. GLProgDiffuseLight::vertexPos
+		unsigned attribute;
+		/// \brief Number of components, 1..4. Missing components are 0, and w is 1, in the shader.
+		GLint numComponents;
+		ComponentType type;
+		/** \brief Integer components are mapped to -1..1 for signed types, or 0..1 for unsigned types.
+		 * Else the integer values are passed to the shader.
+		 */
+		bool normalized;
+		/// \brief Offset from the start of the vertex in bytes. Computed by the format.
+		GLuint offset = 0;
+	};
+
+	/// \brief Empty format. Assign a format before use.
+	VertexFormat() {}
+
+	/** \brief Constructor
+	 *
+	 * @param elements The attributes in the order of the vertex. The offsets are ignored.
+	 */
+	VertexFormat(std::initializer_list<Element> elements);
+
+	/// \brief Size of a vertex in bytes, and distance between the vertexes in the buffer
+	GLsizei getStride() const {
+		return stride;
+	}
+
+	size_t getNumElements() const {
+		return elements.size();
+	}
+
+	/// \brief Element with the final type and the offset
+	Element const &getElement(size_t element) const {
+		return elements.at(element);
+	}
+
+	/** \brief Convert float values into the components of an element of a vertex
+	 *
+	 * Normalized values are clamped to the range of the type, others are rounded and clamped.
+	 *
+	 * @param vertex Start of the vertex in the buffer
+	 * @param element Index of the element
+	 * @param values Values of the components, as many as the element has
+	 */
+	void writeElement(void *vertex,size_t element,GLfloat const *values) const;
+
+	/** \brief Enable the vertex attribute arrays of the elements, and set the attribute pointers
+	 *
+	 * The vertex buffer must be bound.
+	 *
+	 * @tparam Program Program derived from \ref GLProgInterface, which declares the attributes
+	 * @param program The program. It need not be in use.
+	 * @param bufferOffset Offset of the first vertex in the buffer
+	 */
+	template <class Program>
+	void setupAttributes(Program const &program,GLintptr bufferOffset = 0) const {
+		for (auto const &e : elements) {
+			setupAttribute(program.getAttributeLocation(typename Program::Attribute(e.attribute)),e,bufferOffset);
+		}
+	}
+
+	/** \brief Enable the attribute array, and set the pointer of one element
+	 *
+	 * @param location Location of the attribute in the program
+	 * @param element The element
+	 * @param bufferOffset Offset of the first vertex in the buffer
+	 */
+	void setupAttribute(GLint location,Element const &element,GLintptr bufferOffset) const {
+		GLStateCache::getStateCache().enableVertexAttribArray(location);
+		glVertexAttribPointer(location,element.numComponents,element.type,element.normalized ? GL_TRUE : GL_FALSE,stride,
+				reinterpret_cast<GLvoid const *>(bufferOffset + element.offset));
+	}
+
+	/** \brief Does the GPU support \ref HalfFloat attributes?
+	 *
+	 * @return true when OES_vertex_half_float is supported. false when not, or when no GL context is current.
+	 */
+	static bool isHalfFloatSupported();
+
+	/** \brief Convert a float to the IEEE 754 half precision format
+	 *
+	 * Rounds to the nearest value. Values beyond the range become infinite. Denormals are flushed to 0.
+	 *
+	 * @param value The value
+	 * @return The half float bits
+	 */
+	static GLushort floatToHalf(GLfloat value);
+
+	/// \brief Size of a component of the type in bytes
+	static GLuint getComponentSize(ComponentType type);
+
+private:
+
+	std::vector<Element> elements;
+	GLsizei stride = 0;
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLES_VERTEXFORMAT_H_ */
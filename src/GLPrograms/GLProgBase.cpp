@@ -30,6 +30,7 @@
 #include <sstream>
 
 #include "GLPrograms/GLProgBase.h"
+#include "GLES/ProgramBinaryCache.h"
 
 namespace OevGLES {
 
@@ -43,6 +44,19 @@ GLProgBase::~GLProgBase() {
 
 void GLProgBase::createProgram() {
 
+	startCreateProgram();
+	finishCreateProgram();
+
+}
+
+void GLProgBase::startCreateProgram() {
+	ProgramBinaryCache &binaryCache = ProgramBinaryCache::getProgramBinaryCache();
+
+	if (binaryCache.loadProgram(prog,getVertexShaderCode(),getFragmentShaderCode())) {
+		retrieveShaderVariableInfo();
+		return;
+	}
+
 	OevGLES::GLVertexShader *vertShader = new OevGLES::GLVertexShader (
 			getVertexShaderCode());
 
@@ -52,7 +66,19 @@ void GLProgBase::createProgram() {
 	prog.attachVertexShader(vertShader);
 	prog.attachFragmentShader(fragShader);
 
-	prog.linkProgram();
+	prog.startLinkProgram();
+
+}
+
+void GLProgBase::finishCreateProgram() {
+
+	if (!prog.isLinkPending()) {
+		return;
+	}
+
+	prog.finishLinkProgram();
+
+	ProgramBinaryCache::getProgramBinaryCache().storeProgram(prog,getVertexShaderCode(),getFragmentShaderCode());
 
 	retrieveShaderVariableInfo();
 
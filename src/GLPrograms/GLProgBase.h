@@ -28,6 +28,12 @@
 
 #include "GLES/GLProgram.h"
 
+#if defined Success
+#	undef Success
+#endif
+
+#include "GLES/VecMat.h"
+
 namespace OevGLES {
 
 class GLProgBase {
@@ -48,6 +54,72 @@ public:
 		prog.useProgram();
 	}
 
+	/** \brief Set a mat4 uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * The program must be in use.
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform(GLint location,Mat4 const &value) {
+		prog.setUniformMatrix4fv(location,value.data());
+	}
+
+	/** \brief Set a vec4 uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform(GLint location,Vec4 const &value) {
+		prog.setUniform4fv(location,value.data());
+	}
+
+	/** \brief Set a vec3 uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform(GLint location,Vec3 const &value) {
+		prog.setUniform3fv(location,value.data());
+	}
+
+	/** \brief Set a vec2 uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform(GLint location,Vec2 const &value) {
+		prog.setUniform2fv(location,value.data());
+	}
+
+	/** \brief Set a float uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform(GLint location,GLfloat value) {
+		prog.setUniform1f(location,value);
+	}
+
+	/** \brief Set an int or sampler uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * @param location Location of the uniform
+	 * @param value New value
+	 */
+	void setUniform(GLint location,GLint value) {
+		prog.setUniform1i(location,value);
+	}
+
+	/** \brief Set the first \p count elements of a vec4 array uniform. The array is always uploaded.
+	 *
+	 * @param location Location of the array
+	 * @param values 4 * \p count floats
+	 * @param count Number of vec4 elements
+	 */
+	void setUniformVec4Array(GLint location,GLfloat const *values,GLsizei count) {
+		prog.setUniform4fvArray(location,count,values);
+	}
+
 	/** \brief Retrieve the vertex shader code.
 	 *
 	 *	The method must be overridden by sub-classes which provide their specific shader code.
@@ -78,6 +150,18 @@ protected:
 	 */
 	void createProgram();
 
+	/** \brief First half of \ref createProgram(). Issues compilation and linking, but does not wait for the result.
+	 *
+	 * When the program is found in the \ref ProgramBinaryCache it is completely created here.
+	 */
+	void startCreateProgram();
+
+	/** \brief Second half of \ref createProgram(). Waits for the link result, and retrieves the shader variables.
+	 *
+	 * Does nothing when the program is already complete.
+	 */
+	void finishCreateProgram();
+
 	/** \brief Called after linking the GL program to retrieve and store the shader variable information in the sub-class of this class.
 	 *
 	 * The variables which are to be retrieved are depending on the declarations and the actual shader code.
@@ -45,14 +45,23 @@ GLProgDiffLightTexture::~GLProgDiffLightTexture() {
 
 GLProgDiffLightTexture* GLProgDiffLightTexture::getProgram() {
 
+	prepareProgram();
+
+	// Blocks until the driver finished linking
+	theProgram->finishCreateProgram();
+
+	return theProgram;
+
+}
+
+void GLProgDiffLightTexture::prepareProgram() {
+
 	if (!theProgram) {
 		theProgram = new GLProgDiffLightTexture;
 
-		theProgram->createProgram();
+		theProgram->startCreateProgram();
 	}
 
-	return theProgram;
-
 }
 
 void GLProgDiffLightTexture::destroyProgram() {
@@ -89,7 +98,8 @@ const char* GLProgDiffLightTexture::getVertexShaderCode() const {
 			"const float cZero = 0.0;"
 			"\n"
 			"void main () { \n"
-			"	float diffuseLightFactor = abs(dot(lightDir,vec3((mvMatrix * vertexNormal))));\n"
+			"	// Normals are directions, and are not translated. Packed normals have no w component.\n"
+			"	float diffuseLightFactor = abs(dot(lightDir,vec3(mvMatrix * vec4(vertexNormal.xyz,cZero))));\n"
 			"	\n"
 			"	fragColor = vertexColor * (ambientLightColor + (diffuseLightFactor * lightColor));\n"
 			"	varyTexture0Pos = vertexTexture0Pos;\n"
@@ -112,23 +122,4 @@ const char* GLProgDiffLightTexture::getFragmentShaderCode() const {
 			"}\n";
 }
 
-
-void OevGLES::GLProgDiffLightTexture::retrieveShaderVariableInfo() {
-
-	// The uniforms
-	mvpMatrixInfo			= *retrieveSingleUniformInfo("mvpMatrix",mvpMatrixLocation);
-	mvMatrixInfo			= *retrieveSingleUniformInfo("mvMatrix",mvMatrixLocation);
-	lightDirInfo			= *retrieveSingleUniformInfo("lightDir",lightDirLocation);
-	lightColorInfo			= *retrieveSingleUniformInfo("lightColor",lightColorLocation);
-	ambientLightColorInfo	= *retrieveSingleUniformInfo("ambientLightColor",ambientLightColorLocation);
-	texture0Info			= *retrieveSingleUniformInfo("texture0",texture0Location);
-
-	// The vertex attributes
-	vertexPosInfo			= *retrieveSingleAttributeInfo("vertexPos",vertexPosLocation);
-	vertexNormalInfo		= *retrieveSingleAttributeInfo("vertexNormal",vertexNormalLocation);
-	vertexColorInfo			= *retrieveSingleAttributeInfo("vertexColor",vertexColorLocation);
-	vertexTexture0PosInfo	= *retrieveSingleAttributeInfo("vertexTexture0Pos",vertexTexture0PosLocation);
-
-}
-
 } /* namespace OevGLES */
@@ -26,12 +26,45 @@
 #ifndef GLPROGDIFFLIGHTTEXTURE_H_
 #define GLPROGDIFFLIGHTTEXTURE_H_
 
-#include "GLPrograms/GLProgBase.h"
+#include "GLPrograms/GLProgInterface.h"
 
 
 namespace OevGLES {
 
-class GLProgDiffLightTexture :public GLProgBase {
+/// \brief Interface of \ref GLProgDiffLightTexture
+struct GLProgDiffLightTextureInterface {
+	enum Uniform {
+		mvpMatrix,
+		mvMatrix,
+		lightDir,
+		lightColor,
+		ambientLightColor,
+		texture0
+	};
+	static constexpr ShaderVariableDecl uniforms[] = {
+		{mvpMatrix,"mvpMatrix",GL_FLOAT_MAT4},
+		{mvMatrix,"mvMatrix",GL_FLOAT_MAT4},
+		{lightDir,"lightDir",GL_FLOAT_VEC3},
+		{lightColor,"lightColor",GL_FLOAT_VEC4},
+		{ambientLightColor,"ambientLightColor",GL_FLOAT_VEC4},
+		{texture0,"texture0",GL_SAMPLER_2D}
+	};
+
+	enum Attribute {
+		vertexPos,
+		vertexNormal,
+		vertexColor,
+		vertexTexture0Pos
+	};
+	static constexpr ShaderVariableDecl attributes[] = {
+		{vertexPos,"vertexPos",GL_FLOAT_VEC4},
+		{vertexNormal,"vertexNormal",GL_FLOAT_VEC4},
+		{vertexColor,"vertexColor",GL_FLOAT_VEC4},
+		{vertexTexture0Pos,"vertexTexture0Pos",GL_FLOAT_VEC2}
+	};
+};
+
+class GLProgDiffLightTexture :public GLProgInterface<GLProgDiffLightTextureInterface> {
 public:
 
 	virtual ~GLProgDiffLightTexture();
@@ -44,6 +77,12 @@ public:
 	 */
 	static GLProgDiffLightTexture *getProgram();
 
+	/** \brief Create the only instance of the program, and issue compilation and linking without waiting for the result.
+	 *
+	 * The driver can compile in the background until \ref getProgram() is called the first time.
+	 */
+	static void prepareProgram();
+
 	/** \brief Destroy the single instance of the program.
 	 *
 	 * This call should be made at the end of the program, or if the GLProgram is really no longer used.
@@ -65,118 +104,10 @@ public:
 	 */
 	virtual char const* getFragmentShaderCode() const override;
 
-	// The uniforms
-	GLProgram::ShaderVariableInfo const &getMvpMatrixInfo() const {
-		return mvpMatrixInfo;
-	}
-	GLint getMvpMatrixLocation () const {
-		return mvpMatrixLocation;
-	}
-
-
-	GLProgram::ShaderVariableInfo  const &getMvMatrixInfo() const {
-		return mvMatrixInfo;
-	}
-	GLint getMvMatrixLocation () const {
-		return mvMatrixLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getLightDirInfo() const {
-		return lightDirInfo;
-	}
-	GLint getLightDirLocation () const {
-		return lightDirLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getLightColorInfo() const {
-		return lightColorInfo;
-	}
-	GLint getLightColorLocation () const {
-		return lightColorLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getAmbientLightColorInfo() const {
-		return ambientLightColorInfo;
-	}
-	GLint getAmbientLightColorLocation () const {
-		return ambientLightColorLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getTexture0Info() const {
-		return texture0Info;
-	}
-	GLint getTexture0Location () const {
-		return texture0Location;
-	}
-
-	// The vertex attributes
-	GLProgram::ShaderVariableInfo  const &getVertexPosInfo() const {
-		return vertexPosInfo;
-	}
-	GLint getVertexPosLocation () const {
-		return vertexPosLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getVertexNormalInfo() const {
-		return vertexNormalInfo;
-	}
-	GLint getVertexNormalLocation () const {
-		return vertexNormalLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getVertexColorInfo() const {
-		return vertexColorInfo;
-	}
-	GLint getVertexColorLocation () const {
-		return vertexColorLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getVertexTexture0PosInfo() const {
-		return vertexTexture0PosInfo;
-	}
-	GLint getVertexTexture0PosLocation () const {
-		return vertexTexture0PosLocation;
-	}
-
-
-protected:
-
-	/** \brief Called after linking the GL program to retrieve and store the shader variable information in the sub-class of this class.
-	 *
-	 * The variables which are to be retrieved are depending on the declarations and the actual shader code.
-	 *
-	 */
-	virtual void retrieveShaderVariableInfo() override;
-
-
 private:
 	/// \brief The only instance of this program object.
 	static GLProgDiffLightTexture* theProgram;
 
-	// The uniforms
-	GLProgram::ShaderVariableInfo	mvpMatrixInfo;
-	GLint 							mvpMatrixLocation = 0;
-	GLProgram::ShaderVariableInfo	mvMatrixInfo;
-	GLint							mvMatrixLocation = 0;
-	GLProgram::ShaderVariableInfo	lightDirInfo;
-	GLint							lightDirLocation = 0;
-	GLProgram::ShaderVariableInfo	lightColorInfo;
-	GLint							lightColorLocation = 0;
-	GLProgram::ShaderVariableInfo	ambientLightColorInfo;
-	GLint							ambientLightColorLocation = 0;
-	GLProgram::ShaderVariableInfo	texture0Info;
-	GLint							texture0Location = 0;
-
-	// The vertex attributes
-	GLProgram::ShaderVariableInfo	vertexPosInfo;
-	GLint							vertexPosLocation = 0;
-	GLProgram::ShaderVariableInfo	vertexNormalInfo;
-	GLint							vertexNormalLocation = 0;
-	GLProgram::ShaderVariableInfo	vertexColorInfo;
-	GLint							vertexColorLocation = 0;
-	GLProgram::ShaderVariableInfo	vertexTexture0PosInfo;
-	GLint							vertexTexture0PosLocation = 0;
-
 	/** \brief private constructor
 	 *
 	 * The constructor is private because only the static method \ref getProgram() will create the only object of this class on demand
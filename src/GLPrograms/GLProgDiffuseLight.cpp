@@ -43,14 +43,23 @@ GLProgDiffuseLight::~GLProgDiffuseLight() {
 
 GLProgDiffuseLight* GLProgDiffuseLight::getProgram() {
 
+	prepareProgram();
+
+	// Blocks until the driver finished linking
+	theProgram->finishCreateProgram();
+
+	return theProgram;
+
+}
+
+void GLProgDiffuseLight::prepareProgram() {
+
 	if (!theProgram) {
 		theProgram = new GLProgDiffuseLight;
 
-		theProgram->createProgram();
+		theProgram->startCreateProgram();
 	}
 
-	return theProgram;
-
 }
 
 void GLProgDiffuseLight::destroyProgram() {
@@ -85,7 +94,8 @@ const char* GLProgDiffuseLight::getVertexShaderCode() const {
 			"const float cZero = 0.0;"
 			"\n"
 			"void main () { \n"
-			"	float diffuseLightFactor = abs(dot(lightDir,vec3((mvMatrix * vertexNormal))));\n"
+			"	// Normals are directions, and are not translated. Packed normals have no w component.\n"
+			"	float diffuseLightFactor = abs(dot(lightDir,vec3(mvMatrix * vec4(vertexNormal.xyz,cZero))));\n"
 			"	\n"
 			"	fragColor = vertexColor * (ambientLightColor + (diffuseLightFactor * lightColor));\n"
 			"	gl_Position = mvpMatrix * vertexPos;\n"
@@ -103,21 +113,4 @@ const char* GLProgDiffuseLight::getFragmentShaderCode() const {
 			"}\n";
 }
 
-
-void OevGLES::GLProgDiffuseLight::retrieveShaderVariableInfo() {
-
-	// The uniforms
-	mvpMatrixInfo			= *retrieveSingleUniformInfo("mvpMatrix",mvpMatrixLocation);
-	mvMatrixInfo			= *retrieveSingleUniformInfo("mvMatrix",mvMatrixLocation);
-	lightDirInfo			= *retrieveSingleUniformInfo("lightDir",lightDirLocation);
-	lightColorInfo			= *retrieveSingleUniformInfo("lightColor",lightColorLocation);
-	ambientLightColorInfo	= *retrieveSingleUniformInfo("ambientLightColor",ambientLightColorLocation);
-
-	// The vertex attributes
-	vertexPosInfo		= *retrieveSingleAttributeInfo("vertexPos",vertexPosLocation);
-	vertexNormalInfo	= *retrieveSingleAttributeInfo("vertexNormal",vertexNormalLocation);
-	vertexColorInfo		= *retrieveSingleAttributeInfo("vertexColor",vertexColorLocation);
-
-}
-
 } /* namespace OevGLES */
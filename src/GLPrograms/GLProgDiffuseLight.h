@@ -26,14 +26,43 @@
 #ifndef GLPROGDIFFUSELIGHT_H_
 #define GLPROGDIFFUSELIGHT_H_
 
-#include "GLPrograms/GLProgBase.h"
+#include "GLPrograms/GLProgInterface.h"
 
 namespace OevGLES {
 
+/// \brief Interface of \ref GLProgDiffuseLight
+struct GLProgDiffuseLightInterface {
+	enum Uniform {
+		mvpMatrix,
+		mvMatrix,
+		lightDir,
+		lightColor,
+		ambientLightColor
+	};
+	static constexpr ShaderVariableDecl uniforms[] = {
+		{mvpMatrix,"mvpMatrix",GL_FLOAT_MAT4},
+		{mvMatrix,"mvMatrix",GL_FLOAT_MAT4},
+		{lightDir,"lightDir",GL_FLOAT_VEC3},
+		{lightColor,"lightColor",GL_FLOAT_VEC4},
+		{ambientLightColor,"ambientLightColor",GL_FLOAT_VEC4}
+	};
+
+	enum Attribute {
+		vertexPos,
+		vertexNormal,
+		vertexColor
+	};
+	static constexpr ShaderVariableDecl attributes[] = {
+		{vertexPos,"vertexPos",GL_FLOAT_VEC4},
+		{vertexNormal,"vertexNormal",GL_FLOAT_VEC4},
+		{vertexColor,"vertexColor",GL_FLOAT_VEC4}
+	};
+};
+
 /** \brief GL program with diffuse Gouraud lighting
  *
  */
-class GLProgDiffuseLight :public GLProgBase {
+class GLProgDiffuseLight :public GLProgInterface<GLProgDiffuseLightInterface> {
 public:
 	virtual ~GLProgDiffuseLight();
 
@@ -45,6 +74,12 @@ public:
 	 */
 	static GLProgDiffuseLight *getProgram();
 
+	/** \brief Create the only instance of the program, and issue compilation and linking without waiting for the result.
+	 *
+	 * The driver can compile in the background until \ref getProgram() is called the first time.
+	 */
+	static void prepareProgram();
+
 	/** \brief Destroy the single instance of the program.
 	 *
 	 * This call should be made at the end of the program, or if the GLProgram is really no longer used.
@@ -66,100 +101,10 @@ public:
 	 */
 	virtual char const* getFragmentShaderCode() const override;
 
-	// The uniforms
-	GLProgram::ShaderVariableInfo const &getMvpMatrixInfo() const {
-		return mvpMatrixInfo;
-	}
-	GLint getMvpMatrixLocation () const {
-		return mvpMatrixLocation;
-	}
-
-
-	GLProgram::ShaderVariableInfo  const &getMvMatrixInfo() const {
-		return mvMatrixInfo;
-	}
-	GLint getMvMatrixLocation () const {
-		return mvMatrixLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getLightDirInfo() const {
-		return lightDirInfo;
-	}
-	GLint getLightDirLocation () const {
-		return lightDirLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getLightColorInfo() const {
-		return lightColorInfo;
-	}
-	GLint getLightColorLocation () const {
-		return lightColorLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getAmbientLightColorInfo() const {
-		return ambientLightColorInfo;
-	}
-	GLint getAmbientLightColorLocation () const {
-		return ambientLightColorLocation;
-	}
-
-	// The vertex attributes
-	GLProgram::ShaderVariableInfo  const &getVertexPosInfo() const {
-		return vertexPosInfo;
-	}
-	GLint getVertexPosLocation () const {
-		return vertexPosLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getVertexNormalInfo() const {
-		return vertexNormalInfo;
-	}
-	GLint getVertexNormalLocation () const {
-		return vertexNormalLocation;
-	}
-
-	GLProgram::ShaderVariableInfo  const &getVertexColorInfo() const {
-		return vertexColorInfo;
-	}
-	GLint getVertexColorLocation () const {
-		return vertexColorLocation;
-	}
-
-
-protected:
-
-	/** \brief Called after linking the GL program to retrieve and store the shader variable information in the sub-class of this class.
-	 *
-	 * The variables which are to be retrieved are depending on the declarations and the actual shader code.
-	 *
-	 */
-	virtual void retrieveShaderVariableInfo() override;
-
-
 private:
 	/// \brief The only instance of this program object.
 	static GLProgDiffuseLight* theProgram;
 
-	// The uniforms
-	GLProgram::ShaderVariableInfo	mvpMatrixInfo;
-	GLint 							mvpMatrixLocation = 0;
-	GLProgram::ShaderVariableInfo	mvMatrixInfo;
-	GLint							mvMatrixLocation = 0;
-	GLProgram::ShaderVariableInfo	lightDirInfo;
-	GLint							lightDirLocation = 0;
-	GLProgram::ShaderVariableInfo	lightColorInfo;
-	GLint							lightColorLocation = 0;
-	GLProgram::ShaderVariableInfo	ambientLightColorInfo;
-	GLint							ambientLightColorLocation = 0;
-
-	// The vertex attributes
-	GLProgram::ShaderVariableInfo	vertexPosInfo;
-	GLint							vertexPosLocation = 0;
-	GLProgram::ShaderVariableInfo	vertexNormalInfo;
-	GLint							vertexNormalLocation = 0;
-	GLProgram::ShaderVariableInfo	vertexColorInfo;
-	GLint							vertexColorLocation = 0;
-
 	/** \brief private constructor
 	 *
 	 * The constructor is private because only the static method \ref getProgram() will create the only object of this class on demand
@@ -0,0 +1,211 @@
+/*
+ * GLProgInterface.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Declarative description of the uniforms and attributes of a program, with index addressed locations and type checked setters.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef GLPROGINTERFACE_H_
+#define GLPROGINTERFACE_H_
+
+#include <array>
+#include <sstream>
+#include <iterator>
+
+#include "GLPrograms/GLProgBase.h"
+#include "GLES/ExceptionBase.h"
+
+namespace OevGLES {
+
+/** \brief GLSL type of a C++ value type which can be passed to a uniform
+ *
+ * Only types for which \ref GLProgBase has a setter are specialized.
+ * Any other type, e.g. an Eigen expression or a double, does not compile.
+ */
+template <typename T> struct GLSLTypeOf;
+
+template <> struct GLSLTypeOf<Mat4>		{ static constexpr GLenum glType = GL_FLOAT_MAT4; };
+template <> struct GLSLTypeOf<Vec4>		{ static constexpr GLenum glType = GL_FLOAT_VEC4; };
+template <> struct GLSLTypeOf<Vec3>		{ static constexpr GLenum glType = GL_FLOAT_VEC3; };
+template <> struct GLSLTypeOf<Vec2>		{ static constexpr GLenum glType = GL_FLOAT_VEC2; };
+template <> struct GLSLTypeOf<GLfloat>	{ static constexpr GLenum glType = GL_FLOAT; };
+template <> struct GLSLTypeOf<GLint>	{ static constexpr GLenum glType = GL_INT; };
+
+/** \brief Declaration of a uniform or a vertex attribute in a program interface
+ *
+ * \p id is the enumeration value of the variable. It must be equal to the position in the declaration array.
+ * This is checked at compile time.
+ */
+struct ShaderVariableDecl {
+	unsigned id;
+	char const *name;
+	GLenum type;
+};
+
+/** \brief Can a value of GLSL type \p valueType be assigned to a uniform of type \p declType?
+ *
+ * Samplers and booleans are set with integers.
+ */
+constexpr bool isUniformTypeCompatible(GLenum declType,GLenum valueType) {
+	return declType == valueType ||
+			(valueType == GL_INT && (declType == GL_SAMPLER_2D || declType == GL_SAMPLER_CUBE || declType == GL_BOOL));
+}
+
+/// \brief Are the declarations ordered by their ids, i.e. is decls[i].id == i for all i?
+template <size_t n>
+constexpr bool isDeclOrderValid(ShaderVariableDecl const (&decls)[n]) {
+	for (size_t i = 0; i < n; i++) {
+		if (decls[i].id != i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** \brief Program base class with a declarative interface
+ *
+ * The uniforms and vertex attributes of the program are described once in a struct \p Interface:
+ *
+ * \code
+ * struct MyProgInterface {
+ *     enum Uniform { mvpMatrix, texture0 };
+ *     static constexpr ShaderVariableDecl uniforms[] = {
+ *         {mvpMatrix,"mvpMatrix",GL_FLOAT_MAT4},
+ *         {texture0,"texture0",GL_SAMPLER_2D}
+ *     };
+ *     enum Attribute { vertexPos };
+ *     static constexpr ShaderVariableDecl attributes[] = {
+ *         {vertexPos,"vertexPos",GL_FLOAT_VEC4}
+ *     };
+ * };
+ *
+ * class MyProg :public GLProgInterface<MyProgInterface> { ... };
+ * \endcode
+ *
+ * After linking the locations of all declared variables are retrieved once into flat arrays indexed by the enumerations.
+ * A variable which is missing in the linked program, or whose type differs from the declaration,
+ * throws a ProgramException.
+ *
+ * Uniforms are set with \ref setUniform<>(). The type of the value is checked against the declaration at compile time.
+ * Attribute locations are obtained with \ref getAttributeLocation().
+ *
+ * The enumerations are inherited, i.e. the variables can be addressed as MyProg::mvpMatrix.
+ */
+template <class Interface>
+class GLProgInterface :public GLProgBase, public Interface {
+public:
+
+	typedef typename Interface::Uniform Uniform;
+	typedef typename Interface::Attribute Attribute;
+
+	static constexpr size_t numUniforms = std::size(Interface::uniforms);
+	static constexpr size_t numAttributes = std::size(Interface::attributes);
+
+	static_assert(isDeclOrderValid(Interface::uniforms),"Uniform declarations must be in the order of the enumeration Uniform");
+	static_assert(isDeclOrderValid(Interface::attributes),"Attribute declarations must be in the order of the enumeration Attribute");
+
+	// The setters with explicit locations stay accessible
+	using GLProgBase::setUniform;
+
+	/** \brief Set a uniform. Skips the GL call when the value did not change since the last call.
+	 *
+	 * The program must be in use. A value type which does not match the declared type of the uniform does not compile.
+	 *
+	 * @tparam uniform The uniform
+	 * @param value New value
+	 */
+	template <Uniform uniform,typename T>
+	void setUniform(T const &value) {
+		static_assert(isUniformTypeCompatible(Interface::uniforms[uniform].type,GLSLTypeOf<T>::glType),
+				"Type of the value does not match the declared type of the uniform");
+
+		GLProgBase::setUniform(uniformLocations[uniform],value);
+	}
+
+	/** \brief Set the first \p count elements of a vec4 array uniform
+	 *
+	 * The program must be in use. The uniform must be declared with type GL_FLOAT_VEC4 under the name of the array.
+	 *
+	 * @tparam uniform The array uniform
+	 * @param values 4 * \p count floats
+	 * @param count Number of vec4 elements
+	 */
+	template <Uniform uniform>
+	void setUniformVec4Array(GLfloat const *values,GLsizei count) {
+		static_assert(Interface::uniforms[uniform].type == GL_FLOAT_VEC4,
+				"The uniform is not declared as vec4 array");
+
+		GLProgBase::setUniformVec4Array(uniformLocations[uniform],values,count);
+	}
+
+	/// \brief Location of a uniform, e.g. for binding a texture
+	GLint getUniformLocation(Uniform uniform) const {
+		return uniformLocations[uniform];
+	}
+
+	/// \brief Location of a vertex attribute
+	GLint getAttributeLocation(Attribute attribute) const {
+		return attributeLocations[attribute];
+	}
+
+protected:
+
+	/// \brief Retrieves the locations of all declared uniforms and attributes, and checks their types.
+	virtual void retrieveShaderVariableInfo() override {
+
+		for (size_t i = 0; i < numUniforms; i++) {
+			ShaderVariableDecl const &decl = Interface::uniforms[i];
+
+			checkType(*retrieveSingleUniformInfo(decl.name,uniformLocations[i]),decl,"Uniform");
+		}
+
+		for (size_t i = 0; i < numAttributes; i++) {
+			ShaderVariableDecl const &decl = Interface::attributes[i];
+
+			checkType(*retrieveSingleAttributeInfo(decl.name,attributeLocations[i]),decl,"Attribute");
+		}
+	}
+
+private:
+
+	std::array<GLint,numUniforms> uniformLocations {};
+	std::array<GLint,numAttributes> attributeLocations {};
+
+	/// \brief Throw a ProgramException when the type in the program differs from the declaration
+	static void checkType(GLProgram::ShaderVariableInfo const &info,ShaderVariableDecl const &decl,char const *kind) {
+		if (info.getVariableType() != decl.type) {
+			std::ostringstream str;
+
+			str << kind << ' ' << decl.name << " is declared with type 0x" << std::hex << decl.type
+					<< " but has type 0x" << info.getVariableType() << " in the program.";
+
+			throw ProgramException(str.str().c_str());
+		}
+	}
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLPROGINTERFACE_H_ */
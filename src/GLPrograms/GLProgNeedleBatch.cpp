@@ -0,0 +1,128 @@
+/*
+ * GLProgNeedleBatch.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which draws a batch of instrument needles with one draw call
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+
+#include "GLPrograms/GLProgNeedleBatch.h"
+
+namespace OevGLES {
+
+GLProgNeedleBatch* GLProgNeedleBatch::theProgram = 0;
+
+// The array sizes are literals in the vertex shader below.
+static_assert(GLProgNeedleBatch::maxNeedles == 16,"Adjust the array sizes in the vertex shader");
+
+GLProgNeedleBatch::~GLProgNeedleBatch() {
+
+	// This deletes the only instance of the program
+	theProgram = 0;
+
+}
+
+GLProgNeedleBatch* GLProgNeedleBatch::getProgram() {
+
+	prepareProgram();
+
+	// Blocks until the driver finished linking
+	theProgram->finishCreateProgram();
+
+	return theProgram;
+
+}
+
+void GLProgNeedleBatch::prepareProgram() {
+
+	if (!theProgram) {
+		theProgram = new GLProgNeedleBatch;
+
+		theProgram->startCreateProgram();
+	}
+
+}
+
+void GLProgNeedleBatch::destroyProgram() {
+	if (theProgram) {
+		delete theProgram;
+		theProgram = 0;
+	}
+}
+
+const char* GLProgNeedleBatch::getVertexShaderCode() const {
+
+	return
+			"precision mediump float;\n"
+			"\n"
+			"uniform mat4 mvpMatrix;\n"
+			"uniform mat4 mvMatrix;\n"
+			"\n"
+			"// Light diretory vector is already in eye space\n"
+			"uniform vec3 lightDir;\n"
+			"uniform vec4 lightColor;\n"
+			"uniform vec4 ambientLightColor;\n"
+			"\n"
+			"// Per needle (cos(angle), sin(angle), pivot x, pivot y), and the color\n"
+			"uniform vec4 needleTransforms[16];\n"
+			"uniform vec4 needleColors[16];\n"
+			"\n"
+			"attribute vec4 vertexPos;\n"
+			"attribute vec4 vertexNormal;\n"
+			"attribute float needleIndex;\n"
+			"\n"
+			"varying vec4 fragColor;\n"
+			"\n"
+			"const float cZero = 0.0;\n"
+			"const float cOne = 1.0;\n"
+			"\n"
+			"void main () { \n"
+			"	int i = int(needleIndex);\n"
+			"	vec4 transform = needleTransforms[i];\n"
+			"	mat2 rotation = mat2(transform.x,transform.y,-transform.y,transform.x);\n"
+			"	\n"
+			"	vec4 pos = vec4(rotation * vertexPos.xy + transform.zw,vertexPos.z,cOne);\n"
+			"	vec3 normal = vec3(rotation * vertexNormal.xy,vertexNormal.z);\n"
+			"	float diffuseLightFactor = abs(dot(lightDir,vec3(mvMatrix * vec4(normal,cZero))));\n"
+			"	\n"
+			"	fragColor = needleColors[i] * (ambientLightColor + (diffuseLightFactor * lightColor));\n"
+			"	gl_Position = mvpMatrix * pos;\n"
+			"}\n";
+
+}
+
+const char* GLProgNeedleBatch::getFragmentShaderCode() const {
+	return
+			"precision mediump float;\n"
+			"varying vec4 fragColor;\n"
+			"\n"
+			"void main () {\n"
+			"	gl_FragColor = fragColor;\n"
+			"}\n";
+}
+
+} /* namespace OevGLES */
@@ -0,0 +1,132 @@
+/*
+ * GLProgNeedleBatch.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which draws a batch of instrument needles with one draw call
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef GLPROGNEEDLEBATCH_H_
+#define GLPROGNEEDLEBATCH_H_
+
+#include "GLPrograms/GLProgInterface.h"
+
+namespace OevGLES {
+
+/// \brief Interface of \ref GLProgNeedleBatch
+struct GLProgNeedleBatchInterface {
+
+	/// \brief Size of the per-needle uniform arrays. Must match the array sizes in the vertex shader.
+	static constexpr unsigned maxNeedles = 16;
+
+	enum Uniform {
+		mvpMatrix,
+		mvMatrix,
+		lightDir,
+		lightColor,
+		ambientLightColor,
+		needleTransforms,
+		needleColors
+	};
+	static constexpr ShaderVariableDecl uniforms[] = {
+		{mvpMatrix,"mvpMatrix",GL_FLOAT_MAT4},
+		{mvMatrix,"mvMatrix",GL_FLOAT_MAT4},
+		{lightDir,"lightDir",GL_FLOAT_VEC3},
+		{lightColor,"lightColor",GL_FLOAT_VEC4},
+		{ambientLightColor,"ambientLightColor",GL_FLOAT_VEC4},
+		{needleTransforms,"needleTransforms",GL_FLOAT_VEC4},
+		{needleColors,"needleColors",GL_FLOAT_VEC4}
+	};
+
+	enum Attribute {
+		vertexPos,
+		vertexNormal,
+		needleIndex
+	};
+	static constexpr ShaderVariableDecl attributes[] = {
+		{vertexPos,"vertexPos",GL_FLOAT_VEC4},
+		{vertexNormal,"vertexNormal",GL_FLOAT_VEC4},
+		{needleIndex,"needleIndex",GL_FLOAT}
+	};
+};
+
+/** \brief GL program with diffuse Gouraud lighting for a batch of needles
+ *
+ * GLES 2 has no instancing. Instead each vertex carries the index of its needle in the attribute needleIndex.
+ * The vertex shader picks the transform and the color of the needle from the uniform arrays
+ * needleTransforms and needleColors with this index.
+ *
+ * A needle transform is (cos(angle), sin(angle), pivot x, pivot y). The needle is rotated around the z axis,
+ * and moved to the pivot in the x/y plane of the model space.
+ *
+ * Otherwise the lighting is the same as \ref GLProgDiffuseLight.
+ */
+class GLProgNeedleBatch :public GLProgInterface<GLProgNeedleBatchInterface> {
+public:
+	virtual ~GLProgNeedleBatch();
+
+	/** \brief Return the only instance of the program
+	 *
+	 * If the instance did not exist before it is created, the shaders are created, and the program is linked.
+	 *
+	 * @return Pointer to the instance of the program
+	 */
+	static GLProgNeedleBatch *getProgram();
+
+	/** \brief Create the only instance of the program, and issue compilation and linking without waiting for the result.
+	 *
+	 * The driver can compile in the background until \ref getProgram() is called the first time.
+	 */
+	static void prepareProgram();
+
+	/** \brief Destroy the single instance of the program.
+	 *
+	 * After it is called all pointers obtained by \ref getProgram become invalid
+	 */
+	static void destroyProgram();
+
+	/** \brief Retrieve the vertex shader code.
+	 *
+	 * @return Vertex shader code as one C string
+	 */
+	virtual char const* getVertexShaderCode() const override;
+
+	/** \brief Retrieve the frament shader code.
+	 *
+	 * @return Fragment shader code as one C string
+	 */
+	virtual char const* getFragmentShaderCode() const override;
+
+private:
+	/// \brief The only instance of this program object.
+	static GLProgNeedleBatch* theProgram;
+
+	/// \brief Only \ref getProgram() creates the object
+	GLProgNeedleBatch() {
+
+	}
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLPROGNEEDLEBATCH_H_ */
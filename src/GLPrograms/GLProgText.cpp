@@ -0,0 +1,112 @@
+/*
+ * GLProgText.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which draws text from a glyph texture with alpha blending
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+
+
+#include "GLPrograms/GLProgText.h"
+
+namespace OevGLES {
+
+
+GLProgText* GLProgText::theProgram = 0;
+
+GLProgText::~GLProgText() {
+
+	// This deletes the only instance of the program
+	theProgram = 0;
+
+}
+
+GLProgText* GLProgText::getProgram() {
+
+	prepareProgram();
+
+	// Blocks until the driver finished linking
+	theProgram->finishCreateProgram();
+
+	return theProgram;
+
+}
+
+void GLProgText::prepareProgram() {
+
+	if (!theProgram) {
+		theProgram = new GLProgText;
+
+		theProgram->startCreateProgram();
+	}
+
+}
+
+void GLProgText::destroyProgram() {
+	if (theProgram) {
+		delete theProgram;
+		theProgram = 0;
+	}
+}
+
+const char* GLProgText::getVertexShaderCode() const {
+
+	return
+			"precision mediump float;\n"
+			"\n"
+			"uniform mat4 mvpMatrix;\n"
+			"\n"
+			"attribute vec3 vertexPos;\n"
+			"attribute vec2 vertexTexture0Pos;\n"
+			"\n"
+			"varying vec2 varyTexture0Pos;\n"
+			"\n"
+			"void main () { \n"
+			"	varyTexture0Pos = vertexTexture0Pos;\n"
+			"	gl_Position = mvpMatrix * vec4(vertexPos,1.0);\n"
+			"}\n";
+
+}
+
+const char* GLProgText::getFragmentShaderCode() const {
+	return
+			"precision mediump float;\n"
+			"\n"
+			"uniform vec4 textColor;\n"
+			"uniform sampler2D texture0;\n"
+			"\n"
+			"varying vec2 varyTexture0Pos;\n"
+			"\n"
+			"void main () {\n"
+			"	// Luminance is the coverage of the glyph\n"
+			"	gl_FragColor = vec4(textColor.rgb,textColor.a * texture2D(texture0,varyTexture0Pos).r);\n"
+			"}\n";
+}
+
+} /* namespace OevGLES */
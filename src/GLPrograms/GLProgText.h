@@ -0,0 +1,120 @@
+/*
+ * GLProgText.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which draws text from a glyph texture with alpha blending
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifndef GLPROGTEXT_H_
+#define GLPROGTEXT_H_
+
+#include "GLPrograms/GLProgInterface.h"
+
+
+namespace OevGLES {
+
+/// \brief Interface of \ref GLProgText
+struct GLProgTextInterface {
+	enum Uniform {
+		mvpMatrix,
+		textColor,
+		texture0
+	};
+	static constexpr ShaderVariableDecl uniforms[] = {
+		{mvpMatrix,"mvpMatrix",GL_FLOAT_MAT4},
+		{textColor,"textColor",GL_FLOAT_VEC4},
+		{texture0,"texture0",GL_SAMPLER_2D}
+	};
+
+	enum Attribute {
+		vertexPos,
+		vertexTexture0Pos
+	};
+	static constexpr ShaderVariableDecl attributes[] = {
+		{vertexPos,"vertexPos",GL_FLOAT_VEC3},
+		{vertexTexture0Pos,"vertexTexture0Pos",GL_FLOAT_VEC2}
+	};
+};
+
+/** \brief Draws glyph quads in a single color without lighting
+ *
+ * The texture contains the coverage of the glyphs in a luminance channel. The fragment color is \p textColor
+ * with the alpha multiplied by the coverage. Draw with alpha blending.
+ *
+ * Used by the \ref TextRenderer for the numeric readouts.
+ */
+class GLProgText :public GLProgInterface<GLProgTextInterface> {
+public:
+
+	virtual ~GLProgText();
+
+	/** \brief Return the only instance of the program
+	 *
+	 * If the instance did not exist before it is created, the shaders are created, and the program is linked.
+	 *
+	 * @return Pointer to the instance of the program
+	 */
+	static GLProgText *getProgram();
+
+	/** \brief Create the only instance of the program, and issue compilation and linking without waiting for the result.
+	 *
+	 * The driver can compile in the background until \ref getProgram() is called the first time.
+	 */
+	static void prepareProgram();
+
+	/** \brief Destroy the single instance of the program.
+	 *
+	 * After it is called all pointers obtained by \ref getProgram become invalid
+	 */
+	static void destroyProgram();
+
+	/** \brief Retrieve the vertex shader code.
+	 *
+	 * @return Vertex shader code as one C string
+	 */
+	virtual char const* getVertexShaderCode() const override;
+
+	/** \brief Retrieve the frament shader code.
+	 *
+	 * @return Fragment shader code as one C string
+	 */
+	virtual char const* getFragmentShaderCode() const override;
+
+private:
+	/// \brief The only instance of this program object.
+	static GLProgText* theProgram;
+
+	/** \brief private constructor
+	 *
+	 * Only the static method \ref getProgram() creates the only object of this class on demand
+	 */
+	GLProgText() {
+
+	}
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLPROGTEXT_H_ */
@@ -0,0 +1,127 @@
+/*
+ * GLProgTextSDF.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which draws text and symbols from a signed distance field texture
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifndef GLPROGTEXTSDF_H_
+#define GLPROGTEXTSDF_H_
+
+#include "GLPrograms/GLProgInterface.h"
+
+
+namespace OevGLES {
+
+/// \brief Interface of \ref GLProgTextSDF
+struct GLProgTextSDFInterface {
+	enum Uniform {
+		mvpMatrix,
+		textColor,
+		texture0,
+		edgeWidth
+	};
+	static constexpr ShaderVariableDecl uniforms[] = {
+		{mvpMatrix,"mvpMatrix",GL_FLOAT_MAT4},
+		{textColor,"textColor",GL_FLOAT_VEC4},
+		{texture0,"texture0",GL_SAMPLER_2D},
+		{edgeWidth,"edgeWidth",GL_FLOAT}
+	};
+
+	enum Attribute {
+		vertexPos,
+		vertexTexture0Pos
+	};
+	static constexpr ShaderVariableDecl attributes[] = {
+		{vertexPos,"vertexPos",GL_FLOAT_VEC3},
+		{vertexTexture0Pos,"vertexTexture0Pos",GL_FLOAT_VEC2}
+	};
+};
+
+/** \brief Draws glyph and symbol quads from a signed distance field in a single color without lighting
+ *
+ * The luminance channel of the texture is the distance to the edge of the shape as created by \ref DistanceField,
+ * 0.5 on the edge. The fragment color is \p textColor with the alpha multiplied by the coverage which is derived from
+ * the distance. Draw with alpha blending.
+ *
+ * The edge is anti-aliased over about one pixel on the screen at any scale and rotation. The width is taken from the
+ * screen space derivatives of the distance where OES_standard_derivatives is available, with \p edgeWidth as minimum.
+ * Without the extension \p edgeWidth alone is the half width of the edge in distance units.
+ *
+ * Used by the \ref TextRenderer in distance field mode.
+ */
+class GLProgTextSDF :public GLProgInterface<GLProgTextSDFInterface> {
+public:
+
+	virtual ~GLProgTextSDF();
+
+	/** \brief Return the only instance of the program
+	 *
+	 * If the instance did not exist before it is created, the shaders are created, and the program is linked.
+	 *
+	 * @return Pointer to the instance of the program
+	 */
+	static GLProgTextSDF *getProgram();
+
+	/** \brief Create the only instance of the program, and issue compilation and linking without waiting for the result.
+	 *
+	 * The driver can compile in the background until \ref getProgram() is called the first time.
+	 */
+	static void prepareProgram();
+
+	/** \brief Destroy the single instance of the program.
+	 *
+	 * After it is called all pointers obtained by \ref getProgram become invalid
+	 */
+	static void destroyProgram();
+
+	/** \brief Retrieve the vertex shader code.
+	 *
+	 * @return Vertex shader code as one C string
+	 */
+	virtual char const* getVertexShaderCode() const override;
+
+	/** \brief Retrieve the frament shader code.
+	 *
+	 * @return Fragment shader code as one C string
+	 */
+	virtual char const* getFragmentShaderCode() const override;
+
+private:
+	/// \brief The only instance of this program object.
+	static GLProgTextSDF* theProgram;
+
+	/** \brief private constructor
+	 *
+	 * Only the static method \ref getProgram() creates the only object of this class on demand
+	 */
+	GLProgTextSDF() {
+
+	}
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLPROGTEXTSDF_H_ */
@@ -0,0 +1,106 @@
+/*
+ * GLProgTexturedQuad.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which copies a texture 1:1 onto a screen aligned quad
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+
+
+#include "GLPrograms/GLProgTexturedQuad.h"
+
+namespace OevGLES {
+
+
+GLProgTexturedQuad* GLProgTexturedQuad::theProgram = 0;
+
+GLProgTexturedQuad::~GLProgTexturedQuad() {
+
+	// This deletes the only instance of the program
+	theProgram = 0;
+
+}
+
+GLProgTexturedQuad* GLProgTexturedQuad::getProgram() {
+
+	prepareProgram();
+
+	// Blocks until the driver finished linking
+	theProgram->finishCreateProgram();
+
+	return theProgram;
+
+}
+
+void GLProgTexturedQuad::prepareProgram() {
+
+	if (!theProgram) {
+		theProgram = new GLProgTexturedQuad;
+
+		theProgram->startCreateProgram();
+	}
+
+}
+
+void GLProgTexturedQuad::destroyProgram() {
+	if (theProgram) {
+		delete theProgram;
+		theProgram = 0;
+	}
+}
+
+const char* GLProgTexturedQuad::getVertexShaderCode() const {
+
+	return
+			"precision mediump float;\n"
+			"\n"
+			"// Position in normalized device coordinates\n"
+			"attribute vec2 vertexPos;\n"
+			"\n"
+			"varying vec2 varyTexture0Pos;\n"
+			"\n"
+			"void main () { \n"
+			"	varyTexture0Pos = vertexPos * 0.5 + 0.5;\n"
+			"	gl_Position = vec4(vertexPos,0.0,1.0);\n"
+			"}\n";
+
+}
+
+const char* GLProgTexturedQuad::getFragmentShaderCode() const {
+	return
+			"precision mediump float;\n"
+			"\n"
+			"uniform sampler2D texture0;\n"
+			"\n"
+			"varying vec2 varyTexture0Pos;\n"
+			"\n"
+			"void main () {\n"
+			"	gl_FragColor = texture2D(texture0,varyTexture0Pos);\n"
+			"}\n";
+}
+
+} /* namespace OevGLES */
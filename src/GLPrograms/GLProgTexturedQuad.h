@@ -0,0 +1,113 @@
+/*
+ * GLProgTexturedQuad.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Program which copies a texture 1:1 onto a screen aligned quad
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef GLPROGTEXTUREDQUAD_H_
+#define GLPROGTEXTUREDQUAD_H_
+
+#include "GLPrograms/GLProgInterface.h"
+
+
+namespace OevGLES {
+
+/// \brief Interface of \ref GLProgTexturedQuad
+struct GLProgTexturedQuadInterface {
+	enum Uniform {
+		texture0
+	};
+	static constexpr ShaderVariableDecl uniforms[] = {
+		{texture0,"texture0",GL_SAMPLER_2D}
+	};
+
+	enum Attribute {
+		vertexPos
+	};
+	static constexpr ShaderVariableDecl attributes[] = {
+		{vertexPos,"vertexPos",GL_FLOAT_VEC2}
+	};
+};
+
+/** \brief Copies a texture onto a screen aligned quad without lighting
+ *
+ * The vertex positions are passed in normalized device coordinates, no matrices are involved.
+ * The texture coordinates are derived from the positions, i.e. the quad from (-1,-1) to (1,1) maps the complete
+ * texture onto the complete viewport.
+ *
+ * Used to composite cached layers into the frame. The fragment shader is a single texture lookup.
+ */
+class GLProgTexturedQuad :public GLProgInterface<GLProgTexturedQuadInterface> {
+public:
+
+	virtual ~GLProgTexturedQuad();
+
+	/** \brief Return the only instance of the program
+	 *
+	 * If the instance did not exist before it is created, the shaders are created, and the program is linked.
+	 *
+	 * @return Pointer to the instance of the program
+	 */
+	static GLProgTexturedQuad *getProgram();
+
+	/** \brief Create the only instance of the program, and issue compilation and linking without waiting for the result.
+	 *
+	 * The driver can compile in the background until \ref getProgram() is called the first time.
+	 */
+	static void prepareProgram();
+
+	/** \brief Destroy the single instance of the program.
+	 *
+	 * After it is called all pointers obtained by \ref getProgram become invalid
+	 */
+	static void destroyProgram();
+
+	/** \brief Retrieve the vertex shader code.
+	 *
+	 * @return Vertex shader code as one C string
+	 */
+	virtual char const* getVertexShaderCode() const override;
+
+	/** \brief Retrieve the frament shader code.
+	 *
+	 * @return Fragment shader code as one C string
+	 */
+	virtual char const* getFragmentShaderCode() const override;
+
+private:
+	/// \brief The only instance of this program object.
+	static GLProgTexturedQuad* theProgram;
+
+	/** \brief private constructor
+	 *
+	 * Only the static method \ref getProgram() creates the only object of this class on demand
+	 */
+	GLProgTexturedQuad() {
+
+	}
+};
+
+} /* namespace OevGLES */
+
+#endif /* GLPROGTEXTUREDQUAD_H_ */
@@ -0,0 +1,104 @@
+/*
+ * ProgramRegistry.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Knows all GL programs, and starts compiling them in the background at startup.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <string.h>
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+#include "OVFCommon.h"
+
+#include "GLPrograms/ProgramRegistry.h"
+#include "GLPrograms/GLProgDiffuseLight.h"
+#include "GLPrograms/GLProgDiffLightTexture.h"
+#include "GLPrograms/GLProgTexturedQuad.h"
+#include "GLPrograms/GLProgText.h"
+#include "GLPrograms/GLProgTextSDF.h"
+#include "GLPrograms/GLProgNeedleBatch.h"
+
+namespace OevGLES {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+ProgramRegistry::Entry const ProgramRegistry::entries[] = {
+		{"GLProgDiffuseLight",GLProgDiffuseLight::prepareProgram,GLProgDiffuseLight::destroyProgram},
+		{"GLProgDiffLightTexture",GLProgDiffLightTexture::prepareProgram,GLProgDiffLightTexture::destroyProgram},
+		{"GLProgTexturedQuad",GLProgTexturedQuad::prepareProgram,GLProgTexturedQuad::destroyProgram},
+		{"GLProgText",GLProgText::prepareProgram,GLProgText::destroyProgram},
+		{"GLProgTextSDF",GLProgTextSDF::prepareProgram,GLProgTextSDF::destroyProgram},
+		{"GLProgNeedleBatch",GLProgNeedleBatch::prepareProgram,GLProgNeedleBatch::destroyProgram}
+};
+
+void ProgramRegistry::prepareAllPrograms() {
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.ProgramRegistry");
+	}
+#endif
+
+	enableParallelCompile();
+
+	for (auto const &entry : entries) {
+		LOG4CXX_DEBUG(logger,"Prepare program " << entry.name);
+		entry.prepareProgram();
+	}
+}
+
+void ProgramRegistry::destroyAllPrograms() {
+
+	for (auto const &entry : entries) {
+		entry.destroyProgram();
+	}
+}
+
+void ProgramRegistry::enableParallelCompile() {
+	char const *extensions = reinterpret_cast<char const *>(glGetString(GL_EXTENSIONS));
+
+	if (!extensions || !strstr(extensions,"GL_KHR_parallel_shader_compile")) {
+		LOG4CXX_INFO(logger,"GL_KHR_parallel_shader_compile is not supported.");
+		return;
+	}
+
+	PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreadsFunc =
+			(PFNGLMAXSHADERCOMPILERTHREADSKHRPROC) eglGetProcAddress("glMaxShaderCompilerThreadsKHR");
+
+	if (maxShaderCompilerThreadsFunc) {
+		// 0xFFFFFFFF lets the driver choose the number of threads
+		maxShaderCompilerThreadsFunc(0xFFFFFFFFU);
+		LOG4CXX_INFO(logger,"Shaders are compiled in parallel.");
+	}
+}
+
+} /* namespace OevGLES */
@@ -0,0 +1,74 @@
+/*
+ * ProgramRegistry.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Knows all GL programs, and starts compiling them in the background at startup.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef PROGRAMREGISTRY_H_
+#define PROGRAMREGISTRY_H_
+
+namespace OevGLES {
+
+/** \brief Registry of all GL programs
+ *
+ * Without the registry each program is compiled and linked when a renderer requests it the first time,
+ * one after the other, and each time the caller waits for the driver.
+ *
+ * \ref prepareAllPrograms() issues compilation and linking of all known programs at once, and returns
+ * without waiting for the results. When the driver supports GL_KHR_parallel_shader_compile it compiles them
+ * in background threads. The link status of a program is only queried when it is used the first time
+ * by its getProgram() method. The start-up can do other work in between, e.g. decode textures.
+ */
+class ProgramRegistry {
+public:
+
+	/** \brief Issue compilation and linking of all known programs.
+	 *
+	 * Call once after the GL context was created.
+	 */
+	static void prepareAllPrograms();
+
+	/// \brief Destroy all programs. Call before the GL context is destroyed.
+	static void destroyAllPrograms();
+
+private:
+
+	/// \brief A known program, and its static methods
+	struct Entry {
+		char const *name;
+		void (*prepareProgram)();
+		void (*destroyProgram)();
+	};
+
+	static Entry const entries[];
+
+	/// \brief Let the driver use as many compiler threads as it likes with GL_KHR_parallel_shader_compile
+	static void enableParallelCompile();
+
+};
+
+} /* namespace OevGLES */
+
+#endif /* PROGRAMREGISTRY_H_ */
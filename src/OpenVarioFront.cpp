@@ -30,16 +30,31 @@
 #endif
 
 #include <unistd.h>
+#include <string.h>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
 #include "OVFCommon.h"
 
 #include "GLES/EGLRenderSurface.h"
 #include "GLES/GLShader.h"
 #include "GLES/GLProgram.h"
+#include "GLES/AssetPack.h"
+#include "GLES/TexHelper/TextureLoader.h"
+#include "GLES/TexHelper/TextureAtlas.h"
+#include "GLPrograms/ProgramRegistry.h"
 #include "Renderers/AnalogHandRenderer.h"
 #include "Renderers/SquareTextureRenderer.h"
+#include "Renderers/TextRenderer.h"
+#include "Renderers/RenderQueue.h"
+#include "Renderers/FrameScheduler.h"
+#include "Renderers/SceneCamera.h"
+#include "Renderers/TransformNode.h"
+#include "Utils/FrameProfiler.h"
 
 
 // Success is defined in X headers, but collides with an enum value in lib Eigen.
@@ -49,8 +64,23 @@
 
 #include "GLES/VecMat.h"
 
+#if !defined READOUT_FONT_FILE
+#	define READOUT_FONT_FILE "/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf"
+#endif
+
 int main(int argint,char** argv) {
 	int rc = 0;
+	// Render into an offscreen target instead of a window, e.g. for CI runs without display
+	bool headless = false;
+
+	for (int i = 1; i < argint; i++) {
+		if (strcmp(argv[i],"--headless") == 0) {
+			headless = true;
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--headless]" << std::endl;
+			return 1;
+		}
+	}
 
 #if defined HAVE_LOG4CXX_H
 	// create a basic configuration as fallback
@@ -62,6 +92,12 @@ int main(int argint,char** argv) {
     log4cxx::LoggerPtr logger = log4cxx::Logger::getLogger("OpenVarioFront");
 #endif // if defined HAVE_LOG4CXX_H
 
+    // Timing of the phases of each frame. The statistics are written when the program ends.
+    OevUtils::FrameProfiler frameProfiler;
+    unsigned const phaseMatrices = frameProfiler.registerPhase("matrices");
+    unsigned const phaseUploads = frameProfiler.registerPhase("uploads");
+    unsigned const phaseDraw = frameProfiler.registerPhase("draw");
+    unsigned const phaseSwap = frameProfiler.registerPhase("swap");
 
     try {
 		OevGLES::Vec4 camPos = {3,4,20,1};
@@ -73,62 +109,167 @@ int main(int argint,char** argv) {
 		OevGLES::Vec4 lightColor {0.5f,0.5f,0.3f,1.0f};
 
 
+		// Precooked textures are uploaded from the mapped pack. Without the pack the single files are decoded.
+		try {
+			OevGLES::AssetPack::getAssetPack().open("OpenVarioFront.pack");
+		} catch (OevGLES::AssetPackException const &e) {
+			LOG4CXX_INFO(logger,e.what() << ". Load the single files instead.");
+		}
+
 		OevGLES::EGLRenderSurface eglSurface;
-		LOG4CXX_INFO(logger,"Create native window, eglSurface and eglContext.");
-		eglSurface.createRenderSurface(640,480,PACKAGE_STRING);
-		LOG4CXX_INFO(logger,"Create the diffuse light program");
+		if (headless) {
+			LOG4CXX_INFO(logger,"Create offscreen eglSurface and eglContext.");
+			eglSurface.createOffscreenSurface(640,480);
+		} else {
+			LOG4CXX_INFO(logger,"Create native window, eglSurface and eglContext.");
+			eglSurface.createRenderSurface(640,480,PACKAGE_STRING);
+		}
+		LOG4CXX_INFO(logger,"Start compiling the programs, and loading the textures");
+		OevGLES::ProgramRegistry::prepareAllPrograms();
 
 		AnalogHandRenderer hand;
 		SquareTextureRenderer varioBackground;
 
+		hand.prefetchResources();
+		varioBackground.prefetchResources();
+
+		// The climb readout is optional. Without the font the instrument works without it.
+		std::unique_ptr<TextRenderer> readouts;
+		TextRenderer::TextId climbText = 0;
+		try {
+			readouts.reset(new TextRenderer(READOUT_FONT_FILE,32,TextRenderer::defaultCharacters,TextRenderer::DistanceFieldGlyphs));
+			climbText = readouts->addText(OevGLES::Vec3 {0.0f,3.0f,-0.95f},1.4f,5,TextRenderer::AlignCenter);
+		} catch (OevGLES::FontException const &e) {
+			LOG4CXX_WARN(logger,e.what() << ". The readouts are not shown.");
+		}
 
 		hand.setupVertexBuffers();
 		varioBackground.setupVertexBuffers();
+		if (readouts) {
+			readouts->setupVertexBuffers();
+		}
+
+		RenderQueue renderQueue;
 
 		GLfloat k = 0.0f;
-		OevGLES::Mat4 modelMatrixBack = OevGLES::Mat4::Identity();
+		OevGLES::Mat4 modelMatrix;
+		OevGLES::Mat4 viewMatrix;
+		OevGLES::Mat4 camRotMatrix;
+
+		// The projection does not change between frames
+		SceneCamera camera;
+		camera.setProjectionMatrix(OevGLES::projectionMatrix(5,35,320.0/240.0,66));
+
+		// The instrument panel carries the dial background and the hand.
+		TransformNode panelNode;
+		TransformNode backgroundNode (&panelNode,&varioBackground);
+		TransformNode handNode (&panelNode,&hand);
+		TransformNode readoutNode (&panelNode,readouts.get());
+		panelNode.updateTransforms(camera);
+
+		// Frames are only drawn when something changed on the screen
+		FrameScheduler frameScheduler (eglSurface);
+		frameScheduler.addItem(backgroundNode);
+		frameScheduler.addItem(handNode);
+		if (readouts) {
+			frameScheduler.addItem(readoutNode);
+		}
+		frameScheduler.setClearColor(OevGLES::Vec4 {0.2f,0.2f,0.01f,1.0f});
+
+		// The camera orbits around the panel. A cached background layer would be re-drawn every frame,
+		// and composited in addition. Therefore the dial background is drawn directly.
+		// The LayerCache pays off with a static camera, see the benchmark option --layer.
+
+		OevGLES::TextureLoader &textureLoader = OevGLES::TextureLoader::getTextureLoader();
 
 		for (GLfloat i = 0.0f; i<360.0f;i += 0.1f) {
 
-			OevGLES::Mat4 modelMatrix = OevGLES::rotationMatrixZ(k) * OevGLES::Mat4::Identity();
-			OevGLES::Mat4 viewMatrix = OevGLES::viewMatrix((OevGLES::rotationMatrixY(i) * camPos).block<3,1>(0,0),origin,up);
-			OevGLES::Mat4 projMatrix = OevGLES::projectionMatrix(5,35,320.0/240.0,66);
-			OevGLES::Mat4 MVMatrix = viewMatrix * modelMatrix;
-			OevGLES::Mat4 MVPMatrix = projMatrix * viewMatrix * modelMatrix;
-			OevGLES::Mat4 MVMatrixBack = viewMatrix * modelMatrixBack;
-			OevGLES::Mat4 MVPMatrixBack = projMatrix * viewMatrix * modelMatrixBack;
+			frameProfiler.beginFrame();
+			frameProfiler.beginPhase(phaseMatrices);
+
+			OevGLES::rotationMatrixZ(modelMatrix,k);
+			handNode.setLocalMatrix(modelMatrix);
+
+			if (readouts) {
+				// The hand points to the right at 0 deg. The dial shows 0 m/s on the left, and 30 deg per m/s.
+				GLfloat const handAngle = fmodf(k,360.0f);
+				GLfloat const climb = std::max(-5.0f,std::min(5.0f,(180.0f - handAngle) / 30.0f));
+				char climbString[8];
+
+				snprintf(climbString,sizeof(climbString),"%+.1f",climb);
+				readouts->setText(climbText,climbString);
+			}
+
+			OevGLES::rotationMatrixY(camRotMatrix,i);
+			OevGLES::viewMatrix(viewMatrix,(camRotMatrix * camPos).block<3,1>(0,0),origin,up);
+			camera.setViewMatrix(viewMatrix);
+
+			// Only changed nodes are re-computed
+			panelNode.updateTransforms(camera);
 
 			// Light dir is in eye space, rotate the light with the viewers point of view
-			lightDir4 = viewMatrix * (OevGLES::rotationMatrixY(i) * OevGLES::Vec4  {-6.0f,10.0f,10.0f,0.0f});
+			lightDir4 = viewMatrix * (camRotMatrix * OevGLES::Vec4  {-6.0f,10.0f,10.0f,0.0f});
 			lightDir = lightDir4.block<3,1>(0,0);
 			lightDir.normalize();
 
-			glClearColor(0.2f,0.2f,0.01f,1.0f);
-			glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+			frameScheduler.setCamera(camera.getViewMatrix(),camera.getProjectionMatrix());
+			frameScheduler.setLight(lightDir,lightColor,ambientLightColor);
+
+			frameProfiler.endPhase(phaseMatrices);
 
-			hand.draw(modelMatrix,viewMatrix,projMatrix,MVMatrix,MVPMatrix,lightDir,lightColor,ambientLightColor);
-			varioBackground.draw(modelMatrixBack,viewMatrix,projMatrix,MVMatrixBack,MVPMatrixBack,lightDir,lightColor,ambientLightColor);
+			// Textures which were decoded in the background. Limited to a part of the frame time.
+			{
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseUploads);
+				textureLoader.processUploads(std::chrono::microseconds(2000));
+			}
+
+			bool frameDrawn;
+			{
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseDraw);
+				frameDrawn = frameScheduler.drawFrame(renderQueue);
+			}
 
 			// sleep(3);
 
-			eglSwapBuffers(eglSurface.getDisplay(),eglSurface.getRenderSurface());
+			if (frameDrawn) {
+				OevUtils::FrameProfiler::ScopedPhase phase (frameProfiler,phaseSwap);
+				frameScheduler.swapBuffers();
+			}
+
+			frameProfiler.endFrame();
 
 			k += 1.0f;
 		}
 
-		sleep(10);
+		if (!headless) {
+			sleep(10);
+		}
 
-		LOG4CXX_INFO(logger,"Destroy the diffuse light program");
-		OevGLES::GLProgDiffuseLight::destroyProgram();
+		LOG4CXX_INFO(logger,"Destroy the programs and the texture atlas");
+		OevGLES::ProgramRegistry::destroyAllPrograms();
+		OevGLES::TextureAtlas::getTextureAtlas().clear();
+		OevGLES::AssetPack::getAssetPack().close();
 
 	    LOG4CXX_INFO(logger,"Destroy eglSurface and eglContext and native window.");
 
 	} catch (std::exception const& e) {
 		std::cerr << e.what() << std::endl;
+		// Unattended runs must see the failure
+		rc = 1;
+	}
+
+	// After a failure the statistics cover only a part of the run, and must not be compared with complete runs.
+	if (rc == 0) {
+		frameProfiler.logSummary();
+		frameProfiler.writeSummaryFile("OpenVarioFront.frameStats");
+	} else {
+		LOG4CXX_WARN(logger,"The run failed. The frame statistics are incomplete, and are not written.");
 	}
 
 
-	sleep(3);
+	if (!headless) {
+		sleep(3);
+	}
 
 	return rc;
 }
@@ -27,6 +27,8 @@
 #  include <config.h>
 #endif
 
+#include <algorithm>
+
 #include "Renderers/AnalogHandRenderer.h"
 
 #include "OVFCommon.h"
@@ -111,6 +113,29 @@ AnalogHandRenderer::AnalogHandRenderer()
 #endif
 		}
 
+		// The triangles do not share vertexes because the normals differ. The mesh is still indexed, and optimized
+		// like all geometry.
+		for (int i = 0; i < 4; i++) {
+			GLfloat triangle[3][6];
+
+			for (int k = 0; k < 3; k++) {
+				GLfloat const *vertex = vertexArray + (i * 24) + (k * 8);
+
+				std::copy(vertex,vertex + 3,triangle[k]);
+				std::copy(vertex + 4,vertex + 7,triangle[k] + 3);
+			}
+			handMesh.addTriangle(triangle[0],triangle[1],triangle[2]);
+		}
+
+#if defined HAVE_LOG4CXX_H
+		OevGLES::Mesh::Statistics const statistics = handMesh.optimize();
+		LOG4CXX_INFO(logger,"Hand mesh: " << statistics.numTriangles << " triangles, " << statistics.numAddedVertexes
+				<< " vertexes reduced to " << statistics.numVertexes << ", ACMR " << statistics.acmrBefore
+				<< " -> " << statistics.acmrAfter);
+#else
+		handMesh.optimize();
+#endif
+
 	}
 
 
@@ -119,15 +144,19 @@ AnalogHandRenderer::~AnalogHandRenderer() { }
 void AnalogHandRenderer::setupVertexBuffers() {
 
 	// First get the program
-	glProgram = OevGLES::GLProgDiffuseLight::getProgram();
+	glProgram = Program::getProgram();
 
 	// make the program current
 	glProgram->useProgram();
 
-	glGenBuffers(1,&vertexBufferHandle);
-	glBindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(vertexArray),vertexArray,GL_STATIC_DRAW);
+	// The format depends on the extensions of the GPU
+	handMesh.setupBuffers(OevGLES::VertexFormat {
+		{Program::vertexPos,3,OevGLES::VertexFormat::HalfFloat,false},
+		{Program::vertexNormal,3,OevGLES::VertexFormat::Byte,true}
+	});
 
+	// New geometry must be drawn
+	markDirty();
 
 }
 
@@ -138,54 +167,62 @@ void AnalogHandRenderer::draw(
 		const OevGLES::Vec3& lightDir, const OevGLES::Vec4& lightColor,
 		const OevGLES::Vec4& ambientLightColor ) {
 
-	GLfloat* bufferOffset = 0;
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
 
 	// make my program current
 	glProgram->useProgram();
 
 
 	LOG4CXX_DEBUG(logger,"lightDir = " << lightDir.transpose());
-	GLfloat* p0 = vertexArray;
-	for (int k = 0;k < 6 ; k+= 2) {
-		Eigen::Map<OevGLES::Vec4> vecXNormal4 ( p0 + (k*4) + 4);
-		OevGLES::Vec3 vecXNormal = (MVMatrix * vecXNormal4).block<3,1>(0,0);
-
-		LOG4CXX_DEBUG(logger,"Vec4 [" << k << "] Normal = [" << vecXNormal4.transpose() << ']');
-		LOG4CXX_DEBUG(logger,"Vec4 [" << k << "] MVMatrix * Normal = [" << vecXNormal.transpose() << ']');
-		LOG4CXX_DEBUG(logger,"lightDir dot normal = " << lightDir.dot(vecXNormal));
-
-	}
 
-	// Set the uniforms
-	glUniformMatrix4fv(glProgram->getMvpMatrixLocation(),1,GL_FALSE,&(MVPMatrix(0,0)));
-	glUniformMatrix4fv(glProgram->getMvMatrixLocation(),1,GL_FALSE,&(MVMatrix(0,0)));
+	// Set the uniforms. Values which did not change since the last draw are not uploaded again.
+	glProgram->setUniform<Program::mvpMatrix>(MVPMatrix);
+	glProgram->setUniform<Program::mvMatrix>(MVMatrix);
 
-	glUniform3fv(glProgram->getLightDirLocation(),1,&(lightDir(0)));
-	glUniform4fv(glProgram->getLightColorLocation(),1,&(lightColor(0)));
-	glUniform4fv(glProgram->getAmbientLightColorLocation(),1,&(ambientLightColor(0)));
+	glProgram->setUniform<Program::lightDir>(lightDir);
+	glProgram->setUniform<Program::lightColor>(lightColor);
+	glProgram->setUniform<Program::ambientLightColor>(ambientLightColor);
 
 
 	// set the color attribute constant
-	glDisableVertexAttribArray(glProgram->getVertexColorLocation());
-	glVertexAttrib4fv(glProgram->getVertexColorLocation(),handColor);
+	stateCache.disableVertexAttribArray(glProgram->getAttributeLocation(Program::vertexColor));
+	stateCache.vertexAttrib4fv(glProgram->getAttributeLocation(Program::vertexColor),handColor);
 
-	// re-bind the buffer object
-	glBindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	// re-bind the buffer objects
+	handMesh.bindBuffers();
 
-	// setup the vertex coordinates
-	glEnableVertexAttribArray(glProgram->getVertexPosLocation());
-	glVertexAttribPointer(glProgram->getVertexPosLocation(),4,GL_FLOAT,GL_FALSE,8 * sizeof (GLfloat),bufferOffset);
-	// setup the vertex coordinates
-	bufferOffset += 4; // Advance the offset by 4 floats to the vertex normals.
-	glEnableVertexAttribArray(glProgram->getVertexNormalLocation());
-	glVertexAttribPointer(glProgram->getVertexNormalLocation(),4,GL_FLOAT,GL_FALSE,8 * sizeof (GLfloat),bufferOffset);
+	// setup the vertex coordinates and normals
+	handMesh.getVertexFormat().setupAttributes(*glProgram);
 
 	// The object is opaque. Use the depth buffer, and write to the depth buffer
-	glDepthMask(GL_TRUE);
-	glEnable(GL_DEPTH_TEST);
+	applyBlendDepthMode(getRenderState());
 
-	glDrawArrays(GL_TRIANGLES,0,12);
+	handMesh.drawTriangles();
 
 
 }
 
+RendererBase::RenderState AnalogHandRenderer::getRenderState() const {
+	RenderState renderState;
+
+	if (glProgram) {
+		renderState.program = glProgram->getGLProgram().getProgramHandle();
+	}
+
+	return renderState;
+}
+
+bool AnalogHandRenderer::getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const {
+
+	minCorner = Eigen::Map<OevGLES::Vec3 const>(vertexArray);
+	maxCorner = minCorner;
+
+	for (int i = 1; i < 12; i++) {
+		Eigen::Map<OevGLES::Vec3 const> pos (vertexArray + (i * 8));
+
+		minCorner = minCorner.cwiseMin(pos);
+		maxCorner = maxCorner.cwiseMax(pos);
+	}
+
+	return true;
+}
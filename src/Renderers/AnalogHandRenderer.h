@@ -28,6 +28,8 @@
 
 #include "GLPrograms/GLProgDiffuseLight.h"
 #include "Renderers/RendererBase.h"
+#include "GLES/VertexFormat.h"
+#include "GLES/Mesh.h"
 
 class AnalogHandRenderer : public RendererBase {
 public:
@@ -61,6 +63,20 @@ public:
 			OevGLES::Vec4 const &ambientLightColor
 			)  override;
 
+	/** \brief Return the GL state which is used by \ref draw().
+	 *
+	 * @return Program, texture, blend and depth mode of the renderer
+	 */
+	virtual RenderState getRenderState() const override;
+
+	/** \brief Axis aligned bounding box of the object in model space
+	 *
+	 * @param[out] minCorner Corner with the minimum coordinates
+	 * @param[out] maxCorner Corner with the maximum coordinates
+	 * @return true
+	 */
+	virtual bool getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const override;
+
 
 private:
 
@@ -68,6 +84,7 @@ private:
 	//	0123	4567
 	//	Pos		Normal
 	// The color for the hand is constant vertex attribute, therefore not part of the vertex array
+	// The array is the geometry in model space. The \ref handMesh holds it indexed in a compact vertex format.
 
 	// The hand has 4 triangles. Since I do not want to smooth colors the normals per triangle must be constant per triangle.
 	// This means I cannot use a triangle strip or fan.
@@ -78,9 +95,12 @@ private:
 
 	GLfloat handColor [4] = {1.0f,1.0f,0.7f,1.0f};
 
-	OevGLES::GLProgDiffuseLight* glProgram = 0;
+	/// \brief The program, and the names of its uniforms and attributes
+	typedef OevGLES::GLProgDiffuseLight Program;
+	Program *glProgram = nullptr;
 
-	GLuint vertexBufferHandle = 0;
+	/// \brief Per vertex 3 floats position, and 3 floats normal. Uploaded as half float positions, and packed normals in bytes.
+	OevGLES::Mesh handMesh {6};
 
 
 };
@@ -0,0 +1,339 @@
+/*
+ * FrameScheduler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  On-demand rendering. Draws a frame only when something changed, and redraws only the damaged region.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+#include "OVFCommon.h"
+
+#include "Renderers/FrameScheduler.h"
+#include "GLES/GLStateCache.h"
+
+#if defined HAVE_LOG4CXX_H
+	static log4cxx::LoggerPtr logger = 0;
+#endif
+
+FrameScheduler::FrameScheduler(OevGLES::EGLRenderSurface &surface)
+	:surface {surface},
+	 viewMatrix {OevGLES::Mat4::Identity()},
+	 projMatrix {OevGLES::Mat4::Identity()},
+	 viewProjMatrix {OevGLES::Mat4::Identity()},
+	 lightDir {0.0f,0.0f,1.0f},
+	 lightColor {1.0f,1.0f,1.0f,1.0f},
+	 ambientLightColor {0.0f,0.0f,0.0f,1.0f},
+	 clearColor {0.0f,0.0f,0.0f,1.0f}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.FrameScheduler");
+	}
+#endif
+}
+
+FrameScheduler::~FrameScheduler() {
+}
+
+FrameScheduler::ItemId FrameScheduler::addItem(RendererBase &renderer,OevGLES::Mat4 const &modelMatrix) {
+
+	items.emplace_back();
+	Item &item = items.back();
+
+	item.modelMatrix = modelMatrix;
+	item.renderer = &renderer;
+	item.node = nullptr;
+	item.nodeWorldVersion = 0;
+	item.matrixChanged = true;
+
+	return ItemId(items.size() - 1);
+}
+
+FrameScheduler::ItemId FrameScheduler::addItem(TransformNode &node) {
+
+	items.emplace_back();
+	Item &item = items.back();
+
+	item.modelMatrix = node.getWorldMatrix();
+	item.renderer = node.getRenderer();
+	item.node = &node;
+	item.nodeWorldVersion = node.getWorldVersion();
+	item.matrixChanged = true;
+
+	return ItemId(items.size() - 1);
+}
+
+void FrameScheduler::syncNodeItems() {
+
+	for (auto &item : items) {
+		if (item.node && item.node->getWorldVersion() != item.nodeWorldVersion) {
+			item.modelMatrix = item.node->getWorldMatrix();
+			item.nodeWorldVersion = item.node->getWorldVersion();
+			item.matrixChanged = true;
+		}
+	}
+}
+
+void FrameScheduler::setModelMatrix(ItemId itemId,OevGLES::Mat4 const &modelMatrix) {
+	Item &item = items.at(itemId);
+
+	if (item.modelMatrix != modelMatrix) {
+		item.modelMatrix = modelMatrix;
+		item.matrixChanged = true;
+	}
+}
+
+void FrameScheduler::setCamera(OevGLES::Mat4 const &viewMatrix,OevGLES::Mat4 const &projMatrix) {
+
+	if (this->viewMatrix != viewMatrix || this->projMatrix != projMatrix) {
+		this->viewMatrix = viewMatrix;
+		this->projMatrix = projMatrix;
+		OevGLES::multiplyMat4(viewProjMatrix,projMatrix,viewMatrix);
+		fullRedraw = true;
+	}
+}
+
+void FrameScheduler::setLight(OevGLES::Vec3 const &lightDir,OevGLES::Vec4 const &lightColor,OevGLES::Vec4 const &ambientLightColor) {
+
+	if (this->lightDir != lightDir || this->lightColor != lightColor || this->ambientLightColor != ambientLightColor) {
+		this->lightDir = lightDir;
+		this->lightColor = lightColor;
+		this->ambientLightColor = ambientLightColor;
+		fullRedraw = true;
+	}
+}
+
+void FrameScheduler::setClearColor(OevGLES::Vec4 const &clearColor) {
+
+	if (this->clearColor != clearColor) {
+		this->clearColor = clearColor;
+		fullRedraw = true;
+	}
+}
+
+bool FrameScheduler::isFrameNeeded() const {
+
+	if (fullRedraw) {
+		return true;
+	}
+
+	for (auto const &item : items) {
+		if (item.matrixChanged || item.renderer->isDirty() ||
+				(item.node && item.node->getWorldVersion() != item.nodeWorldVersion)) {
+			return true;
+		}
+	}
+
+	if (layerCache) {
+		return layerCache->isUpdateNeeded(viewMatrix,projMatrix,lightDir,lightColor,ambientLightColor,clearColor);
+	}
+
+	return false;
+}
+
+FrameScheduler::DamageRect FrameScheduler::fullScreenRect() const {
+	DamageRect rect;
+
+	rect.width = surface.getWidth();
+	rect.height = surface.getHeight();
+
+	return rect;
+}
+
+FrameScheduler::DamageRect FrameScheduler::computeScreenRect(Item const &item) const {
+	OevGLES::Vec3 minCorner;
+	OevGLES::Vec3 maxCorner;
+	DamageRect const fullRect = fullScreenRect();
+
+	if (!item.renderer->getBoundingBox(minCorner,maxCorner)) {
+		return fullRect;
+	}
+
+	OevGLES::Mat4 MVPMatrix;
+	OevGLES::multiplyMat4(MVPMatrix,viewProjMatrix,item.modelMatrix);
+	GLfloat minX = std::numeric_limits<GLfloat>::max();
+	GLfloat minY = minX;
+	GLfloat maxX = -minX;
+	GLfloat maxY = -minX;
+
+	for (int i = 0; i < 8; i++) {
+		OevGLES::Vec4 const corner {
+			(i & 1) ? maxCorner(0) : minCorner(0),
+			(i & 2) ? maxCorner(1) : minCorner(1),
+			(i & 4) ? maxCorner(2) : minCorner(2),
+			1.0f};
+		OevGLES::Vec4 const clipPos = MVPMatrix * corner;
+
+		if (clipPos(3) <= 1.0e-6f) {
+			// The box reaches behind the viewer. The projection of the corners is meaningless.
+			return fullRect;
+		}
+
+		// Normalized device coordinates to window coordinates like glViewport does
+		GLfloat const x = (clipPos(0) / clipPos(3) * 0.5f + 0.5f) * GLfloat(fullRect.width);
+		GLfloat const y = (clipPos(1) / clipPos(3) * 0.5f + 0.5f) * GLfloat(fullRect.height);
+
+		minX = std::min(minX,x);
+		maxX = std::max(maxX,x);
+		minY = std::min(minY,y);
+		maxY = std::max(maxY,y);
+	}
+
+	// One pixel margin for rasterization rounding and multi-sampling
+	DamageRect rect;
+	rect.x = EGLint(floorf(minX)) - 1;
+	rect.y = EGLint(floorf(minY)) - 1;
+	rect.width = EGLint(ceilf(maxX)) + 1 - rect.x;
+	rect.height = EGLint(ceilf(maxY)) + 1 - rect.y;
+
+	rect.intersect(fullRect);
+
+	return rect;
+}
+
+bool FrameScheduler::drawFrame(RenderQueue &renderQueue) {
+	DamageRect const fullRect = fullScreenRect();
+	DamageRect damage;
+	DamageRect repaint;
+	bool partial;
+
+	syncNodeItems();
+
+	if (!isFrameNeeded()) {
+		numFramesSkipped++;
+		return false;
+	}
+
+	// The layer covers the complete screen. When its content changed everything must be redrawn.
+	if (layerCache &&
+			layerCache->update(renderQueue,viewMatrix,projMatrix,lightDir,lightColor,ambientLightColor,clearColor)) {
+		fullRedraw = true;
+	}
+
+	// Collect the old and new screen areas of all changed items
+	for (auto &item : items) {
+		if (fullRedraw || item.matrixChanged || item.renderer->isDirty()) {
+			DamageRect const newRect = computeScreenRect(item);
+
+			damage.unite(item.screenRect);
+			damage.unite(newRect);
+			item.screenRect = newRect;
+			item.matrixChanged = false;
+		}
+	}
+
+	if (fullRedraw) {
+		damage = fullRect;
+	}
+	frameDamage = damage;
+
+	// The back buffer misses the damage of the frames since it was presented last time.
+	{
+		EGLint const bufferAge = surface.getBufferAge();
+
+		repaint = damage;
+
+		if (bufferAge <= 0 || size_t(bufferAge - 1) > damageHistory.size()) {
+			repaint = fullRect;
+		} else {
+			for (EGLint i = 0; i < bufferAge - 1; i++) {
+				repaint.unite(damageHistory[i]);
+			}
+		}
+	}
+
+	damageHistory.push_front(damage);
+	if (damageHistory.size() > maxDamageHistory) {
+		damageHistory.pop_back();
+	}
+
+	partial = repaint.x > fullRect.x || repaint.y > fullRect.y ||
+			repaint.width < fullRect.width || repaint.height < fullRect.height;
+
+	LOG4CXX_TRACE(logger,"Frame " << numFramesDrawn << ": damage = "
+			<< damage.x << ',' << damage.y << ' ' << damage.width << 'x' << damage.height
+			<< ", repaint = " << repaint.x << ',' << repaint.y << ' ' << repaint.width << 'x' << repaint.height);
+
+	damageList.assign(1,repaint);
+	surface.setDamageRegion(damageList);
+
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
+
+	if (partial) {
+		stateCache.enable(GL_SCISSOR_TEST);
+		glScissor(repaint.x,repaint.y,repaint.width,repaint.height);
+		numPartialFrames++;
+	} else {
+		stateCache.disable(GL_SCISSOR_TEST);
+	}
+
+	// The depth buffer must be writable to be cleared
+	stateCache.depthMask(GL_TRUE);
+	if (layerCache) {
+		// The layer overwrites the color buffer anyway
+		glClear(GL_DEPTH_BUFFER_BIT);
+		layerCache->composite();
+	} else {
+		glClearColor(clearColor(0),clearColor(1),clearColor(2),clearColor(3));
+		glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+	}
+
+	renderQueue.beginFrame(viewMatrix,projMatrix,lightDir,lightColor,ambientLightColor);
+
+	for (auto &item : items) {
+		DamageRect overlap = item.screenRect;
+
+		overlap.intersect(repaint);
+		if (!overlap.isEmpty()) {
+			if (item.node) {
+				renderQueue.submit(*item.node);
+			} else {
+				renderQueue.submit(*item.renderer,item.modelMatrix);
+			}
+		}
+	}
+
+	renderQueue.flush();
+
+	for (auto &item : items) {
+		item.renderer->clearDirty();
+	}
+
+	fullRedraw = false;
+	numFramesDrawn++;
+
+	return true;
+}
+
+void FrameScheduler::swapBuffers() {
+
+	damageList.assign(1,frameDamage);
+	surface.swapBuffers(damageList);
+}
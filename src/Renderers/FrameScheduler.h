@@ -0,0 +1,243 @@
+/*
+ * FrameScheduler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  On-demand rendering. Draws a frame only when something changed, and redraws only the damaged region.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RENDERERS_FRAMESCHEDULER_H_
+#define RENDERERS_FRAMESCHEDULER_H_
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+#include "GLES/EGLRenderSurface.h"
+#include "Renderers/RenderQueue.h"
+#include "Renderers/LayerCache.h"
+
+/** \brief On-demand frame scheduler
+ *
+ * The scheduler knows all objects on the screen with their model matrices, and the camera and light.
+ * The render loop updates these values every cycle. A frame is only drawn when something changed:
+ * - A renderer marked itself dirty with \ref RendererBase::markDirty()
+ * - The model matrix of an item changed
+ * - Camera, light or clear color changed (always a full redraw)
+ *
+ * The damaged screen region is the bounding rectangle of the old and new screen areas of all changed items.
+ * The screen areas are computed from the bounding boxes of the renderers.
+ *
+ * When the back buffer content is known from EGL_EXT_buffer_age (or the target is an offscreen buffer)
+ * only the damaged region of the current frame and the frames which the back buffer missed is redrawn.
+ * Drawing is restricted with the scissor test, and EGL_KHR_partial_update when available.
+ * The damage of the frame is passed to eglSwapBuffersWithDamage when available.
+ * Without buffer age the complete frame is redrawn, but the damage is still passed on.
+ *
+ * Static objects can be put into a \ref LayerCache instead of adding them as items.
+ * The layer is then copied into the frame instead of clearing the color buffer.
+ * When the layer content changes the complete frame is redrawn.
+ */
+class FrameScheduler {
+public:
+
+	typedef OevGLES::EGLRenderSurface::DamageRect DamageRect;
+
+	/// \brief Identifies an item added with \ref addItem()
+	typedef unsigned ItemId;
+
+	/** \brief Constructor
+	 *
+	 * @param surface The render surface. Must be created already.
+	 */
+	FrameScheduler(OevGLES::EGLRenderSurface &surface);
+
+	virtual ~FrameScheduler();
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	/** \brief Add an object to the scene
+	 *
+	 * @param renderer Renderer of the object. Must stay valid as long as the scheduler exists.
+	 * @param modelMatrix Initial model matrix
+	 * @return Id of the item for \ref setModelMatrix()
+	 */
+	ItemId addItem(RendererBase &renderer,OevGLES::Mat4 const &modelMatrix);
+
+	/** \brief Add an object of the transform hierarchy to the scene
+	 *
+	 * The model matrix is taken from the world matrix of the node. Changes are detected by the world version of the node.
+	 * The cached MV and MVP matrices of the node are used for drawing, therefore the node must be updated with
+	 * the same camera which is passed to \ref setCamera().
+	 *
+	 * @param node Node with a renderer. Must stay valid as long as the scheduler exists.
+	 * @return Id of the item
+	 */
+	ItemId addItem(TransformNode &node);
+
+	/** \brief Update the model matrix of an item. The item is redrawn when the matrix changed.
+	 *
+	 * @param item Id returned by \ref addItem()
+	 * @param modelMatrix New model matrix
+	 */
+	void setModelMatrix(ItemId item,OevGLES::Mat4 const &modelMatrix);
+
+	/** \brief Update the camera. When it changed the complete frame is redrawn.
+	 *
+	 * @param viewMatrix View matrix
+	 * @param projMatrix Projection matrix
+	 */
+	void setCamera(OevGLES::Mat4 const &viewMatrix,OevGLES::Mat4 const &projMatrix);
+
+	/** \brief Update the lights. When they changed the complete frame is redrawn.
+	 *
+	 * @param lightDir Direction of the light in eye space
+	 * @param lightColor Color of the directional light
+	 * @param ambientLightColor Color of the ambient light
+	 */
+	void setLight(OevGLES::Vec3 const &lightDir,OevGLES::Vec4 const &lightColor,OevGLES::Vec4 const &ambientLightColor);
+
+	/** \brief Set the background color. When it changed the complete frame is redrawn.
+	 *
+	 * @param clearColor RGBA
+	 */
+	void setClearColor(OevGLES::Vec4 const &clearColor);
+
+	/** \brief Use a cached layer as background of the frame
+	 *
+	 * @param layerCache Layer with the static objects. Must stay valid as long as the scheduler exists. nullptr removes the layer.
+	 */
+	void setLayerCache(LayerCache *layerCache) {
+		this->layerCache = layerCache;
+		fullRedraw = true;
+	}
+
+	/// \brief Force a complete redraw with the next frame, e.g. after the window was exposed.
+	void invalidate() {
+		fullRedraw = true;
+	}
+
+	/** \brief Anything changed since the last frame?
+	 *
+	 * @return true when \ref drawFrame() would draw something
+	 */
+	bool isFrameNeeded() const;
+
+	/** \brief Draw the damaged region of the frame through the render queue.
+	 *
+	 * When nothing changed nothing is drawn, and false is returned. Do not call \ref swapBuffers() then.
+	 *
+	 * @param renderQueue Queue which sorts and draws the items
+	 * @return true when a frame was drawn
+	 */
+	bool drawFrame(RenderQueue &renderQueue);
+
+	/// \brief Present the frame which was drawn by \ref drawFrame(), and pass the damage to EGL.
+	void swapBuffers();
+
+	/// \brief Damaged region of the last drawn frame
+	DamageRect const &getFrameDamage() const {
+		return frameDamage;
+	}
+
+	/// \brief Number of frames drawn by \ref drawFrame()
+	uint64_t getNumFramesDrawn() const {
+		return numFramesDrawn;
+	}
+
+	/// \brief Number of calls of \ref drawFrame() which drew nothing
+	uint64_t getNumFramesSkipped() const {
+		return numFramesSkipped;
+	}
+
+	/// \brief Number of frames which were only partially redrawn
+	uint64_t getNumPartialFrames() const {
+		return numPartialFrames;
+	}
+
+private:
+
+	/// \brief An object on the screen
+	struct Item {
+		OevGLES::Mat4 modelMatrix;
+		RendererBase *renderer;
+		/// \brief Transform node which provides the matrices, or nullptr
+		TransformNode *node;
+		/// \brief World version of the node when the model matrix was taken over
+		uint64_t nodeWorldVersion;
+		/// \brief Screen area of the object when it was drawn last time
+		DamageRect screenRect;
+		bool matrixChanged;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	/// \brief Number of past frame damages which are kept to repair older back buffers
+	static constexpr unsigned maxDamageHistory = 4;
+
+	OevGLES::EGLRenderSurface &surface;
+
+	std::vector<Item,Eigen::aligned_allocator<Item>> items;
+
+	OevGLES::Mat4 viewMatrix;
+	OevGLES::Mat4 projMatrix;
+	OevGLES::Mat4 viewProjMatrix;
+	OevGLES::Vec3 lightDir;
+	OevGLES::Vec4 lightColor;
+	OevGLES::Vec4 ambientLightColor;
+	OevGLES::Vec4 clearColor;
+
+	/// \brief Optional background layer
+	LayerCache *layerCache = nullptr;
+
+	/// \brief Camera, light or clear color changed, or the first frame
+	bool fullRedraw = true;
+
+	/// \brief Damage of the last frame which was drawn
+	DamageRect frameDamage;
+
+	/// \brief Damages of the last frames, the newest first
+	std::deque<DamageRect> damageHistory;
+
+	/// \brief Scratch vector for passing the damage to the surface
+	std::vector<DamageRect> damageList;
+
+	uint64_t numFramesDrawn = 0;
+	uint64_t numFramesSkipped = 0;
+	uint64_t numPartialFrames = 0;
+
+	/// \brief The complete render target
+	DamageRect fullScreenRect() const;
+
+	/// \brief Take over the world matrices of transform nodes which changed
+	void syncNodeItems();
+
+	/** \brief Screen area covered by the bounding box of the item
+	 *
+	 * @param item The item
+	 * @return Screen area in pixels, the full screen when the bounding box is unknown, or crosses the eye plane.
+	 */
+	DamageRect computeScreenRect(Item const &item) const;
+
+};
+
+#endif /* RENDERERS_FRAMESCHEDULER_H_ */
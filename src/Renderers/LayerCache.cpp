@@ -0,0 +1,207 @@
+/*
+ * LayerCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Renders static objects once into an offscreen layer, and composites the layer into every frame.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include "OVFCommon.h"
+
+#include "Renderers/LayerCache.h"
+#include "GLES/GLStateCache.h"
+
+#if defined HAVE_LOG4CXX_H
+	static log4cxx::LoggerPtr logger = 0;
+#endif
+
+LayerCache::LayerCache(OevGLES::EGLRenderSurface &surface)
+	:surface {surface}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.LayerCache");
+	}
+#endif
+}
+
+LayerCache::~LayerCache() {
+	if (vertexBufferHandle != 0) {
+		OevGLES::GLStateCache::getStateCache().deleteBuffer(vertexBufferHandle);
+	}
+}
+
+LayerCache::ItemId LayerCache::addItem(RendererBase &renderer,OevGLES::Mat4 const &modelMatrix) {
+
+	items.emplace_back();
+	Item &item = items.back();
+
+	item.modelMatrix = modelMatrix;
+	item.renderer = &renderer;
+
+	layerInvalid = true;
+
+	return ItemId(items.size() - 1);
+}
+
+void LayerCache::setModelMatrix(ItemId itemId,OevGLES::Mat4 const &modelMatrix) {
+	Item &item = items.at(itemId);
+
+	if (item.modelMatrix != modelMatrix) {
+		item.modelMatrix = modelMatrix;
+		layerInvalid = true;
+	}
+}
+
+bool LayerCache::isUpdateNeeded(
+		OevGLES::Mat4 const &viewMatrix,
+		OevGLES::Mat4 const &projMatrix,
+		OevGLES::Vec3 const &lightDir,
+		OevGLES::Vec4 const &lightColor,
+		OevGLES::Vec4 const &ambientLightColor,
+		OevGLES::Vec4 const &clearColor
+		) const {
+
+	if (layerInvalid) {
+		return true;
+	}
+
+	if (renderedInputs.viewMatrix != viewMatrix ||
+			renderedInputs.projMatrix != projMatrix ||
+			renderedInputs.lightDir != lightDir ||
+			renderedInputs.lightColor != lightColor ||
+			renderedInputs.ambientLightColor != ambientLightColor ||
+			renderedInputs.clearColor != clearColor) {
+		return true;
+	}
+
+	for (auto const &item : items) {
+		if (item.renderer->isDirty()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool LayerCache::update(
+		RenderQueue &renderQueue,
+		OevGLES::Mat4 const &viewMatrix,
+		OevGLES::Mat4 const &projMatrix,
+		OevGLES::Vec3 const &lightDir,
+		OevGLES::Vec4 const &lightColor,
+		OevGLES::Vec4 const &ambientLightColor,
+		OevGLES::Vec4 const &clearColor
+		) {
+
+	if (!isUpdateNeeded(viewMatrix,projMatrix,lightDir,lightColor,ambientLightColor,clearColor)) {
+		return false;
+	}
+
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
+
+	LOG4CXX_DEBUG(logger,"Draw layer with " << items.size() << " items");
+
+	// Only re-allocated when the size of the surface changed
+	renderTarget.create(surface.getWidth(),surface.getHeight(),true);
+	renderTarget.bind();
+
+	stateCache.disable(GL_SCISSOR_TEST);
+	stateCache.depthMask(GL_TRUE);
+	glClearColor(clearColor(0),clearColor(1),clearColor(2),clearColor(3));
+	glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+
+	renderQueue.beginFrame(viewMatrix,projMatrix,lightDir,lightColor,ambientLightColor);
+	for (auto const &item : items) {
+		renderQueue.submit(*item.renderer,item.modelMatrix);
+	}
+	renderQueue.flush();
+
+	surface.bindFramebuffer();
+
+	for (auto &item : items) {
+		item.renderer->clearDirty();
+	}
+
+	renderedInputs.viewMatrix = viewMatrix;
+	renderedInputs.projMatrix = projMatrix;
+	renderedInputs.lightDir = lightDir;
+	renderedInputs.lightColor = lightColor;
+	renderedInputs.ambientLightColor = ambientLightColor;
+	renderedInputs.clearColor = clearColor;
+	layerInvalid = false;
+
+	numUpdates++;
+
+	return true;
+}
+
+void LayerCache::setupCompositeQuad() {
+
+	// Screen filling quad in normalized device coordinates as triangle strip
+	static GLfloat const quadVertexes[] = {
+			-1.0f,-1.0f,
+			 1.0f,-1.0f,
+			-1.0f, 1.0f,
+			 1.0f, 1.0f
+	};
+
+	glProgram = Program::getProgram();
+
+	glGenBuffers(1,&vertexBufferHandle);
+	OevGLES::GLStateCache::getStateCache().bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	glBufferData(GL_ARRAY_BUFFER,sizeof(quadVertexes),quadVertexes,GL_STATIC_DRAW);
+
+}
+
+void LayerCache::composite() {
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
+
+	if (!renderTarget.isCreated()) {
+		return;
+	}
+
+	if (!glProgram) {
+		setupCompositeQuad();
+	}
+
+	glProgram->useProgram();
+
+	stateCache.bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	stateCache.enableVertexAttribArray(glProgram->getAttributeLocation(Program::vertexPos));
+	glVertexAttribPointer(glProgram->getAttributeLocation(Program::vertexPos),2,GL_FLOAT,GL_FALSE,2 * sizeof(GLfloat),0);
+
+	renderTarget.getColorTexture().bindToUniformLocation(GL_TEXTURE0,0,glProgram->getGLProgram(),glProgram->getUniformLocation(Program::texture0));
+
+	// The layer replaces the background. No blending, and no depth values which would hide the dynamic objects.
+	stateCache.disable(GL_BLEND);
+	stateCache.disable(GL_DEPTH_TEST);
+	stateCache.depthMask(GL_FALSE);
+
+	glDrawArrays(GL_TRIANGLE_STRIP,0,4);
+
+	numComposites++;
+}
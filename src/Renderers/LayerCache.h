@@ -0,0 +1,191 @@
+/*
+ * LayerCache.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Renders static objects once into an offscreen layer, and composites the layer into every frame.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RENDERERS_LAYERCACHE_H_
+#define RENDERERS_LAYERCACHE_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "GLES/EGLRenderSurface.h"
+#include "GLES/GLRenderTarget.h"
+#include "GLPrograms/GLProgTexturedQuad.h"
+#include "Renderers/RenderQueue.h"
+
+/** \brief Cache of static objects in an offscreen layer
+ *
+ * Objects which do not move relative to the camera, like the dial background, are expensive to draw
+ * every frame on fill-rate bound GPUs. The layer cache draws them once into a texture of the size of the screen
+ * together with the background color. Each frame then only copies the texture with one screen filling quad,
+ * and the dynamic objects like the needles are drawn on top of it.
+ *
+ * The layer is drawn again when any of its inputs changes:
+ * - A renderer in the layer is dirty, see \ref RendererBase::markDirty()
+ * - The model matrix of an object in the layer changed
+ * - Camera, light or background color changed
+ *
+ * The layer has no depth information in the frame. Dynamic objects are always drawn in front of it.
+ */
+class LayerCache {
+public:
+
+	/// \brief Identifies an item added with \ref addItem()
+	typedef unsigned ItemId;
+
+	/** \brief Constructor
+	 *
+	 * @param surface The render surface. Must be created already. The layer has the same size.
+	 */
+	LayerCache(OevGLES::EGLRenderSurface &surface);
+
+	virtual ~LayerCache();
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	/** \brief Add a static object to the layer
+	 *
+	 * @param renderer Renderer of the object. Must stay valid as long as the layer cache exists.
+	 * @param modelMatrix Model matrix of the object
+	 * @return Id of the item for \ref setModelMatrix()
+	 */
+	ItemId addItem(RendererBase &renderer,OevGLES::Mat4 const &modelMatrix);
+
+	/** \brief Update the model matrix of an item. The layer is drawn again when the matrix changed.
+	 *
+	 * @param item Id returned by \ref addItem()
+	 * @param modelMatrix New model matrix
+	 */
+	void setModelMatrix(ItemId item,OevGLES::Mat4 const &modelMatrix);
+
+	/** \brief Check if the layer must be drawn again with these inputs
+	 *
+	 * @param viewMatrix View matrix
+	 * @param projMatrix Projection matrix
+	 * @param lightDir Direction of the light in eye space
+	 * @param lightColor Color of the directional light
+	 * @param ambientLightColor Color of the ambient light
+	 * @param clearColor Background color of the layer
+	 * @return true when \ref update() would draw the layer
+	 */
+	bool isUpdateNeeded(
+			OevGLES::Mat4 const &viewMatrix,
+			OevGLES::Mat4 const &projMatrix,
+			OevGLES::Vec3 const &lightDir,
+			OevGLES::Vec4 const &lightColor,
+			OevGLES::Vec4 const &ambientLightColor,
+			OevGLES::Vec4 const &clearColor
+			) const;
+
+	/** \brief Draw the layer into the offscreen texture when any input changed.
+	 *
+	 * Afterwards the framebuffer of the surface is bound again.
+	 * Call this before the frame is cleared because the scissor test is disabled while the layer is drawn.
+	 *
+	 * @param renderQueue Queue which draws the objects of the layer. Must be empty.
+	 * @param viewMatrix View matrix
+	 * @param projMatrix Projection matrix
+	 * @param lightDir Direction of the light in eye space
+	 * @param lightColor Color of the directional light
+	 * @param ambientLightColor Color of the ambient light
+	 * @param clearColor Background color of the layer
+	 * @return true when the layer was drawn, i.e. the content changed.
+	 */
+	bool update(
+			RenderQueue &renderQueue,
+			OevGLES::Mat4 const &viewMatrix,
+			OevGLES::Mat4 const &projMatrix,
+			OevGLES::Vec3 const &lightDir,
+			OevGLES::Vec4 const &lightColor,
+			OevGLES::Vec4 const &ambientLightColor,
+			OevGLES::Vec4 const &clearColor
+			);
+
+	/** \brief Copy the layer into the current frame
+	 *
+	 * Covers the complete viewport, i.e. replaces clearing the color buffer.
+	 * The depth buffer is not touched.
+	 */
+	void composite();
+
+	/// \brief Number of times the layer was drawn
+	uint64_t getNumUpdates() const {
+		return numUpdates;
+	}
+
+	/// \brief Number of times the layer was copied into a frame
+	uint64_t getNumComposites() const {
+		return numComposites;
+	}
+
+private:
+
+	/// \brief A static object in the layer
+	struct Item {
+		OevGLES::Mat4 modelMatrix;
+		RendererBase *renderer;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	/// \brief Everything outside of the renderers which determines the content of the layer
+	struct Inputs {
+		OevGLES::Mat4 viewMatrix;
+		OevGLES::Mat4 projMatrix;
+		OevGLES::Vec3 lightDir;
+		OevGLES::Vec4 lightColor;
+		OevGLES::Vec4 ambientLightColor;
+		OevGLES::Vec4 clearColor;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	OevGLES::EGLRenderSurface &surface;
+
+	std::vector<Item,Eigen::aligned_allocator<Item>> items;
+
+	/// \brief Inputs with which the layer was drawn last time
+	Inputs renderedInputs;
+
+	/// \brief The layer content is invalid, e.g. because it was never drawn, or items were added or moved.
+	bool layerInvalid = true;
+
+	OevGLES::GLRenderTarget renderTarget;
+
+	/// \brief The program, and the names of its uniforms and attributes
+	typedef OevGLES::GLProgTexturedQuad Program;
+	Program *glProgram = nullptr;
+	GLuint vertexBufferHandle = 0;
+
+	uint64_t numUpdates = 0;
+	uint64_t numComposites = 0;
+
+	/// \brief Create the program and the vertex buffer of the screen filling quad
+	void setupCompositeQuad();
+
+};
+
+#endif /* RENDERERS_LAYERCACHE_H_ */
@@ -0,0 +1,250 @@
+/*
+ * NeedleBatchRenderer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Renderer which draws all needles of a panel with one draw call
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+#include "Renderers/NeedleBatchRenderer.h"
+#include "GLES/ExceptionBase.h"
+
+#include "OVFCommon.h"
+
+#if defined HAVE_LOG4CXX_H
+	static log4cxx::LoggerPtr logger;
+#endif
+
+NeedleBatchRenderer::NeedleBatchRenderer() {
+
+#if defined HAVE_LOG4CXX_H
+	// Get the logger if necessary
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.NeedleBatchRenderer");
+	}
+#endif
+
+	LOG4CXX_DEBUG(logger,"NeedleBatchRenderer::NeedleBatchRenderer()");
+
+	std::fill(std::begin(needleTransforms),std::end(needleTransforms),0.0f);
+	std::fill(std::begin(needleColors),std::end(needleColors),0.0f);
+	std::fill(std::begin(needleAngles),std::end(needleAngles),0.0f);
+
+	boxMinCorner.setZero();
+	boxMaxCorner.setZero();
+}
+
+NeedleBatchRenderer::~NeedleBatchRenderer() { }
+
+unsigned NeedleBatchRenderer::addNeedle(GLfloat length,GLfloat width,OevGLES::Vec4 const &color,GLfloat pivotX,GLfloat pivotY) {
+
+	if (buffersReady) {
+		throw OevGLES::MeshException("NeedleBatchRenderer::addNeedle: Needles cannot be added after setupVertexBuffers()");
+	}
+	if (numNeedles >= maxNeedles) {
+		throw OevGLES::MeshException("NeedleBatchRenderer::addNeedle: The batch is full");
+	}
+
+	unsigned const needle = numNeedles++;
+	GLfloat const index = GLfloat(needle);
+
+	// The shape of the AnalogHandRenderer hand: The tip, the two sides and the tail in the x/y plane,
+	// and the hub above the pivot.
+	OevGLES::Vec3 const hub {0.0f,0.0f,width * 0.5f};
+	OevGLES::Vec3 const tip {length,0.0f,0.0f};
+	OevGLES::Vec3 const left {0.0f,width,0.0f};
+	OevGLES::Vec3 const right {0.0f,-width,0.0f};
+	OevGLES::Vec3 const tail {-width,0.0f,0.0f};
+
+	OevGLES::Vec3 const *triangles[4][3] = {
+			{&hub,&tip,&left},
+			{&hub,&right,&tip},
+			{&hub,&left,&tail},
+			{&hub,&tail,&right}
+	};
+
+	// The normals are constant per triangle. Therefore the triangles do not share vertexes.
+	for (auto const &triangle : triangles) {
+		OevGLES::Vec3 const &pos0 = *triangle[0];
+		OevGLES::Vec3 const normal = (*triangle[1] - pos0).normalized().cross((*triangle[2] - pos0).normalized()).normalized();
+		GLfloat vertexes[3][7];
+
+		for (int k = 0; k < 3; k++) {
+			Eigen::Map<OevGLES::Vec3> pos (vertexes[k]);
+			Eigen::Map<OevGLES::Vec3> vertexNormal (vertexes[k] + 3);
+
+			pos = *triangle[k];
+			vertexNormal = normal;
+			vertexes[k][6] = index;
+		}
+		needleMesh.addTriangle(vertexes[0],vertexes[1],vertexes[2]);
+	}
+
+	GLfloat * const transform = needleTransforms + needle * 4;
+	transform[0] = 1.0f;
+	transform[1] = 0.0f;
+	transform[2] = pivotX;
+	transform[3] = pivotY;
+
+	std::copy(color.data(),color.data() + 4,needleColors + needle * 4);
+
+	// The needle can point in any direction around the pivot
+	GLfloat const reach = std::max(length,width);
+	OevGLES::Vec3 const needleMin {pivotX - reach,pivotY - reach,0.0f};
+	OevGLES::Vec3 const needleMax {pivotX + reach,pivotY + reach,width * 0.5f};
+
+	if (needle == 0) {
+		boxMinCorner = needleMin;
+		boxMaxCorner = needleMax;
+	} else {
+		boxMinCorner = boxMinCorner.cwiseMin(needleMin);
+		boxMaxCorner = boxMaxCorner.cwiseMax(needleMax);
+	}
+
+	return needle;
+}
+
+void NeedleBatchRenderer::setNeedleAngle(unsigned needle,GLfloat angle) {
+
+	if (needle >= numNeedles || needleAngles[needle] == angle) {
+		return;
+	}
+
+	GLfloat * const transform = needleTransforms + needle * 4;
+
+	needleAngles[needle] = angle;
+	OevGLES::sinCosDeg(angle,transform[1],transform[0]);
+
+	markDirty();
+}
+
+void NeedleBatchRenderer::setNeedleColor(unsigned needle,OevGLES::Vec4 const &color) {
+
+	if (needle >= numNeedles) {
+		return;
+	}
+
+	GLfloat * const needleColor = needleColors + needle * 4;
+
+	if (memcmp(needleColor,color.data(),4 * sizeof(GLfloat)) != 0) {
+		std::copy(color.data(),color.data() + 4,needleColor);
+		markDirty();
+	}
+}
+
+void NeedleBatchRenderer::setupVertexBuffers() {
+
+	// First get the program
+	glProgram = Program::getProgram();
+
+	// make the program current
+	glProgram->useProgram();
+
+#if defined HAVE_LOG4CXX_H
+	OevGLES::Mesh::Statistics const statistics = needleMesh.optimize();
+	LOG4CXX_INFO(logger,"Needle batch: " << numNeedles << " needles, " << statistics.numTriangles << " triangles, "
+			<< statistics.numVertexes << " vertexes, ACMR " << statistics.acmrAfter);
+#else
+	needleMesh.optimize();
+#endif
+
+	// The needle index is a small integer. It is exact in an unsigned byte.
+	needleMesh.setupBuffers(OevGLES::VertexFormat {
+		{Program::vertexPos,3,OevGLES::VertexFormat::HalfFloat,false},
+		{Program::vertexNormal,3,OevGLES::VertexFormat::Byte,true},
+		{Program::needleIndex,1,OevGLES::VertexFormat::UnsignedByte,false}
+	});
+
+	buffersReady = true;
+
+	// New geometry must be drawn
+	markDirty();
+
+}
+
+void NeedleBatchRenderer::draw(
+		const OevGLES::Mat4& modelMatrix,
+		const OevGLES::Mat4& viewMatrix, const OevGLES::Mat4& ProjMatrix,
+		const OevGLES::Mat4& MVMatrix, const OevGLES::Mat4& MVPMatrix,
+		const OevGLES::Vec3& lightDir, const OevGLES::Vec4& lightColor,
+		const OevGLES::Vec4& ambientLightColor ) {
+
+	if (numNeedles == 0) {
+		return;
+	}
+
+	// make my program current
+	glProgram->useProgram();
+
+	// The matrices of the panel are shared by all needles. Values which did not change are not uploaded again.
+	glProgram->setUniform<Program::mvpMatrix>(MVPMatrix);
+	glProgram->setUniform<Program::mvMatrix>(MVMatrix);
+
+	glProgram->setUniform<Program::lightDir>(lightDir);
+	glProgram->setUniform<Program::lightColor>(lightColor);
+	glProgram->setUniform<Program::ambientLightColor>(ambientLightColor);
+
+	// The per-needle state of all needles in two calls
+	glProgram->setUniformVec4Array<Program::needleTransforms>(needleTransforms,numNeedles);
+	glProgram->setUniformVec4Array<Program::needleColors>(needleColors,numNeedles);
+
+	// re-bind the buffer objects
+	needleMesh.bindBuffers();
+
+	// setup the vertex coordinates, normals and needle indexes
+	needleMesh.getVertexFormat().setupAttributes(*glProgram);
+
+	// The needles are opaque. Use the depth buffer, and write to the depth buffer
+	applyBlendDepthMode(getRenderState());
+
+	needleMesh.drawTriangles();
+
+}
+
+RendererBase::RenderState NeedleBatchRenderer::getRenderState() const {
+	RenderState renderState;
+
+	if (glProgram) {
+		renderState.program = glProgram->getGLProgram().getProgramHandle();
+	}
+
+	return renderState;
+}
+
+bool NeedleBatchRenderer::getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const {
+
+	if (numNeedles == 0) {
+		return false;
+	}
+
+	minCorner = boxMinCorner;
+	maxCorner = boxMaxCorner;
+
+	return true;
+}
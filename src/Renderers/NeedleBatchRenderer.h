@@ -0,0 +1,160 @@
+/*
+ * NeedleBatchRenderer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Renderer which draws all needles of a panel with one draw call
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NEEDLEBATCHRENDERER_H_
+#define NEEDLEBATCHRENDERER_H_
+
+#include <vector>
+
+#include "GLPrograms/GLProgNeedleBatch.h"
+#include "Renderers/RendererBase.h"
+#include "GLES/VertexFormat.h"
+#include "GLES/Mesh.h"
+
+/** \brief Draws a batch of instrument needles with a single draw call
+ *
+ * Each \ref AnalogHandRenderer sets its own matrices, and issues its own draw call.
+ * A panel with vario, average climb, speed-to-fly and MacCready needles costs a draw call per needle.
+ *
+ * This renderer merges the geometry of all needles into one mesh. Each vertex carries the index of its needle.
+ * The angles, pivots and colors of the needles are uploaded as uniform arrays, and the vertex shader
+ * applies them per vertex, see \ref OevGLES::GLProgNeedleBatch. All needles share one model matrix, the panel.
+ *
+ * Needles are added with \ref addNeedle() before \ref setupVertexBuffers().
+ * Angles and colors can be changed at any time.
+ */
+class NeedleBatchRenderer : public RendererBase {
+public:
+
+	typedef OevGLES::GLProgNeedleBatch Program;
+
+	/// \brief Maximum number of needles in one batch
+	static constexpr unsigned maxNeedles = Program::maxNeedles;
+
+	NeedleBatchRenderer();
+
+	virtual ~NeedleBatchRenderer();
+
+	/** \brief Add a needle to the batch
+	 *
+	 * The needle has the shape of the \ref AnalogHandRenderer hand. It points along the x axis at angle 0.
+	 *
+	 * @param length Length from the pivot to the tip
+	 * @param width Half width at the pivot, and length of the tail behind the pivot
+	 * @param color Color of the needle
+	 * @param pivotX X coordinate of the pivot in model space
+	 * @param pivotY Y coordinate of the pivot in model space
+	 * @return Index of the needle for \ref setNeedleAngle() and \ref setNeedleColor()
+	 * @throws OevGLES::MeshException when the batch is full, or \ref setupVertexBuffers() was already called
+	 */
+	unsigned addNeedle(GLfloat length,GLfloat width,OevGLES::Vec4 const &color,GLfloat pivotX = 0.0f,GLfloat pivotY = 0.0f);
+
+	/** \brief Rotate a needle around its pivot. Marks the renderer dirty when the angle changes.
+	 *
+	 * @param needle Index returned by \ref addNeedle()
+	 * @param angle Angle in degrees counter-clockwise around the z axis
+	 */
+	void setNeedleAngle(unsigned needle,GLfloat angle);
+
+	/** \brief Change the color of a needle. Marks the renderer dirty when the color changes.
+	 *
+	 * @param needle Index returned by \ref addNeedle()
+	 * @param color New color
+	 */
+	void setNeedleColor(unsigned needle,OevGLES::Vec4 const &color);
+
+	/// \brief Number of needles in the batch
+	unsigned getNumNeedles() const {
+		return numNeedles;
+	}
+
+	/** \brief Get the program, and upload the merged geometry of all needles
+	 *
+	 */
+	virtual void setupVertexBuffers () override;
+
+	/** \brief Draw all needles with one draw call
+	 *
+	 * @param modelMatrix Model matrix of the panel which carries the needles
+	 * @param viewMatrix View matrix, used to move from world to eye space
+	 * @param ProjMatrix Projection matrix
+	 * @param MVMatrix Model-View Matrix
+	 * @param MVPMatrix Model/View/Projection matrix
+	 */
+	virtual void draw(
+			OevGLES::Mat4 const &modelMatrix,
+			OevGLES::Mat4 const &viewMatrix,
+			OevGLES::Mat4 const &ProjMatrix,
+			OevGLES::Mat4 const &MVMatrix,
+			OevGLES::Mat4 const &MVPMatrix,
+			OevGLES::Vec3 const &lightDir,
+			OevGLES::Vec4 const &lightColor,
+			OevGLES::Vec4 const &ambientLightColor
+			)  override;
+
+	/** \brief Return the GL state which is used by \ref draw().
+	 *
+	 * @return Program, texture, blend and depth mode of the renderer
+	 */
+	virtual RenderState getRenderState() const override;
+
+	/** \brief Axis aligned bounding box of all needles in any angle
+	 *
+	 * @param[out] minCorner Corner with the minimum coordinates
+	 * @param[out] maxCorner Corner with the maximum coordinates
+	 * @return true when the batch contains needles
+	 */
+	virtual bool getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const override;
+
+private:
+
+	Program *glProgram = nullptr;
+
+	/// \brief Per vertex 3 floats position, 3 floats normal, and the needle index
+	OevGLES::Mesh needleMesh {7};
+
+	unsigned numNeedles = 0;
+
+	/// \brief Per needle (cos(angle), sin(angle), pivot x, pivot y), uploaded as uniform array
+	GLfloat needleTransforms[maxNeedles * 4];
+
+	/// \brief Per needle RGBA color, uploaded as uniform array
+	GLfloat needleColors[maxNeedles * 4];
+
+	/// \brief Angle of each needle in degrees. Avoids re-computing the transform when the angle did not change.
+	GLfloat needleAngles[maxNeedles];
+
+	/// \brief Bounding box of all needles in any angle
+	OevGLES::Vec3 boxMinCorner;
+	OevGLES::Vec3 boxMaxCorner;
+
+	/// \brief After \ref setupVertexBuffers() the geometry is in the GL buffers, and needles cannot be added any more.
+	bool buffersReady = false;
+
+};
+
+#endif /* NEEDLEBATCHRENDERER_H_ */
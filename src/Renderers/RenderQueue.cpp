@@ -0,0 +1,169 @@
+/*
+ * RenderQueue.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Collects the draw items of a frame, sorts them by GL state and depth, and draws them.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+
+#include "OVFCommon.h"
+
+#include "Renderers/RenderQueue.h"
+
+#if defined HAVE_LOG4CXX_H
+	static log4cxx::LoggerPtr logger = 0;
+#endif
+
+RenderQueue::RenderQueue()
+	:viewMatrix {OevGLES::Mat4::Identity()},
+	 projMatrix {OevGLES::Mat4::Identity()},
+	 viewProjMatrix {OevGLES::Mat4::Identity()},
+	 lightDir {0.0f,0.0f,1.0f},
+	 lightColor {1.0f,1.0f,1.0f,1.0f},
+	 ambientLightColor {0.0f,0.0f,0.0f,1.0f}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.RenderQueue");
+	}
+#endif
+}
+
+RenderQueue::~RenderQueue() {
+}
+
+void RenderQueue::beginFrame(
+		OevGLES::Mat4 const &viewMatrix,
+		OevGLES::Mat4 const &projMatrix,
+		OevGLES::Vec3 const &lightDir,
+		OevGLES::Vec4 const &lightColor,
+		OevGLES::Vec4 const &ambientLightColor
+		) {
+
+	items.clear();
+
+	this->viewMatrix = viewMatrix;
+	this->projMatrix = projMatrix;
+	OevGLES::multiplyMat4(viewProjMatrix,projMatrix,viewMatrix);
+	this->lightDir = lightDir;
+	this->lightColor = lightColor;
+	this->ambientLightColor = ambientLightColor;
+}
+
+void RenderQueue::submit(RendererBase &renderer,OevGLES::Mat4 const &modelMatrix) {
+
+	items.emplace_back();
+	DrawItem &item = items.back();
+
+	item.modelMatrix = modelMatrix;
+	OevGLES::multiplyMat4(item.MVMatrix,viewMatrix,modelMatrix);
+	OevGLES::multiplyMat4(item.MVPMatrix,viewProjMatrix,modelMatrix);
+	item.renderer = &renderer;
+	item.renderState = renderer.getRenderState();
+	// The viewer looks along the negative Z axis in eye space
+	item.viewDepth = -item.MVMatrix(2,3);
+}
+
+void RenderQueue::submit(TransformNode const &node) {
+	RendererBase &renderer = *node.getRenderer();
+
+	items.emplace_back();
+	DrawItem &item = items.back();
+
+	item.modelMatrix = node.getWorldMatrix();
+	item.MVMatrix = node.getMVMatrix();
+	item.MVPMatrix = node.getMVPMatrix();
+	item.renderer = &renderer;
+	item.renderState = renderer.getRenderState();
+	item.viewDepth = -item.MVMatrix(2,3);
+}
+
+bool RenderQueue::drawsBefore(DrawItem const &a,DrawItem const &b) {
+	RendererBase::RenderState const &sa = a.renderState;
+	RendererBase::RenderState const &sb = b.renderState;
+	bool const aTransparent = sa.isTransparent();
+	bool const bTransparent = sb.isTransparent();
+
+	if (aTransparent != bTransparent) {
+		// Opaque items first
+		return bTransparent;
+	}
+
+	if (aTransparent) {
+		// Back to front regardless of the state.
+		return a.viewDepth > b.viewDepth;
+	}
+
+	// Opaque: group by state, the most expensive state change first.
+	if (sa.program != sb.program) {
+		return sa.program < sb.program;
+	}
+	if (sa.texture != sb.texture) {
+		return sa.texture < sb.texture;
+	}
+	if (sa.depthMode != sb.depthMode) {
+		return sa.depthMode < sb.depthMode;
+	}
+	if (sa.blendMode != sb.blendMode) {
+		return sa.blendMode < sb.blendMode;
+	}
+
+	// Front to back within the state group
+	return a.viewDepth < b.viewDepth;
+}
+
+void RenderQueue::flush() {
+
+	drawOrder.resize(items.size());
+	for (unsigned i = 0; i < drawOrder.size(); i++) {
+		drawOrder[i] = i;
+	}
+
+	// Stable sort keeps the submission order of items which are equal in state and depth
+	std::stable_sort(drawOrder.begin(),drawOrder.end(),[this] (unsigned a, unsigned b) {
+		return drawsBefore(items[a],items[b]);
+	});
+
+	LOG4CXX_TRACE(logger,"Flush " << items.size() << " draw items");
+
+	for (auto idx : drawOrder) {
+		DrawItem const &item = items[idx];
+
+		item.renderer->draw(
+				item.modelMatrix,
+				viewMatrix,
+				projMatrix,
+				item.MVMatrix,
+				item.MVPMatrix,
+				lightDir,
+				lightColor,
+				ambientLightColor);
+	}
+
+	items.clear();
+}
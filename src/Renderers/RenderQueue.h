@@ -0,0 +1,135 @@
+/*
+ * RenderQueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Collects the draw items of a frame, sorts them by GL state and depth, and draws them.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RENDERERS_RENDERQUEUE_H_
+#define RENDERERS_RENDERQUEUE_H_
+
+#include <vector>
+
+#include "Renderers/RendererBase.h"
+#include "Renderers/TransformNode.h"
+
+/** \brief Render queue
+ *
+ * Instead of calling \ref RendererBase::draw() of each renderer in a fixed order the render loop
+ * submits the renderers with their model matrices to the queue, and flushes the queue at the end of the frame.
+ *
+ * The queue sorts the draw items:
+ * - Opaque items first. They are grouped by program, texture, depth and blend mode,
+ *   and within a group sorted front-to-back to benefit from early depth rejection.
+ * - Transparent items afterwards, strictly sorted back-to-front for correct blending.
+ *
+ * Consecutive items with the same state let the \ref OevGLES::GLStateCache and the uniform cache
+ * of the programs filter out almost all state changes and uniform uploads.
+ */
+class RenderQueue {
+public:
+
+	RenderQueue();
+	virtual ~RenderQueue();
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	/** \brief Start a new frame. Discards all items which were not flushed.
+	 *
+	 * @param viewMatrix View matrix, used to move from world to eye space
+	 * @param projMatrix Projection matrix
+	 * @param lightDir Direction of the light in eye space
+	 * @param lightColor Color of the directional light
+	 * @param ambientLightColor Color of the ambient light
+	 */
+	void beginFrame(
+			OevGLES::Mat4 const &viewMatrix,
+			OevGLES::Mat4 const &projMatrix,
+			OevGLES::Vec3 const &lightDir,
+			OevGLES::Vec4 const &lightColor,
+			OevGLES::Vec4 const &ambientLightColor
+			);
+
+	/** \brief Submit a renderer for drawing in this frame
+	 *
+	 * A renderer can be submitted multiple times with different model matrices.
+	 * The renderer must stay valid until \ref flush() returns.
+	 *
+	 * @param renderer The renderer
+	 * @param modelMatrix Model matrix, moves the object around from model to world space
+	 */
+	void submit(RendererBase &renderer,OevGLES::Mat4 const &modelMatrix);
+
+	/** \brief Submit the renderer of a transform node with its cached matrices
+	 *
+	 * No matrix products are computed. The node must have a renderer, and its transforms must be updated
+	 * with the same view and projection matrices which were passed to \ref beginFrame().
+	 *
+	 * @param node The transform node
+	 */
+	void submit(TransformNode const &node);
+
+	/** \brief Sort the submitted items, and draw them.
+	 *
+	 * The queue is empty afterwards.
+	 */
+	void flush();
+
+	/// \brief Number of items which are waiting for \ref flush()
+	size_t getNumItems() const {
+		return items.size();
+	}
+
+private:
+
+	/// \brief One draw call of a renderer
+	struct DrawItem {
+		OevGLES::Mat4 MVMatrix;
+		OevGLES::Mat4 MVPMatrix;
+		OevGLES::Mat4 modelMatrix;
+		RendererBase *renderer;
+		RendererBase::RenderState renderState;
+		/// \brief Distance of the model origin from the viewer along the view axis
+		GLfloat viewDepth;
+
+		EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	};
+
+	std::vector<DrawItem,Eigen::aligned_allocator<DrawItem>> items;
+
+	/// \brief Sorted indexes into \ref items. Kept as member to avoid re-allocation every frame.
+	std::vector<unsigned> drawOrder;
+
+	OevGLES::Mat4 viewMatrix;
+	OevGLES::Mat4 projMatrix;
+	OevGLES::Mat4 viewProjMatrix;
+	OevGLES::Vec3 lightDir;
+	OevGLES::Vec4 lightColor;
+	OevGLES::Vec4 ambientLightColor;
+
+	/// \brief Sort order of two draw items. Returns true when item a must be drawn before item b.
+	static bool drawsBefore(DrawItem const &a,DrawItem const &b);
+
+};
+
+#endif /* RENDERERS_RENDERQUEUE_H_ */
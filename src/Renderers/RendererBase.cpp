@@ -35,3 +35,35 @@ RendererBase::RendererBase()
 RendererBase::~RendererBase() {
 }
 
+void RendererBase::applyBlendDepthMode(RenderState const &renderState) {
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
+
+	switch (renderState.blendMode) {
+	case BlendAlpha:
+		stateCache.enable(GL_BLEND);
+		stateCache.blendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+		break;
+	case BlendAdditive:
+		stateCache.enable(GL_BLEND);
+		stateCache.blendFunc(GL_SRC_ALPHA,GL_ONE);
+		break;
+	case BlendOpaque:
+	default:
+		stateCache.disable(GL_BLEND);
+	}
+
+	switch (renderState.depthMode) {
+	case DepthTestOnly:
+		stateCache.enable(GL_DEPTH_TEST);
+		stateCache.depthMask(GL_FALSE);
+		break;
+	case DepthNone:
+		stateCache.disable(GL_DEPTH_TEST);
+		stateCache.depthMask(GL_FALSE);
+		break;
+	case DepthTestWrite:
+	default:
+		stateCache.enable(GL_DEPTH_TEST);
+		stateCache.depthMask(GL_TRUE);
+	}
+}
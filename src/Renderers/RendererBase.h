@@ -27,6 +27,7 @@
 #define RENDERERBASE_H_
 
 #include "GLPrograms/GLProgBase.h"
+#include "GLES/GLStateCache.h"
 
 #if defined Success
 #	undef Success
@@ -37,6 +38,36 @@
 class RendererBase {
 public:
 
+	/// \brief How the fragments of the object are combined with the frame buffer
+	enum BlendMode {
+		BlendOpaque,		///< No blending. Fragments overwrite the frame buffer
+		BlendAlpha,			///< src * alpha + dst * (1 - alpha)
+		BlendAdditive		///< src * alpha + dst
+	};
+
+	/// \brief How the object uses the depth buffer
+	enum DepthMode {
+		DepthTestWrite,		///< Depth test, and write to the depth buffer
+		DepthTestOnly,		///< Depth test, but do not write to the depth buffer
+		DepthNone			///< No depth test, no writing to the depth buffer
+	};
+
+	/** \brief The GL state a renderer needs for drawing.
+	 *
+	 * The \ref RenderQueue sorts draw items by this state to minimize state changes between consecutive draws.
+	 */
+	struct RenderState {
+		GLuint program = 0;					///< GL program handle
+		GLuint texture = 0;					///< Handle of the primary texture, 0 when untextured
+		BlendMode blendMode = BlendOpaque;
+		DepthMode depthMode = DepthTestWrite;
+
+		/// \brief Transparent objects are drawn after all opaque objects from back to front
+		bool isTransparent() const {
+			return blendMode != BlendOpaque;
+		}
+	};
+
 	/** \brief Constructor
 	 *
 	 */
@@ -52,6 +83,14 @@ public:
 	 */
 	virtual void setupVertexBuffers () = 0;
 
+	/** \brief Start loading resources like textures in the background.
+	 *
+	 * Optional. Called before \ref setupVertexBuffers() to overlap file I/O and decoding with other start-up work,
+	 * e.g. shader compilation. Resources may arrive after the first frames. The renderer marks itself dirty then.
+	 * The default implementation does nothing.
+	 */
+	virtual void prefetchResources () {}
+
 	/** \brief Draw the rendered object.
 	 *
 	 * To be generic
@@ -73,8 +112,59 @@ public:
 			OevGLES::Vec4 const &ambientLightColor
 			) = 0;
 
+	/** \brief Return the GL state which is used by \ref draw().
+	 *
+	 * Valid after \ref setupVertexBuffers() was called.
+	 *
+	 * @return Program, texture, blend and depth mode of the renderer
+	 */
+	virtual RenderState getRenderState() const = 0;
+
+	/** \brief Axis aligned bounding box of the object in model space
+	 *
+	 * Used to compute the screen area which changes when the object moves or changes.
+	 * The default implementation returns false which means that the object can cover the complete screen.
+	 *
+	 * @param[out] minCorner Corner with the minimum coordinates
+	 * @param[out] maxCorner Corner with the maximum coordinates
+	 * @return true when the bounding box is known
+	 */
+	virtual bool getBoundingBox(OevGLES::Vec3 &/*minCorner*/,OevGLES::Vec3 &/*maxCorner*/) const {
+		return false;
+	}
+
+	/** \brief Mark the renderer as changed. The object will be redrawn in the next frame.
+	 *
+	 * Renderers call this when their input values change.
+	 * Changes of the model matrix are detected by the \ref FrameScheduler itself.
+	 */
+	void markDirty() {
+		dirty = true;
+	}
+
+	/// \brief Renderer changed since the last frame
+	bool isDirty() const {
+		return dirty;
+	}
+
+	/// \brief Called by the \ref FrameScheduler when the object was drawn
+	void clearDirty() {
+		dirty = false;
+	}
+
 protected:
 
+	/// \brief A new renderer has never been drawn, therefore it is dirty.
+	bool dirty = true;
+
+	/** \brief Set blending and depth buffer usage according to the render state
+	 *
+	 * Renderers call this in \ref draw() instead of setting blending and depth state themselves.
+	 *
+	 * @param renderState The render state as returned by \ref getRenderState()
+	 */
+	static void applyBlendDepthMode(RenderState const &renderState);
+
 };
 
 #endif /* RENDERERBASE_H_ */
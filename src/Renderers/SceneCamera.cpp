@@ -0,0 +1,66 @@
+/*
+ * SceneCamera.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Camera of the scene. Holds view and projection matrices, and computes their product once per change.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include "OVFCommon.h"
+
+#include "Renderers/SceneCamera.h"
+
+SceneCamera::SceneCamera()
+	:viewMatrix {OevGLES::Mat4::Identity()},
+	 projMatrix {OevGLES::Mat4::Identity()},
+	 viewProjMatrix {OevGLES::Mat4::Identity()}
+{
+}
+
+SceneCamera::~SceneCamera() {
+}
+
+void SceneCamera::setViewMatrix(OevGLES::Mat4 const &viewMatrix) {
+
+	if (this->viewMatrix != viewMatrix) {
+		this->viewMatrix = viewMatrix;
+		matrixChanged();
+	}
+}
+
+void SceneCamera::setProjectionMatrix(OevGLES::Mat4 const &projMatrix) {
+
+	if (this->projMatrix != projMatrix) {
+		this->projMatrix = projMatrix;
+		matrixChanged();
+	}
+}
+
+void SceneCamera::matrixChanged() {
+
+	OevGLES::multiplyMat4(viewProjMatrix,projMatrix,viewMatrix);
+	version++;
+}
@@ -0,0 +1,93 @@
+/*
+ * SceneCamera.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Camera of the scene. Holds view and projection matrices, and computes their product once per change.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RENDERERS_SCENECAMERA_H_
+#define RENDERERS_SCENECAMERA_H_
+
+#include <cstdint>
+
+#if defined Success
+#	undef Success
+#endif
+
+#include "GLES/VecMat.h"
+
+/** \brief Camera of the scene
+ *
+ * Holds the view and projection matrices, and their product which is shared by all \ref TransformNode objects.
+ * The product is computed only once when view or projection changed.
+ * The version is incremented with every change. Nodes compare it to detect when their MV and MVP matrices are outdated.
+ */
+class SceneCamera {
+public:
+
+	SceneCamera();
+	virtual ~SceneCamera();
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	/** \brief Set the view matrix. Nothing changes when the matrix is the same as before.
+	 *
+	 * @param viewMatrix View matrix, used to move from world to eye space
+	 */
+	void setViewMatrix(OevGLES::Mat4 const &viewMatrix);
+
+	/** \brief Set the projection matrix. Nothing changes when the matrix is the same as before.
+	 *
+	 * @param projMatrix Projection matrix
+	 */
+	void setProjectionMatrix(OevGLES::Mat4 const &projMatrix);
+
+	OevGLES::Mat4 const &getViewMatrix() const {
+		return viewMatrix;
+	}
+
+	OevGLES::Mat4 const &getProjectionMatrix() const {
+		return projMatrix;
+	}
+
+	/// \brief Projection * view
+	OevGLES::Mat4 const &getViewProjMatrix() const {
+		return viewProjMatrix;
+	}
+
+	/// \brief Incremented with every change of view or projection. Starts with 1.
+	uint64_t getVersion() const {
+		return version;
+	}
+
+private:
+	OevGLES::Mat4 viewMatrix;
+	OevGLES::Mat4 projMatrix;
+	OevGLES::Mat4 viewProjMatrix;
+
+	uint64_t version = 1;
+
+	void matrixChanged();
+};
+
+#endif /* RENDERERS_SCENECAMERA_H_ */
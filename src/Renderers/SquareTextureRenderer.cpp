@@ -27,14 +27,25 @@
 #  include <config.h>
 #endif
 
+#include <vector>
+
+#include "OVFCommon.h"
+
 #include "Renderers/SquareTextureRenderer.h"
-#include "GLES/TexHelper/PngReader.h"
+#include "GLES/TexHelper/TextureLoader.h"
 
 #if defined HAVE_LOG4CXX_H
 #include "OVFCommon.h"
 	static log4cxx::LoggerPtr logger = 0;
 #endif
 
+GLfloat const SquareTextureRenderer::imageTexCoords[4][2] = {
+		{1.0f,0.0f},
+		{1.0f,1.0f},
+		{0.0f,1.0f},
+		{0.0f,0.0f}
+};
+
 SquareTextureRenderer::SquareTextureRenderer()
 	:
 	// Setup the positions
@@ -61,7 +72,8 @@ SquareTextureRenderer::SquareTextureRenderer()
 		 0.0f, 1.0f,				// Texture coordinate 2
 		-10.0f,-10.0f,-1.0f,1.0f,	// Pos 3
 		 0.0f, 0.0f					// Texture coordinate 3
-	}
+	},
+	textureAtlas {OevGLES::TextureAtlas::getTextureAtlas()}
 	{
 
 #if defined HAVE_LOG4CXX_H
@@ -95,26 +107,74 @@ SquareTextureRenderer::SquareTextureRenderer()
 	}
 
 
-SquareTextureRenderer::~SquareTextureRenderer() { }
+SquareTextureRenderer::~SquareTextureRenderer() {
+
+	if (textureRequested) {
+		OevGLES::TextureLoader::getTextureLoader().cancel(backgroundRegion);
+	}
+}
 
 void SquareTextureRenderer::setupVertexBuffers() {
 
 	// First get the program
-	glProgram = OevGLES::GLProgDiffLightTexture::getProgram();
+	glProgram = Program::getProgram();
 
 	// make the program current
 	glProgram->useProgram();
 
+	// The texture is uploaded later by the texture loader. Until then the region is the placeholder.
+	if (!textureRequested) {
+		prefetchResources();
+	}
+
+	// The format depends on the extensions of the GPU
+	vertexFormat = OevGLES::VertexFormat {
+		{Program::vertexPos,3,OevGLES::VertexFormat::HalfFloat,false},
+		{Program::vertexTexture0Pos,2,OevGLES::VertexFormat::UnsignedShort,true}
+	};
+
 	glGenBuffers(1,&vertexBufferHandle);
-	glBindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
-	glBufferData(GL_ARRAY_BUFFER,sizeof(vertexArray),vertexArray,GL_STATIC_DRAW);
+	updateTextureCoordinates();
+
+	// New geometry must be drawn
+	markDirty();
+
+}
+
+void SquareTextureRenderer::prefetchResources() {
+
+	if (textureRequested) {
+		return;
+	}
+
+	OevGLES::TextureLoader::getTextureLoader().loadIntoAtlas(textureAtlas,backgroundRegion,"./Vario5m.png",[this] {
+		// The placeholder on the screen must be replaced
+		updateTextureCoordinates();
+		markDirty();
+	});
+	textureRequested = true;
+}
 
-	// Load the texture into GL
-	OevGLES::PngReader varioBackgoundReader ("./Vario5m.png");
-	OevGLES::TextureData texData (8,8,OevGLES::TextureData::RGB,OevGLES::TextureData::Byte);
-	varioBackgoundReader.readPngToTexture(texData);
-	varioBackgoundTexture.setTextureData(texData);
+void SquareTextureRenderer::updateTextureCoordinates() {
 
+	for (int i = 0; i < 4; i++) {
+		vertexArray[i * 6 + 4] = backgroundRegion.mapS(imageTexCoords[i][0]);
+		vertexArray[i * 6 + 5] = backgroundRegion.mapT(imageTexCoords[i][1]);
+	}
+
+	if (vertexBufferHandle) {
+		std::vector<uint8_t> vertexes (4 * vertexFormat.getStride());
+
+		for (int i = 0; i < 4; i++) {
+			uint8_t *vertex = vertexes.data() + i * vertexFormat.getStride();
+
+			vertexFormat.writeElement(vertex,0,vertexArray + (i * 6));
+			vertexFormat.writeElement(vertex,1,vertexArray + (i * 6) + 4);
+		}
+
+		OevGLES::GLStateCache::getStateCache().bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+		glBufferData(GL_ARRAY_BUFFER,vertexes.size(),vertexes.data(),GL_STATIC_DRAW);
+	}
 }
 
 void SquareTextureRenderer::draw(
@@ -124,7 +184,7 @@ void SquareTextureRenderer::draw(
 		const OevGLES::Vec3& lightDir, const OevGLES::Vec4& lightColor,
 		const OevGLES::Vec4& ambientLightColor ) {
 
-	GLfloat* bufferOffset = 0;
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
 
 	// make my program current
 	glProgram->useProgram();
@@ -145,44 +205,64 @@ void SquareTextureRenderer::draw(
 	}
 	*/
 
-	// Set the uniforms
-	glUniformMatrix4fv(glProgram->getMvpMatrixLocation(),1,GL_FALSE,&(MVPMatrix(0,0)));
-	glUniformMatrix4fv(glProgram->getMvMatrixLocation(),1,GL_FALSE,&(MVMatrix(0,0)));
-	glUniformMatrix4fv(glProgram->getMvMatrixLocation(),1,GL_FALSE,&(MVMatrix(0,0)));
+	// Set the uniforms. Values which did not change since the last draw are not uploaded again.
+	glProgram->setUniform<Program::mvpMatrix>(MVPMatrix);
+	glProgram->setUniform<Program::mvMatrix>(MVMatrix);
 
-	glUniform3fv(glProgram->getLightDirLocation(),1,&(lightDir(0)));
-	glUniform4fv(glProgram->getLightColorLocation(),1,&(lightColor(0)));
-	glUniform4fv(glProgram->getAmbientLightColorLocation(),1,&(ambientLightColor(0)));
+	glProgram->setUniform<Program::lightDir>(lightDir);
+	glProgram->setUniform<Program::lightColor>(lightColor);
+	glProgram->setUniform<Program::ambientLightColor>(ambientLightColor);
 
 
 	// set the color attribute constant
-	glDisableVertexAttribArray(glProgram->getVertexColorLocation());
-	glVertexAttrib4fv(glProgram->getVertexColorLocation(),textureBaseColor);
+	stateCache.disableVertexAttribArray(glProgram->getAttributeLocation(Program::vertexColor));
+	stateCache.vertexAttrib4fv(glProgram->getAttributeLocation(Program::vertexColor),textureBaseColor);
 
 	// set the vertex normal constant
-	glEnableVertexAttribArray(glProgram->getVertexNormalLocation());
-	glVertexAttrib4fv(glProgram->getVertexNormalLocation(),textureNormal);
+	stateCache.disableVertexAttribArray(glProgram->getAttributeLocation(Program::vertexNormal));
+	stateCache.vertexAttrib4fv(glProgram->getAttributeLocation(Program::vertexNormal),textureNormal);
 
 	// re-bind the buffer object
-	glBindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	stateCache.bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
 
-	// setup the vertex coordinates
-	glEnableVertexAttribArray(glProgram->getVertexPosLocation());
-	glVertexAttribPointer(glProgram->getVertexPosLocation(),4,GL_FLOAT,GL_FALSE,6 * sizeof (GLfloat),bufferOffset);
-	// setup the texture coordinates
-	bufferOffset += 4; // Advance the offset by 4 floats to the texture coordinate.
-	glEnableVertexAttribArray(glProgram->getVertexTexture0PosLocation());
-	glVertexAttribPointer(glProgram->getVertexTexture0PosLocation(),2,GL_FLOAT,GL_FALSE,6 * sizeof (GLfloat),bufferOffset);
+	// setup the vertex coordinates and the texture coordinates
+	vertexFormat.setupAttributes(*glProgram);
 
-	// Assign the texture to Texure engine 0, and set the sampler uniform accordingly
-	varioBackgoundTexture.bindToUniformLocation(GL_TEXTURE0,0,glProgram->getTexture0Location());
+	// Assign the atlas page to Texure engine 0, and set the sampler uniform accordingly
+	textureAtlas.getPageTexture(backgroundRegion.page).bindToUniformLocation(GL_TEXTURE0,0,glProgram->getGLProgram(),glProgram->getUniformLocation(Program::texture0));
 
 	// The object is opaque. Use the depth buffer, and write to the depth buffer
-	glDepthMask(GL_TRUE);
-	glEnable(GL_DEPTH_TEST);
+	applyBlendDepthMode(getRenderState());
 
 	glDrawArrays(GL_TRIANGLE_FAN,0,4);
 
 
 }
 
+RendererBase::RenderState SquareTextureRenderer::getRenderState() const {
+	RenderState renderState;
+
+	if (glProgram) {
+		renderState.program = glProgram->getGLProgram().getProgramHandle();
+	}
+	if (backgroundRegion.isValid()) {
+		renderState.texture = textureAtlas.getPageTexture(backgroundRegion.page).getTextureHandle();
+	}
+
+	return renderState;
+}
+
+bool SquareTextureRenderer::getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const {
+
+	minCorner = Eigen::Map<OevGLES::Vec3 const>(vertexArray);
+	maxCorner = minCorner;
+
+	for (int i = 1; i < 4; i++) {
+		Eigen::Map<OevGLES::Vec3 const> pos (vertexArray + (i * 6));
+
+		minCorner = minCorner.cwiseMin(pos);
+		maxCorner = maxCorner.cwiseMax(pos);
+	}
+
+	return true;
+}
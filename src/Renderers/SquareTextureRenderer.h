@@ -30,6 +30,8 @@
 #include "GLPrograms/GLProgDiffLightTexture.h"
 #include "Renderers/RendererBase.h"
 #include "GLES/GLTexture.h"
+#include "GLES/VertexFormat.h"
+#include "GLES/TexHelper/TextureAtlas.h"
 
 class SquareTextureRenderer : public RendererBase {
 public:
@@ -42,6 +44,12 @@ public:
 	 */
 	virtual void setupVertexBuffers () override;
 
+	/** \brief Load the background texture into the shared \ref OevGLES::TextureAtlas with the \ref OevGLES::TextureLoader.
+	 *
+	 * A placeholder is drawn until the texture is loaded. Then the renderer is marked dirty.
+	 */
+	virtual void prefetchResources () override;
+
 	/** \brief Draw the rendered object.
 	 *
 	 * @param modelMatrix Model matrix, moves the object around from model to world space
@@ -61,6 +69,20 @@ public:
 			OevGLES::Vec4 const &ambientLightColor
 			)  override;
 
+	/** \brief Return the GL state which is used by \ref draw().
+	 *
+	 * @return Program, texture, blend and depth mode of the renderer
+	 */
+	virtual RenderState getRenderState() const override;
+
+	/** \brief Axis aligned bounding box of the object in model space
+	 *
+	 * @param[out] minCorner Corner with the minimum coordinates
+	 * @param[out] maxCorner Corner with the maximum coordinates
+	 * @return true
+	 */
+	virtual bool getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const override;
+
 
 private:
 
@@ -89,11 +111,29 @@ private:
 	GLfloat textureBaseColor [4] = {1.0f,1.0f,1.0f,1.0f};
 	GLfloat textureNormal [4] = {0.0f, 0.0f, 1.0f, 0.0f};
 
-	OevGLES::GLProgDiffLightTexture* glProgram = 0;
+	/// \brief The program, and the names of its uniforms and attributes
+	typedef OevGLES::GLProgDiffLightTexture Program;
+	Program *glProgram = nullptr;
+
+	/// \brief Half float positions, and normalized short texture coordinates. 12 instead of 24 bytes per vertex.
+	OevGLES::VertexFormat vertexFormat;
 
 	GLuint vertexBufferHandle = 0;
 
-	OevGLES::GLTexture varioBackgoundTexture;
+	/// \brief Texture coordinates of the vertexes within the image. They are mapped into the atlas region.
+	static GLfloat const imageTexCoords[4][2];
+
+	/// \brief The atlas which holds the background image
+	OevGLES::TextureAtlas &textureAtlas;
+
+	/// \brief Location of the background image in the atlas
+	OevGLES::TextureAtlas::Region backgroundRegion;
+
+	/// \brief Loading of the texture was requested
+	bool textureRequested = false;
+
+	/// \brief Map the texture coordinates into \ref backgroundRegion, and update the vertex buffer when it exists
+	void updateTextureCoordinates();
 
 };
 
@@ -0,0 +1,493 @@
+/*
+ * TextRenderer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Renders text, e.g. numeric readouts, from a glyph texture which is rasterized once with FreeType.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "OVFCommon.h"
+
+#include "Renderers/TextRenderer.h"
+#include "GLES/TexHelper/SkylinePacker.h"
+#include "GLES/TexHelper/DistanceField.h"
+#include "GLES/ExceptionBase.h"
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+/// \brief Empty texels around each glyph in the sheet. Linear filtering must not pick up the neighbors.
+static GLuint const glyphPadding = 1;
+/// \brief The sheet grows to this size at most. Every GLES2 GPU supports it.
+static GLuint const maxSheetSize = 2048;
+/// \brief Distance field glyphs are rasterized at this multiple of the pixel size
+static unsigned const distanceFieldDownscale = 4;
+
+char const TextRenderer::defaultCharacters[] =
+		" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+/// \brief Releases the FreeType library and face when they go out of scope
+struct FreeTypeHandles {
+	FT_Library library = nullptr;
+	FT_Face face = nullptr;
+
+	~FreeTypeHandles() {
+		if (face) {
+			FT_Done_Face(face);
+		}
+		if (library) {
+			FT_Done_FreeType(library);
+		}
+	}
+};
+
+/// \brief Bitmap of a glyph before it is packed into the sheet. The first row is the top.
+struct GlyphBitmap {
+	unsigned char character;
+	GLuint width;
+	GLuint height;
+	std::vector<uint8_t> texels;
+	unsigned x;
+	unsigned y;
+};
+
+static void throwFontError(char const *text,char const *fontFile,FT_Error error) {
+	std::ostringstream os;
+	os << "TextRenderer: " << text << " \"" << fontFile << "\", FreeType error " << error;
+	throw OevGLES::FontException(os.str().c_str());
+}
+
+TextRenderer::TextRenderer(char const *fontFile,unsigned pixelSize,char const *characters,GlyphMode glyphMode)
+	:glyphSheet {1,1,OevGLES::TextureData::Luminance,OevGLES::TextureData::Byte},
+	 pixelSize {pixelSize},
+	 glyphMode {glyphMode}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.TextRenderer");
+	}
+#endif
+
+	rasterizeGlyphs(fontFile,pixelSize,characters);
+
+	glyphTexture.setMinificationFilter(OevGLES::GLTexture::Linear);
+	glyphTexture.setMagnificationFilter(OevGLES::GLTexture::Linear);
+}
+
+TextRenderer::~TextRenderer() {
+
+	if (vertexBufferHandle) {
+		OevGLES::GLStateCache::getStateCache().deleteBuffer(vertexBufferHandle);
+	}
+	if (indexBufferHandle) {
+		OevGLES::GLStateCache::getStateCache().deleteBuffer(indexBufferHandle);
+	}
+}
+
+void TextRenderer::rasterizeGlyphs(char const *fontFile,unsigned pixelSize,char const *characters) {
+	FreeTypeHandles ft;
+	std::vector<GlyphBitmap> bitmaps;
+	FT_Error error;
+
+	// Distance fields are computed from glyphs with finer edges, and scaled down.
+	// The spread covers outlines of about 1/8 em, and at least 2 texels for the anti-aliasing.
+	unsigned const rasterScale = glyphMode == DistanceFieldGlyphs ? distanceFieldDownscale : 1;
+	GLfloat const metricScale = 1.0f / GLfloat(rasterScale);
+	if (glyphMode == DistanceFieldGlyphs) {
+		distanceSpread = std::max(2U,pixelSize / 8);
+	}
+	OevGLES::DistanceField const distanceField (distanceSpread,rasterScale);
+
+	if ((error = FT_Init_FreeType(&ft.library))) {
+		throwFontError("Cannot initialize FreeType for",fontFile,error);
+	}
+	if ((error = FT_New_Face(ft.library,fontFile,0,&ft.face))) {
+		throwFontError("Cannot load font",fontFile,error);
+	}
+	if ((error = FT_Set_Pixel_Sizes(ft.face,0,pixelSize * rasterScale))) {
+		throwFontError("Cannot set the size of font",fontFile,error);
+	}
+
+	for (char const *c = characters; *c; c++) {
+		unsigned char const character = static_cast<unsigned char>(*c);
+
+		if (glyphs[character].available) {
+			continue;
+		}
+
+		if ((error = FT_Load_Char(ft.face,character,FT_LOAD_RENDER))) {
+			LOG4CXX_WARN(logger,"Cannot render character " << unsigned(character) << " of font " << fontFile
+					<< ", FreeType error " << error);
+			continue;
+		}
+
+		FT_GlyphSlot const slot = ft.face->glyph;
+		FT_Bitmap const &bitmap = slot->bitmap;
+		Glyph &glyph = glyphs[character];
+		GlyphBitmap glyphBitmap {character,bitmap.width,bitmap.rows,{},0,0};
+
+		glyph.available = true;
+		glyph.advance = GLfloat(slot->advance.x) / 64.0f * metricScale;
+		glyph.left = GLfloat(slot->bitmap_left) * metricScale;
+		glyph.top = GLfloat(slot->bitmap_top) * metricScale;
+		glyph.width = bitmap.width;
+		glyph.height = bitmap.rows;
+
+		// The pitch can be negative for bottom-up bitmaps, and includes padding at the end of the rows
+		glyphBitmap.texels.resize(size_t(bitmap.width) * bitmap.rows);
+		for (unsigned row = 0; row < bitmap.rows; row++) {
+			uint8_t const *src = bitmap.pitch >= 0 ?
+					bitmap.buffer + row * bitmap.pitch :
+					bitmap.buffer + (bitmap.rows - 1 - row) * -bitmap.pitch;
+			memcpy(glyphBitmap.texels.data() + row * bitmap.width,src,bitmap.width);
+		}
+
+		// Spaces have no bitmap, only an advance
+		if (bitmap.width > 0 && bitmap.rows > 0) {
+			if (glyphMode == DistanceFieldGlyphs) {
+				// The field extends by the spread on all sides of the glyph
+				glyphBitmap.texels = distanceField.generate(glyphBitmap.texels.data(),bitmap.width,bitmap.rows,distanceSpread,
+						glyphBitmap.width,glyphBitmap.height);
+				glyph.left -= GLfloat(distanceSpread);
+				glyph.top += GLfloat(distanceSpread);
+				glyph.width = glyphBitmap.width;
+				glyph.height = glyphBitmap.height;
+			}
+			bitmaps.push_back(std::move(glyphBitmap));
+		}
+	}
+
+	// The skyline packs tightest when the tall glyphs are placed first
+	std::sort(bitmaps.begin(),bitmaps.end(),[] (GlyphBitmap const &a,GlyphBitmap const &b) {
+		return a.height > b.height || (a.height == b.height && a.width > b.width);
+	});
+
+	// Start with the smallest power of 2 which can hold the area of the glyphs, and grow until all fit.
+	unsigned long const area = std::accumulate(bitmaps.begin(),bitmaps.end(),0UL,[] (unsigned long sum,GlyphBitmap const &b) {
+		return sum + (b.width + 2 * glyphPadding) * (b.height + 2 * glyphPadding);
+	});
+	sheetSize = 16;
+	while (sheetSize < maxSheetSize && (unsigned long)(sheetSize) * sheetSize < area) {
+		sheetSize *= 2;
+	}
+
+	for (;;) {
+		OevGLES::SkylinePacker packer (sheetSize,sheetSize);
+		bool allFit = true;
+
+		for (auto &b : bitmaps) {
+			if (!packer.insert(b.width + 2 * glyphPadding,b.height + 2 * glyphPadding,b.x,b.y)) {
+				allFit = false;
+				break;
+			}
+		}
+
+		if (allFit) {
+			break;
+		}
+
+		if (sheetSize >= maxSheetSize) {
+			throwFontError("The glyphs do not fit into the maximum texture size. Reduce the pixel size of",fontFile,0);
+		}
+		sheetSize *= 2;
+	}
+
+	// The sheet is initialized with coverage 0
+	glyphSheet = OevGLES::TextureData(sheetSize,sheetSize,OevGLES::TextureData::Luminance,OevGLES::TextureData::Byte);
+	uint8_t *sheet = static_cast<uint8_t*>(glyphSheet.getDataPtr());
+	GLfloat const texelSize = 1.0f / GLfloat(sheetSize);
+
+	for (auto const &b : bitmaps) {
+		unsigned const x = b.x + glyphPadding;
+		unsigned const y = b.y + glyphPadding;
+		Glyph &glyph = glyphs[b.character];
+
+		// The first row of the sheet is the bottom, the first row of the bitmap is the top
+		for (unsigned row = 0; row < b.height; row++) {
+			memcpy(sheet + (y + b.height - 1 - row) * sheetSize + x,b.texels.data() + row * b.width,b.width);
+		}
+
+		glyph.u0 = GLfloat(x) * texelSize;
+		glyph.v0 = GLfloat(y) * texelSize;
+		glyph.u1 = GLfloat(x + b.width) * texelSize;
+		glyph.v1 = GLfloat(y + b.height) * texelSize;
+	}
+
+	LOG4CXX_DEBUG(logger,"Rasterized " << bitmaps.size() << ((glyphMode == DistanceFieldGlyphs) ? " distance field" : "")
+			<< " glyphs of " << fontFile << " at " << pixelSize << " pixels into a sheet of " << sheetSize << 'x' << sheetSize);
+}
+
+TextRenderer::TextId TextRenderer::addText(OevGLES::Vec3 const &origin,GLfloat height,unsigned maxLength,Alignment alignment) {
+	unsigned const firstQuad = unsigned(vertexArray.size() / floatsPerQuad);
+
+	if (vertexBufferHandle) {
+		throw OevGLES::FontException("TextRenderer::addText: Texts cannot be added after setupVertexBuffers()");
+	}
+
+	// 4 vertexes per quad must be addressable by 16 bit indexes
+	if ((firstQuad + maxLength) * 4 > 0x10000) {
+		throw OevGLES::FontException("TextRenderer::addText: Too many characters for 16 bit indexes");
+	}
+
+	texts.push_back(Text {origin,height / GLfloat(pixelSize),alignment,firstQuad,maxLength,""});
+
+	// Empty quads until the first setText()
+	vertexArray.resize(vertexArray.size() + maxLength * floatsPerQuad,0.0f);
+
+	return TextId(texts.size() - 1);
+}
+
+void TextRenderer::setText(TextId textId,std::string const &text) {
+	Text &t = texts.at(textId);
+	std::string const newText = text.substr(0,t.maxLength);
+
+	if (newText == t.text) {
+		return;
+	}
+
+	t.text = newText;
+	layoutText(t);
+}
+
+void TextRenderer::layoutText(Text const &text) {
+	GLfloat quad[floatsPerQuad];
+	GLfloat width = 0.0f;
+	GLfloat penX;
+	unsigned quadNo = text.firstQuad;
+
+	for (char c : text.text) {
+		width += glyphs[static_cast<unsigned char>(c)].advance;
+	}
+
+	switch (text.alignment) {
+	case AlignCenter:
+		penX = -0.5f * width;
+		break;
+	case AlignRight:
+		penX = -width;
+		break;
+	default:
+		penX = 0.0f;
+		break;
+	}
+
+	for (unsigned i = 0; i < text.maxLength; i++) {
+		unsigned char const c = i < text.text.size() ? static_cast<unsigned char>(text.text[i]) : 0;
+		Glyph const &glyph = glyphs[c];
+
+		if (glyph.available && glyph.width > 0) {
+			GLfloat const x0 = text.origin[0] + (penX + glyph.left) * text.scale;
+			GLfloat const x1 = x0 + GLfloat(glyph.width) * text.scale;
+			GLfloat const y1 = text.origin[1] + glyph.top * text.scale;
+			GLfloat const y0 = y1 - GLfloat(glyph.height) * text.scale;
+			GLfloat const z = text.origin[2];
+			GLfloat const vertexes[floatsPerQuad] = {
+					x0,y0,z,	glyph.u0,glyph.v0,
+					x1,y0,z,	glyph.u1,glyph.v0,
+					x1,y1,z,	glyph.u1,glyph.v1,
+					x0,y1,z,	glyph.u0,glyph.v1
+			};
+			memcpy(quad,vertexes,sizeof(quad));
+		} else {
+			// Spaces, unknown characters, and the unused rest of the text
+			std::fill(quad,quad + floatsPerQuad,0.0f);
+		}
+
+		if (i < text.text.size()) {
+			penX += glyph.advance;
+		}
+
+		// Only quads which really change are uploaded
+		GLfloat *dest = vertexArray.data() + quadNo * floatsPerQuad;
+		if (memcmp(dest,quad,sizeof(quad))) {
+			memcpy(dest,quad,sizeof(quad));
+
+			if (changedQuadsBegin >= changedQuadsEnd) {
+				changedQuadsBegin = quadNo;
+				changedQuadsEnd = quadNo + 1;
+			} else {
+				changedQuadsBegin = std::min(changedQuadsBegin,quadNo);
+				changedQuadsEnd = std::max(changedQuadsEnd,quadNo + 1);
+			}
+			markDirty();
+		}
+
+		quadNo++;
+	}
+}
+
+void TextRenderer::setupVertexBuffers() {
+	unsigned const numQuads = unsigned(vertexArray.size() / floatsPerQuad);
+	std::vector<GLushort> indexes (numQuads * 6);
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
+
+	if (glyphMode == DistanceFieldGlyphs) {
+		distanceProgram = OevGLES::GLProgTextSDF::getProgram();
+		distanceProgram->useProgram();
+	} else {
+		coverageProgram = OevGLES::GLProgText::getProgram();
+		coverageProgram->useProgram();
+	}
+
+	// The sheet is not needed after the upload
+	glyphTexture.setTextureData(glyphSheet);
+	glyphSheet = OevGLES::TextureData(1,1,OevGLES::TextureData::Luminance,OevGLES::TextureData::Byte);
+
+	// Both programs declare the same attributes
+	vertexFormat = OevGLES::VertexFormat {
+		{OevGLES::GLProgText::vertexPos,3,OevGLES::VertexFormat::Float,false},
+		{OevGLES::GLProgText::vertexTexture0Pos,2,OevGLES::VertexFormat::Float,false}
+	};
+
+	for (unsigned i = 0; i < numQuads; i++) {
+		GLushort const v = GLushort(i * 4);
+		GLushort const quadIndexes[6] = {v,GLushort(v + 1),GLushort(v + 2),v,GLushort(v + 2),GLushort(v + 3)};
+
+		std::copy(quadIndexes,quadIndexes + 6,indexes.begin() + i * 6);
+	}
+
+	glGenBuffers(1,&indexBufferHandle);
+	stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER,indexBufferHandle);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER,indexes.size() * sizeof(GLushort),indexes.data(),GL_STATIC_DRAW);
+
+	// The quads change when the texts change
+	glGenBuffers(1,&vertexBufferHandle);
+	stateCache.bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	glBufferData(GL_ARRAY_BUFFER,vertexArray.size() * sizeof(GLfloat),vertexArray.data(),GL_DYNAMIC_DRAW);
+	changedQuadsBegin = changedQuadsEnd = 0;
+
+	markDirty();
+}
+
+void TextRenderer::uploadChangedQuads() {
+
+	if (changedQuadsBegin >= changedQuadsEnd) {
+		return;
+	}
+
+	LOG4CXX_TRACE(logger,"Upload quads " << changedQuadsBegin << " to " << changedQuadsEnd);
+
+	OevGLES::GLStateCache::getStateCache().bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	glBufferSubData(GL_ARRAY_BUFFER,
+			changedQuadsBegin * floatsPerQuad * sizeof(GLfloat),
+			(changedQuadsEnd - changedQuadsBegin) * floatsPerQuad * sizeof(GLfloat),
+			vertexArray.data() + changedQuadsBegin * floatsPerQuad);
+
+	changedQuadsBegin = changedQuadsEnd = 0;
+}
+
+void TextRenderer::draw(
+		const OevGLES::Mat4& modelMatrix,
+		const OevGLES::Mat4& viewMatrix, const OevGLES::Mat4& ProjMatrix,
+		const OevGLES::Mat4& MVMatrix, const OevGLES::Mat4& MVPMatrix,
+		const OevGLES::Vec3& lightDir, const OevGLES::Vec4& lightColor,
+		const OevGLES::Vec4& ambientLightColor ) {
+
+	if (distanceProgram) {
+		distanceProgram->useProgram();
+		// A quarter texel of the distance field. Only the minimum when the GPU provides the derivatives.
+		distanceProgram->setUniform<OevGLES::GLProgTextSDF::edgeWidth>(0.125f / GLfloat(distanceSpread));
+		drawQuads(distanceProgram,MVPMatrix);
+	} else {
+		coverageProgram->useProgram();
+		drawQuads(coverageProgram,MVPMatrix);
+	}
+
+}
+
+template <class Program>
+void TextRenderer::drawQuads(Program *program,OevGLES::Mat4 const &MVPMatrix) {
+	OevGLES::GLStateCache &stateCache = OevGLES::GLStateCache::getStateCache();
+
+	uploadChangedQuads();
+
+	program->template setUniform<Program::mvpMatrix>(MVPMatrix);
+	program->template setUniform<Program::textColor>(textColor);
+
+	stateCache.bindBuffer(GL_ARRAY_BUFFER,vertexBufferHandle);
+	stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER,indexBufferHandle);
+
+	vertexFormat.setupAttributes(*program);
+
+	glyphTexture.bindToUniformLocation(GL_TEXTURE0,0,program->getGLProgram(),program->getUniformLocation(Program::texture0));
+
+	applyBlendDepthMode(getRenderState());
+
+	glDrawElements(GL_TRIANGLES,GLsizei(vertexArray.size() / floatsPerQuad * 6),GL_UNSIGNED_SHORT,0);
+
+}
+
+RendererBase::RenderState TextRenderer::getRenderState() const {
+	RenderState renderState;
+
+	if (distanceProgram) {
+		renderState.program = distanceProgram->getGLProgram().getProgramHandle();
+	} else if (coverageProgram) {
+		renderState.program = coverageProgram->getGLProgram().getProgramHandle();
+	}
+	renderState.texture = glyphTexture.getTextureHandle();
+	renderState.blendMode = BlendAlpha;
+	renderState.depthMode = DepthTestOnly;
+
+	return renderState;
+}
+
+bool TextRenderer::getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const {
+	bool found = false;
+
+	for (size_t i = 0; i < vertexArray.size(); i += floatsPerQuad) {
+		Eigen::Map<OevGLES::Vec3 const> lowerLeft (vertexArray.data() + i);
+		Eigen::Map<OevGLES::Vec3 const> upperRight (vertexArray.data() + i + 2 * floatsPerVertex);
+
+		// Empty quads are all 0
+		if (lowerLeft == upperRight) {
+			continue;
+		}
+
+		if (!found) {
+			minCorner = lowerLeft;
+			maxCorner = upperRight;
+			found = true;
+		} else {
+			minCorner = minCorner.cwiseMin(lowerLeft);
+			maxCorner = maxCorner.cwiseMax(upperRight);
+		}
+	}
+
+	return found;
+}
@@ -0,0 +1,284 @@
+/*
+ * TextRenderer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Renders text, e.g. numeric readouts, from a glyph texture which is rasterized once with FreeType.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifndef TEXTRENDERER_H_
+#define TEXTRENDERER_H_
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "GLPrograms/GLProgText.h"
+#include "GLPrograms/GLProgTextSDF.h"
+#include "Renderers/RendererBase.h"
+#include "GLES/GLTexture.h"
+#include "GLES/VertexFormat.h"
+#include "GLES/TexHelper/TextureData.h"
+
+/** \brief Renders lines of text, e.g. the numeric readouts of climb, altitude and average climb
+ *
+ * The constructor rasterizes a set of characters with FreeType once into a luminance texture, the glyph sheet,
+ * and keeps the metrics of the glyphs. FreeType is not used afterwards.
+ *
+ * A renderer holds any number of texts which are added with \ref addText(). Each text has a fixed number of glyph
+ * quads in one dynamic vertex buffer, and all texts are drawn with a single draw call.
+ * \ref setText() lays out the new string, and compares the quads with the previous ones. Only the range of changed quads
+ * is uploaded again with glBufferSubData() at the next draw. When a readout changes from 1.4 to 1.5 this is one quad.
+ * Unused quads are degenerated to a point, and do not create fragments.
+ *
+ * In \ref DistanceFieldGlyphs mode the sheet contains signed distance fields of the glyphs instead of their coverage,
+ * and the texts are drawn with \ref OevGLES::GLProgTextSDF. The edges stay sharp at any size and rotation, so a small
+ * sheet, e.g. with 32 texels per em, serves all texts from the small labels to the large readouts of the dial.
+ * Symbols are drawn like text when the font contains them, e.g. the degree sign.
+ *
+ * Characters which are not in the glyph sheet are skipped. There is no kerning; the digits of most fonts
+ * have the same advance anyway, and readouts do not jitter when they change.
+ *
+ * Texts lie in the x/y plane of the model space, the baseline along the x axis. The text is alpha blended,
+ * and tested against the depth buffer without writing to it.
+ */
+class TextRenderer : public RendererBase {
+public:
+
+	/// \brief Identifies a text added with \ref addText()
+	typedef unsigned TextId;
+
+	/// \brief Horizontal position of the text relative to its origin
+	enum Alignment {
+		AlignLeft,		///< The text starts at the origin
+		AlignCenter,	///< The text is centered on the origin
+		AlignRight		///< The text ends at the origin, e.g. for numbers
+	};
+
+	/// \brief Content of the glyph sheet
+	enum GlyphMode {
+		/// The coverage of the glyphs. Sharpest when a text is drawn at about the pixel size, but blurs when it is magnified.
+		CoverageGlyphs,
+		/** The signed distance field of the glyphs. Sharp at all sizes. The glyphs are rasterized at 4 times the pixel size,
+		 * which makes the construction slower. */
+		DistanceFieldGlyphs
+	};
+
+	/// \brief Printable ASCII characters
+	static char const defaultCharacters[];
+
+	/** \brief Constructor. Loads the font, and rasterizes the glyph sheet.
+	 *
+	 * @param fontFile Path of a font file which FreeType can read, e.g. a TrueType font
+	 * @param pixelSize Height of the em square in texels. Larger sizes keep the glyphs sharp when the text is large on the screen.
+	 * @param characters Characters of the glyph sheet. Only 8 bit characters are supported.
+	 * @param glyphMode Coverage or distance field glyphs
+	 * @throws OevGLES::FontException when the font cannot be loaded, or the glyphs do not fit into the maximum texture size.
+	 */
+	TextRenderer(char const *fontFile,unsigned pixelSize = 48,char const *characters = defaultCharacters,
+			GlyphMode glyphMode = CoverageGlyphs);
+
+	virtual ~TextRenderer();
+
+	/** \brief Add a text.
+	 *
+	 * Texts can only be added before \ref setupVertexBuffers() is called.
+	 *
+	 * @param origin Start of the baseline in model space
+	 * @param height Height of the em square in model space units
+	 * @param maxLength Maximum number of characters. Longer strings are truncated.
+	 * @param alignment Alignment relative to \p origin
+	 * @return Id of the text for \ref setText()
+	 * @throws OevGLES::FontException when the vertex buffer exists already, or the number of quads exceeds the 16 bit indexes
+	 */
+	TextId addText(OevGLES::Vec3 const &origin,GLfloat height,unsigned maxLength,Alignment alignment = AlignLeft);
+
+	/** \brief Change the string of a text.
+	 *
+	 * Only the quads which change are uploaded at the next draw. When nothing changes the call is cheap,
+	 * and the renderer is not marked dirty.
+	 *
+	 * @param textId Id returned by \ref addText()
+	 * @param text The new string
+	 */
+	void setText(TextId textId,std::string const &text);
+
+	/// \brief Current string of a text
+	std::string const &getText(TextId textId) const {
+		return texts.at(textId).text;
+	}
+
+	/// \brief Set the color of all texts. Alpha fades the text.
+	void setColor(OevGLES::Vec4 const &color) {
+		if (color != textColor) {
+			textColor = color;
+			markDirty();
+		}
+	}
+
+	GlyphMode getGlyphMode() const {
+		return glyphMode;
+	}
+
+	/// \brief Size of the glyph sheet in texels
+	GLuint getSheetSize() const {
+		return sheetSize;
+	}
+
+	/** \brief Upload the glyph sheet, and create the vertex and index buffers.
+	 *
+	 */
+	virtual void setupVertexBuffers () override;
+
+	/** \brief Draw all texts with one draw call.
+	 *
+	 * @param modelMatrix Model matrix, moves the object around from model to world space
+	 * @param viewMatrix View matrix, used to move from world to eye space
+	 * @param ProjMatrix Projection matrix, used to create the 3-dimensional effects on a 2D screen
+	 * @param MVMatrix Model-View Matrix
+	 * @param MVPMatrix Model/View/Projection matrix
+	 */
+	virtual void draw(
+			OevGLES::Mat4 const &modelMatrix,
+			OevGLES::Mat4 const &viewMatrix,
+			OevGLES::Mat4 const &ProjMatrix,
+			OevGLES::Mat4 const &MVMatrix,
+			OevGLES::Mat4 const &MVPMatrix,
+			OevGLES::Vec3 const &lightDir,
+			OevGLES::Vec4 const &lightColor,
+			OevGLES::Vec4 const &ambientLightColor
+			)  override;
+
+	/** \brief Return the GL state which is used by \ref draw().
+	 *
+	 * @return Program, glyph sheet, alpha blending, and depth test without writing
+	 */
+	virtual RenderState getRenderState() const override;
+
+	/** \brief Axis aligned bounding box of the current glyphs of all texts in model space
+	 *
+	 * @param[out] minCorner Corner with the minimum coordinates
+	 * @param[out] maxCorner Corner with the maximum coordinates
+	 * @return false when no text has visible glyphs
+	 */
+	virtual bool getBoundingBox(OevGLES::Vec3 &minCorner,OevGLES::Vec3 &maxCorner) const override;
+
+private:
+
+	/// \brief Metrics and location in the glyph sheet of a character. All sizes in texels.
+	struct Glyph {
+		bool available = false;
+		/// \brief Horizontal distance to the origin of the next glyph
+		GLfloat advance = 0.0f;
+		/// \brief Distance of the left edge of the bitmap from the pen position
+		GLfloat left = 0.0f;
+		/// \brief Distance of the upper edge of the bitmap above the baseline
+		GLfloat top = 0.0f;
+		GLuint width = 0;
+		GLuint height = 0;
+		/// \brief Texture coordinates of the bitmap in the sheet
+		GLfloat u0 = 0.0f,v0 = 0.0f,u1 = 0.0f,v1 = 0.0f;
+	};
+
+	struct Text {
+		OevGLES::Vec3 origin;
+		/// \brief Model space units per texel
+		GLfloat scale;
+		Alignment alignment;
+		/// \brief First quad of the text in the vertex buffer
+		unsigned firstQuad;
+		unsigned maxLength;
+		std::string text;
+	};
+
+	// The memory layout of a vertex is
+	//	012		34
+	//	Pos		TextureCoordinates
+	// Each quad has 4 vertexes: lower left, lower right, upper right, upper left. They are drawn as 2 indexed triangles.
+	static constexpr unsigned floatsPerVertex = 5;
+	static constexpr unsigned floatsPerQuad = 4 * floatsPerVertex;
+
+	/// \brief Floats like \ref vertexArray. The changed quads are uploaded as they are.
+	OevGLES::VertexFormat vertexFormat;
+
+	std::array<Glyph,256> glyphs;
+
+	/// \brief The rasterized glyphs until they are uploaded by \ref setupVertexBuffers()
+	OevGLES::TextureData glyphSheet;
+	GLuint sheetSize = 0;
+	/// \brief Size of the em square in texels
+	unsigned pixelSize;
+	GlyphMode glyphMode;
+	/// \brief Largest distance from the edge of a glyph in the distance field, in texels
+	unsigned distanceSpread = 0;
+	OevGLES::GLTexture glyphTexture;
+
+	std::vector<Text> texts;
+
+	/// \brief Quads of all texts
+	std::vector<GLfloat> vertexArray;
+
+	/// \brief Range of quads which changed since the last upload. Empty when begin >= end.
+	unsigned changedQuadsBegin = 0;
+	unsigned changedQuadsEnd = 0;
+
+	OevGLES::Vec4 textColor {1.0f,1.0f,1.0f,1.0f};
+
+	/// \brief The program of the glyph mode. The other one is null.
+	OevGLES::GLProgText *coverageProgram = nullptr;
+	OevGLES::GLProgTextSDF *distanceProgram = nullptr;
+
+	GLuint vertexBufferHandle = 0;
+	GLuint indexBufferHandle = 0;
+
+	/** \brief Rasterize the characters, and pack them into \ref glyphSheet
+	 *
+	 * @param fontFile Font file
+	 * @param pixelSize Size of the em square in texels
+	 * @param characters The characters of the sheet
+	 */
+	void rasterizeGlyphs(char const *fontFile,unsigned pixelSize,char const *characters);
+
+	/** \brief Lay out the string of a text, and update the quads which differ
+	 *
+	 * @param text The text
+	 */
+	void layoutText(Text const &text);
+
+	/// \brief Upload the changed quads into the vertex buffer
+	void uploadChangedQuads();
+
+	/** \brief Set the common uniforms and attributes, and draw the quads.
+	 *
+	 * Both programs declare the same names for them.
+	 *
+	 * @param program The program of the glyph mode. It is in use.
+	 * @param MVPMatrix Model/View/Projection matrix
+	 */
+	template <class Program>
+	void drawQuads(Program *program,OevGLES::Mat4 const &MVPMatrix);
+
+};
+
+#endif /* TEXTRENDERER_H_ */
@@ -0,0 +1,109 @@
+/*
+ * TransformNode.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Transform hierarchy. Nodes cache their world, model-view and model-view-projection matrices.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+
+#include "OVFCommon.h"
+
+#include "Renderers/TransformNode.h"
+
+uint64_t TransformNode::numWorldUpdates = 0;
+uint64_t TransformNode::numViewUpdates = 0;
+
+TransformNode::TransformNode(TransformNode *parent,RendererBase *renderer)
+	:localMatrix {OevGLES::Mat4::Identity()},
+	 worldMatrix {OevGLES::Mat4::Identity()},
+	 MVMatrix {OevGLES::Mat4::Identity()},
+	 MVPMatrix {OevGLES::Mat4::Identity()},
+	 renderer {renderer}
+{
+	setParent(parent);
+}
+
+TransformNode::~TransformNode() {
+
+	setParent(nullptr);
+
+	for (auto child : children) {
+		child->parent = nullptr;
+		child->localDirty = true;
+	}
+
+}
+
+void TransformNode::setParent(TransformNode *parent) {
+
+	if (this->parent == parent) {
+		return;
+	}
+
+	if (this->parent) {
+		this->parent->removeChild(this);
+	}
+
+	this->parent = parent;
+	if (parent) {
+		parent->children.push_back(this);
+	}
+
+	localDirty = true;
+}
+
+void TransformNode::removeChild(TransformNode *child) {
+	children.erase(std::remove(children.begin(),children.end(),child),children.end());
+}
+
+void TransformNode::updateTransforms(SceneCamera const &camera,bool parentChanged) {
+	bool const worldChanged = localDirty || parentChanged;
+
+	if (worldChanged) {
+		if (parent) {
+			OevGLES::multiplyMat4(worldMatrix,parent->worldMatrix,localMatrix);
+		} else {
+			worldMatrix = localMatrix;
+		}
+		localDirty = false;
+		worldVersion++;
+		numWorldUpdates++;
+	}
+
+	if (worldChanged || cameraVersion != camera.getVersion()) {
+		OevGLES::multiplyMat4(MVMatrix,camera.getViewMatrix(),worldMatrix);
+		OevGLES::multiplyMat4(MVPMatrix,camera.getViewProjMatrix(),worldMatrix);
+		cameraVersion = camera.getVersion();
+		numViewUpdates++;
+	}
+
+	for (auto child : children) {
+		child->updateTransforms(camera,worldChanged);
+	}
+
+}
@@ -0,0 +1,177 @@
+/*
+ * TransformNode.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Transform hierarchy. Nodes cache their world, model-view and model-view-projection matrices.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef RENDERERS_TRANSFORMNODE_H_
+#define RENDERERS_TRANSFORMNODE_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "Renderers/RendererBase.h"
+#include "Renderers/SceneCamera.h"
+
+/** \brief Node in the transform hierarchy of the scene
+ *
+ * Each node has a local transform relative to its parent, and caches
+ * - the world matrix, i.e. the model matrix for the renderer, parent world * local,
+ * - the model-view matrix, view * world,
+ * - the model-view-projection matrix, view-projection * world.
+ *
+ * \ref updateTransforms() is called once per frame on the root node.
+ * The world matrix is only re-computed when the local transform of the node or of any ancestor changed.
+ * The MV and MVP matrices are only re-computed when the world matrix or the camera changed.
+ *
+ * Instruments which share a common panel are children of the panel node. Moving the panel is a single
+ * change of the panel transform.
+ *
+ * Nodes do not own their parent, children or renderer. A node removes itself from the parent and the children
+ * when it is destroyed.
+ */
+class TransformNode {
+public:
+
+	/** \brief Constructor
+	 *
+	 * @param parent Parent node, or nullptr for a root node
+	 * @param renderer Renderer which draws the object at this node, or nullptr for a pure transform node
+	 */
+	TransformNode(TransformNode *parent = nullptr,RendererBase *renderer = nullptr);
+
+	virtual ~TransformNode();
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+	/** \brief Attach the node to another parent
+	 *
+	 * @param parent New parent node, or nullptr to make the node a root node
+	 */
+	void setParent(TransformNode *parent);
+
+	TransformNode *getParent() const {
+		return parent;
+	}
+
+	void setRenderer(RendererBase *renderer) {
+		this->renderer = renderer;
+	}
+
+	RendererBase *getRenderer() const {
+		return renderer;
+	}
+
+	/** \brief Set the transform relative to the parent
+	 *
+	 * The node and all descendants are only marked dirty when the matrix actually changed.
+	 *
+	 * @param localMatrix Local transform
+	 */
+	void setLocalMatrix(OevGLES::Mat4 const &localMatrix) {
+		if (this->localMatrix != localMatrix) {
+			this->localMatrix = localMatrix;
+			localDirty = true;
+		}
+	}
+
+	OevGLES::Mat4 const &getLocalMatrix() const {
+		return localMatrix;
+	}
+
+	/** \brief Re-compute the cached matrices of this node and all descendants where needed.
+	 *
+	 * Call on the root node once per frame after the camera was updated.
+	 *
+	 * @param camera Camera with the view and projection matrices
+	 */
+	void updateTransforms(SceneCamera const &camera) {
+		updateTransforms(camera,false);
+	}
+
+	/// \brief Model matrix, moves the object from model to world space. Valid after \ref updateTransforms().
+	OevGLES::Mat4 const &getWorldMatrix() const {
+		return worldMatrix;
+	}
+
+	/// \brief Model-view matrix. Valid after \ref updateTransforms().
+	OevGLES::Mat4 const &getMVMatrix() const {
+		return MVMatrix;
+	}
+
+	/// \brief Model-view-projection matrix. Valid after \ref updateTransforms().
+	OevGLES::Mat4 const &getMVPMatrix() const {
+		return MVPMatrix;
+	}
+
+	/** \brief Incremented every time the world matrix is re-computed
+	 *
+	 * Allows users of the world matrix to detect changes without comparing matrices.
+	 */
+	uint64_t getWorldVersion() const {
+		return worldVersion;
+	}
+
+	/// \brief Total number of world matrix computations of all nodes
+	static uint64_t getNumWorldUpdates() {
+		return numWorldUpdates;
+	}
+
+	/// \brief Total number of MV and MVP matrix computations of all nodes
+	static uint64_t getNumViewUpdates() {
+		return numViewUpdates;
+	}
+
+private:
+
+	OevGLES::Mat4 localMatrix;
+	OevGLES::Mat4 worldMatrix;
+	OevGLES::Mat4 MVMatrix;
+	OevGLES::Mat4 MVPMatrix;
+
+	TransformNode *parent = nullptr;
+	std::vector<TransformNode*> children;
+
+	RendererBase *renderer = nullptr;
+
+	/// \brief The local transform or the parent changed since the last \ref updateTransforms()
+	bool localDirty = true;
+
+	uint64_t worldVersion = 0;
+
+	/// \brief Version of the camera with which MV and MVP were computed
+	uint64_t cameraVersion = 0;
+
+	static uint64_t numWorldUpdates;
+	static uint64_t numViewUpdates;
+
+	void updateTransforms(SceneCamera const &camera,bool parentChanged);
+
+	void removeChild(TransformNode *child);
+
+	TransformNode(TransformNode const&) = delete;
+	TransformNode &operator = (TransformNode const&) = delete;
+};
+
+#endif /* RENDERERS_TRANSFORMNODE_H_ */
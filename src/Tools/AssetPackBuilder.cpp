@@ -0,0 +1,456 @@
+/*
+ * AssetPackBuilder.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Build tool which cooks the assets into a pack which the program maps into memory at start.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <getopt.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+
+#include "OVFCommon.h"
+
+#include "GLES/AssetPack.h"
+#include "GLES/ExceptionBase.h"
+#include "GLES/TexHelper/PngReader.h"
+#include "GLES/TexHelper/TextureConverter.h"
+#include "GLES/TexHelper/MipMapGenerator.h"
+#include "GLES/TexHelper/DistanceField.h"
+#include "GLES/TexHelper/Etc1Codec.h"
+#include "GLES/TexHelper/CompressedTextureFile.h"
+
+using OevGLES::AssetPack;
+using OevGLES::TextureData;
+
+/// \brief Target format of PNG textures
+enum CookedFormat {
+	Native,
+	RGB565,
+	RGBA4444,
+	RGBA5551,
+	ETC1
+};
+
+/// \brief Options which apply to the inputs which follow them on the command line
+struct CookOptions {
+	CookedFormat format = Native;
+	OevGLES::TextureConverter::Dithering dithering = OevGLES::TextureConverter::NoDithering;
+	bool mipMaps = false;
+	/// \brief Spread of the distance field in texels. 0 stores the image itself.
+	unsigned distanceSpread = 0;
+	unsigned distanceDownscale = 4;
+	bool verbose = false;
+};
+
+/// \brief An entry with its data before it is written
+struct CookedAsset {
+	AssetPack::Entry entry;
+	/// \brief The levels of textures, or the single blob of other types
+	std::vector<std::vector<uint8_t>> levels;
+};
+
+static void usage(char const *progName) {
+	std::cerr << "Usage: " << progName << " [options] output.pack [options] [name=]file ...\n"
+			"  The type of each input is derived from the extension:\n"
+			"    .png                             Texture\n"
+			"    .ktx, .pkm                       ETC1 texture as it is\n"
+			"    .vert, .frag, .vsh, .fsh, .glsl  Text, e.g. shader source\n"
+			"    other                            Buffer, e.g. vertexes or indexes\n"
+			"  The name defaults to the file name without directory.\n"
+			"  Options apply to the PNG textures which follow them:\n"
+			"  -f, --format FMT  native, rgb565, rgba4444, rgba5551, or etc1 (default native)\n"
+			"                    etc1 drops the alpha channel\n"
+			"  -d, --dither D    none, ordered, or fs for Floyd-Steinberg (default none)\n"
+			"  -m, --mipmaps     Store the mip-map chain\n"
+			"  -n, --no-mipmaps  Store only the base level (default)\n"
+			"  -s, --sdf SPREAD  Store the signed distance field of the alpha channel as luminance texture,\n"
+			"                    e.g. of symbols. SPREAD is the largest distance in texels of the field.\n"
+			"                    0 stores the image (default).\n"
+			"  -S, --sdf-scale N The distance field has 1/N of the image size (default 4)\n"
+			"  -v, --verbose     Print the entries\n"
+			"  -h, --help        This help\n";
+}
+
+static void throwError(std::string const &text) {
+	throw OevGLES::AssetPackException(("AssetPackBuilder: " + text).c_str());
+}
+
+static std::string getExtension(std::string const &fileName) {
+	std::string::size_type const dot = fileName.rfind('.');
+	std::string::size_type const slash = fileName.rfind('/');
+
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+		return "";
+	}
+
+	std::string extension = fileName.substr(dot);
+	for (auto &c : extension) {
+		c = char(tolower(c));
+	}
+
+	return extension;
+}
+
+static std::vector<uint8_t> readFile(std::string const &fileName) {
+	std::ifstream file(fileName,std::ios::binary);
+
+	if (!file) {
+		throwError("Could not open \"" + fileName + '"');
+	}
+
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+}
+
+static std::vector<uint8_t> getTexels(TextureData const &image) {
+	uint8_t const *data = static_cast<uint8_t const *>(image.getDataPtr());
+
+	return std::vector<uint8_t>(data,data + image.getDataBufferLength());
+}
+
+static void cookPng(CookedAsset &asset,std::string const &fileName,CookOptions const &options) {
+	OevGLES::PngReader reader (fileName.c_str());
+	TextureData image (8,8,TextureData::RGB,TextureData::Byte);
+	std::vector<TextureData> mipLevels;
+
+	reader.readPngToTexture(image);
+
+	if (options.distanceSpread > 0) {
+		if (options.format != Native) {
+			throwError("Distance fields are stored as luminance. Use the native format for \"" + fileName + '"');
+		}
+		image = OevGLES::DistanceField(options.distanceSpread,options.distanceDownscale).generate(image);
+	}
+
+	if (options.mipMaps) {
+		// Distances are linear, and must not be decoded from sRGB
+		OevGLES::MipMapGenerator const generator = (options.distanceSpread > 0) ?
+				OevGLES::MipMapGenerator(OevGLES::MipMapGenerator::Box,false) : OevGLES::MipMapGenerator();
+		mipLevels = generator.createMipChain(image);
+	}
+	mipLevels.insert(mipLevels.begin(),std::move(image));
+
+	asset.entry.width = mipLevels[0].getWidth();
+	asset.entry.height = mipLevels[0].getHeight();
+	asset.entry.numLevels = uint32_t(mipLevels.size());
+
+	if (options.format == ETC1) {
+		asset.entry.type = AssetPack::CompressedTexture;
+		asset.entry.glFormat = GL_ETC1_RGB8_OES;
+
+		for (auto const &level : mipLevels) {
+			asset.levels.push_back(OevGLES::Etc1Codec::encode(level).getLevel(0).data);
+		}
+		return;
+	}
+
+	TextureData::DataType targetType = TextureData::undefType;
+	switch (options.format) {
+	case RGB565:
+		targetType = TextureData::Short565;
+		break;
+	case RGBA4444:
+		targetType = TextureData::Short4444;
+		break;
+	case RGBA5551:
+		targetType = TextureData::Short5551;
+		break;
+	default:
+		break;
+	}
+
+	for (auto &level : mipLevels) {
+		if (targetType != TextureData::undefType) {
+			level = OevGLES::TextureConverter::convert(level,targetType,options.dithering);
+		}
+		asset.levels.push_back(getTexels(level));
+	}
+
+	asset.entry.type = AssetPack::Texture;
+	asset.entry.glFormat = mipLevels[0].getGlFormat();
+	asset.entry.dataType = mipLevels[0].getDataType();
+}
+
+static void cookCompressed(CookedAsset &asset,std::string const &fileName) {
+	OevGLES::CompressedTextureData compressed;
+
+	OevGLES::CompressedTextureFile::read(fileName,compressed);
+
+	if (compressed.getGlInternalFormat() != GL_ETC1_RGB8_OES) {
+		throwError("Only ETC1 is supported in \"" + fileName + '"');
+	}
+
+	asset.entry.type = AssetPack::CompressedTexture;
+	asset.entry.glFormat = compressed.getGlInternalFormat();
+	asset.entry.width = compressed.getWidth();
+	asset.entry.height = compressed.getHeight();
+	asset.entry.numLevels = uint32_t(compressed.getNumLevels());
+
+	for (size_t i = 0; i < compressed.getNumLevels(); i++) {
+		asset.levels.push_back(compressed.getLevel(i).data);
+	}
+}
+
+static CookedAsset cookAsset(std::string const &argument,CookOptions const &options) {
+	CookedAsset asset;
+	std::string::size_type const equal = argument.find('=');
+	std::string const fileName = (equal == std::string::npos) ? argument : argument.substr(equal + 1);
+	std::string name;
+
+	if (equal != std::string::npos) {
+		name = argument.substr(0,equal);
+	} else {
+		std::string::size_type const slash = fileName.rfind('/');
+		name = (slash == std::string::npos) ? fileName : fileName.substr(slash + 1);
+	}
+
+	if (name.empty() || name.size() >= AssetPack::maxNameLength) {
+		throwError("Invalid name \"" + name + "\". At most " + std::to_string(AssetPack::maxNameLength - 1) + " characters.");
+	}
+
+	memset(&asset.entry,0,sizeof(asset.entry));
+	strcpy(asset.entry.name,name.c_str());
+	asset.entry.numLevels = 1;
+
+	std::string const extension = getExtension(fileName);
+
+	if (extension == ".png") {
+		cookPng(asset,fileName,options);
+	} else if (extension == ".ktx" || extension == ".pkm") {
+		cookCompressed(asset,fileName);
+	} else if (extension == ".vert" || extension == ".frag" || extension == ".vsh" || extension == ".fsh" || extension == ".glsl") {
+		asset.entry.type = AssetPack::Text;
+		asset.levels.push_back(readFile(fileName));
+		asset.entry.size = asset.levels[0].size();
+		// The terminating 0 is not counted in the size
+		asset.levels[0].push_back(0);
+	} else {
+		asset.entry.type = AssetPack::Buffer;
+		asset.levels.push_back(readFile(fileName));
+		asset.entry.size = asset.levels[0].size();
+	}
+
+	// The layout of the levels is derived from size and format. Catch a mismatch before the runtime does.
+	if (asset.entry.type == AssetPack::Texture || asset.entry.type == AssetPack::CompressedTexture) {
+		for (uint32_t i = 0; i < asset.entry.numLevels; i++) {
+			if (asset.levels[i].size() != AssetPack::getLevelSize(asset.entry,i)) {
+				throwError("Level " + std::to_string(i) + " of \"" + fileName + "\" has an unexpected size");
+			}
+		}
+		asset.entry.size = AssetPack::getLevelOffset(asset.entry,asset.entry.numLevels - 1) +
+				AssetPack::getLevelSize(asset.entry,asset.entry.numLevels - 1);
+	}
+
+	if (options.verbose) {
+		std::cout << name << ": type " << asset.entry.type << ", " << asset.entry.width << 'x' << asset.entry.height
+				<< ", " << asset.entry.numLevels << " levels, " << asset.entry.size << " bytes\n";
+	}
+
+	return asset;
+}
+
+static void writePack(std::string const &fileName,std::vector<CookedAsset> &assets) {
+	static uint8_t const padding[AssetPack::blobAlignment] = {0};
+	AssetPack::FileHeader header;
+
+	// The pack looks the names up with a binary search
+	std::sort(assets.begin(),assets.end(),[] (CookedAsset const &a,CookedAsset const &b) {
+		return strcmp(a.entry.name,b.entry.name) < 0;
+	});
+
+	uint64_t offset = AssetPack::alignBlob(sizeof(header) + assets.size() * sizeof(AssetPack::Entry));
+	for (size_t i = 0; i < assets.size(); i++) {
+		if (i > 0 && !strcmp(assets[i - 1].entry.name,assets[i].entry.name)) {
+			throwError(std::string("Duplicate name \"") + assets[i].entry.name + '"');
+		}
+
+		assets[i].entry.offset = offset;
+		for (auto const &level : assets[i].levels) {
+			offset += AssetPack::alignBlob(level.size());
+		}
+	}
+
+	memcpy(header.magic,AssetPack::fileMagic,sizeof(header.magic));
+	header.byteOrder = AssetPack::byteOrderMark;
+	header.numEntries = uint32_t(assets.size());
+	header.fileSize = offset;
+
+	std::ofstream file(fileName,std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throwError("Could not create \"" + fileName + '"');
+	}
+
+	file.write(reinterpret_cast<char const *>(&header),sizeof(header));
+	for (auto const &asset : assets) {
+		file.write(reinterpret_cast<char const *>(&asset.entry),sizeof(asset.entry));
+	}
+
+	uint64_t position = sizeof(header) + assets.size() * sizeof(AssetPack::Entry);
+	for (auto const &asset : assets) {
+		for (auto const &level : asset.levels) {
+			file.write(reinterpret_cast<char const *>(padding),std::streamsize(AssetPack::alignBlob(position) - position));
+			file.write(reinterpret_cast<char const *>(level.data()),std::streamsize(level.size()));
+			position = AssetPack::alignBlob(position) + level.size();
+		}
+	}
+	file.write(reinterpret_cast<char const *>(padding),std::streamsize(AssetPack::alignBlob(position) - position));
+
+	if (!file.flush()) {
+		throwError("Could not write \"" + fileName + '"');
+	}
+}
+
+static bool parseFormat(char const *text,CookedFormat &format) {
+	static struct {
+		char const *name;
+		CookedFormat format;
+	} const formats[] = {
+			{"native",		Native},
+			{"rgb565",		RGB565},
+			{"rgba4444",	RGBA4444},
+			{"rgba5551",	RGBA5551},
+			{"etc1",		ETC1}
+	};
+
+	for (auto const &f : formats) {
+		if (!strcmp(text,f.name)) {
+			format = f.format;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool parseDithering(char const *text,OevGLES::TextureConverter::Dithering &dithering) {
+
+	if (!strcmp(text,"none")) {
+		dithering = OevGLES::TextureConverter::NoDithering;
+	} else if (!strcmp(text,"ordered")) {
+		dithering = OevGLES::TextureConverter::OrderedDithering;
+	} else if (!strcmp(text,"fs")) {
+		dithering = OevGLES::TextureConverter::FloydSteinberg;
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv) {
+	static struct option longOptions[] = {
+			{"format",		required_argument,	0, 'f'},
+			{"dither",		required_argument,	0, 'd'},
+			{"mipmaps",		no_argument,		0, 'm'},
+			{"no-mipmaps",	no_argument,		0, 'n'},
+			{"sdf",			required_argument,	0, 's'},
+			{"sdf-scale",	required_argument,	0, 'S'},
+			{"verbose",		no_argument,		0, 'v'},
+			{"help",		no_argument,		0, 'h'},
+			{0, 0, 0, 0}
+	};
+	CookOptions options;
+	std::string packFile;
+	std::vector<CookedAsset> assets;
+	int c;
+
+#if defined HAVE_LOG4CXX_H
+	log4cxx::BasicConfigurator::configure();
+	log4cxx::Logger::getRootLogger()->setLevel(log4cxx::Level::getWarn());
+#endif // if defined HAVE_LOG4CXX_H
+
+	try {
+		// The leading '-' returns the inputs in the order of the command line. The options apply to the inputs which follow.
+		while ((c = getopt_long(argc,argv,"-f:d:mns:S:vh",longOptions,NULL)) != -1) {
+			switch (c) {
+			case 1:
+				if (packFile.empty()) {
+					packFile = optarg;
+				} else {
+					assets.push_back(cookAsset(optarg,options));
+				}
+				break;
+			case 'f':
+				if (!parseFormat(optarg,options.format)) {
+					usage(argv[0]);
+					return 1;
+				}
+				break;
+			case 'd':
+				if (!parseDithering(optarg,options.dithering)) {
+					usage(argv[0]);
+					return 1;
+				}
+				break;
+			case 'm':
+				options.mipMaps = true;
+				break;
+			case 'n':
+				options.mipMaps = false;
+				break;
+			case 's':
+				options.distanceSpread = unsigned(strtoul(optarg,NULL,10));
+				break;
+			case 'S':
+				options.distanceDownscale = unsigned(strtoul(optarg,NULL,10));
+				if (options.distanceDownscale == 0) {
+					usage(argv[0]);
+					return 1;
+				}
+				break;
+			case 'v':
+				options.verbose = true;
+				break;
+			default:
+				usage(argv[0]);
+				return 1;
+			}
+		}
+
+		if (packFile.empty() || assets.empty()) {
+			usage(argv[0]);
+			return 1;
+		}
+
+		writePack(packFile,assets);
+
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
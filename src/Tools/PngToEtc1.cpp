@@ -0,0 +1,203 @@
+/*
+ * PngToEtc1.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Converts PNG images into ETC1 compressed textures in KTX or PKM files.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <getopt.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cmath>
+
+#include "OVFCommon.h"
+
+#include "GLES/TexHelper/PngReader.h"
+#include "GLES/TexHelper/Etc1Codec.h"
+#include "GLES/TexHelper/CompressedTextureFile.h"
+
+/// \brief Parameters of a conversion
+struct ConvertOptions {
+	std::string inputFile;
+	std::string outputFile;
+	/// \brief Name of the alpha texture. Empty: Derived from the output file when the image has alpha.
+	std::string alphaFile;
+	bool writePkm = false;
+	bool verbose = false;
+};
+
+static void usage(char const *progName) {
+	std::cerr << "Usage: " << progName << " [options] input.png output.ktx\n"
+			"  -p, --pkm         Write a PKM file instead of KTX\n"
+			"  -a, --alpha FILE  File of the alpha texture (default output_alpha.ktx or .pkm)\n"
+			"                    Only written when the image has an alpha channel\n"
+			"  -v, --verbose     Print sizes and the PSNR of the compressed image\n"
+			"  -h, --help        This help\n";
+}
+
+static bool parseOptions(int argc, char **argv, ConvertOptions &options) {
+	static struct option longOptions[] = {
+			{"pkm",		no_argument,		0, 'p'},
+			{"alpha",	required_argument,	0, 'a'},
+			{"verbose",	no_argument,		0, 'v'},
+			{"help",	no_argument,		0, 'h'},
+			{0, 0, 0, 0}
+	};
+	int c;
+
+	while ((c = getopt_long(argc,argv,"pa:vh",longOptions,NULL)) != -1) {
+		switch (c) {
+		case 'p':
+			options.writePkm = true;
+			break;
+		case 'a':
+			options.alphaFile = optarg;
+			break;
+		case 'v':
+			options.verbose = true;
+			break;
+		default:
+			usage(argv[0]);
+			return false;
+		}
+	}
+
+	if (argc - optind != 2) {
+		usage(argv[0]);
+		return false;
+	}
+
+	options.inputFile = argv[optind];
+	options.outputFile = argv[optind + 1];
+
+	if (options.alphaFile.empty()) {
+		std::string::size_type const dot = options.outputFile.rfind('.');
+		std::string::size_type const slash = options.outputFile.rfind('/');
+		std::string const base = (dot != std::string::npos && (slash == std::string::npos || dot > slash)) ?
+				options.outputFile.substr(0,dot) : options.outputFile;
+
+		options.alphaFile = base + (options.writePkm ? "_alpha.pkm" : "_alpha.ktx");
+	}
+
+	return true;
+}
+
+/** \brief Peak signal to noise ratio of the compressed image
+ *
+ * @param image Original image. Luminance is expanded to RGB, alpha is ignored.
+ * @param compressed The compressed image
+ * @param alpha Compare the alpha channel of the image instead of the colors
+ * @return PSNR in dB
+ */
+static double computePsnr(OevGLES::TextureData const &image,OevGLES::CompressedTextureData const &compressed,bool alpha) {
+	OevGLES::TextureData const decoded = OevGLES::Etc1Codec::decode(compressed);
+	unsigned const numTexels = image.getWidth() * image.getHeight();
+	unsigned const numChannels = image.getDataBufferLength() / numTexels;
+	GLubyte const *src = static_cast<GLubyte const*>(image.getDataPtr());
+	GLubyte const *dec = static_cast<GLubyte const*>(decoded.getDataPtr());
+	double sumSquares = 0.0;
+
+	for (unsigned i = 0; i < numTexels; i++, src += numChannels, dec += 3) {
+		for (unsigned c = 0; c < 3; c++) {
+			int original;
+
+			if (alpha) {
+				original = src[numChannels - 1];
+			} else {
+				original = (numChannels <= 2) ? src[0] : src[c];
+			}
+
+			double const diff = double(original - dec[c]);
+			sumSquares += diff * diff;
+		}
+	}
+
+	if (sumSquares == 0.0) {
+		return INFINITY;
+	}
+
+	return 10.0 * log10(255.0 * 255.0 * 3.0 * numTexels / sumSquares);
+}
+
+static void writeFile(ConvertOptions const &options,std::string const &fileName,OevGLES::CompressedTextureData const &compressed) {
+
+	if (options.writePkm) {
+		OevGLES::CompressedTextureFile::writePkm(fileName,compressed);
+	} else {
+		OevGLES::CompressedTextureFile::writeKtx(fileName,compressed);
+	}
+}
+
+int main(int argc, char **argv) {
+	ConvertOptions options;
+
+#if defined HAVE_LOG4CXX_H
+	log4cxx::BasicConfigurator::configure();
+	log4cxx::Logger::getRootLogger()->setLevel(log4cxx::Level::getWarn());
+#endif // if defined HAVE_LOG4CXX_H
+
+	if (!parseOptions(argc,argv,options)) {
+		return 1;
+	}
+
+	try {
+		OevGLES::PngReader reader (options.inputFile.c_str());
+		OevGLES::TextureData image (8,8,OevGLES::TextureData::RGB,OevGLES::TextureData::Byte);
+
+		reader.readPngToTexture(image);
+
+		OevGLES::CompressedTextureData const compressed = OevGLES::Etc1Codec::encode(image);
+		writeFile(options,options.outputFile,compressed);
+
+		if (options.verbose) {
+			std::cout << options.inputFile << ": " << image.getWidth() << 'x' << image.getHeight()
+					<< ", " << image.getDataBufferLength() << " -> " << compressed.getDataSize() << " bytes, PSNR "
+					<< std::fixed << std::setprecision(2) << computePsnr(image,compressed,false) << " dB\n";
+		}
+
+		bool const hasAlpha = image.getGlFormat() == OevGLES::TextureData::RGBA ||
+				image.getGlFormat() == OevGLES::TextureData::LuminanceA;
+
+		if (hasAlpha) {
+			OevGLES::CompressedTextureData const alpha = OevGLES::Etc1Codec::encodeAlpha(image);
+			writeFile(options,options.alphaFile,alpha);
+
+			if (options.verbose) {
+				std::cout << options.alphaFile << ": alpha texture, PSNR "
+						<< std::fixed << std::setprecision(2) << computePsnr(image,alpha,true) << " dB\n";
+			}
+		}
+
+	} catch (std::exception const& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
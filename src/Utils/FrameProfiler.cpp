@@ -0,0 +1,223 @@
+/*
+ * FrameProfiler.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Measures the CPU time of the phases of each rendered frame,
+ *  keeps the last N frames, and computes percentile statistics.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <memory.h>
+
+#include "OVFCommon.h"
+
+#include "Utils/FrameProfiler.h"
+
+namespace OevUtils {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+FrameProfiler::FrameProfiler(size_t historyLength)
+	:frames {historyLength},
+	 startTime {Clock::now()}
+{
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.FrameProfiler");
+	}
+#endif
+
+	memset(&currFrame,0,sizeof(currFrame));
+	frameStart = startTime;
+}
+
+FrameProfiler::~FrameProfiler() {
+}
+
+unsigned FrameProfiler::registerPhase(char const *phaseName) {
+
+	if (phaseNames.size() >= maxPhases) {
+		std::ostringstream str;
+		str << "FrameProfiler::registerPhase: Cannot register phase \"" << phaseName
+				<< "\". Maximum number of phases is " << maxPhases;
+		throw std::length_error(str.str());
+	}
+
+	phaseNames.push_back(phaseName);
+
+	LOG4CXX_DEBUG(logger,"Registered phase [" << (phaseNames.size() - 1) << "] = " << phaseName);
+
+	return phaseNames.size() - 1;
+}
+
+void FrameProfiler::beginFrame() {
+
+	frameStart = Clock::now();
+
+	currFrame.frameNo = frameNo;
+	currFrame.frameStartNs = std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart - startTime).count();
+	currFrame.frameDurationNs = 0;
+	for (unsigned i = 0; i < maxPhases; i++) {
+		currFrame.phaseDurationNs[i] = 0;
+	}
+}
+
+void FrameProfiler::endFrame() {
+
+	currFrame.frameDurationNs =
+			std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frameStart).count();
+
+	frames.push(currFrame);
+
+	LOG4CXX_TRACE(logger,"Frame " << frameNo << " took " << (currFrame.frameDurationNs / 1000) << "us");
+
+	frameNo++;
+}
+
+FrameProfiler::Percentiles FrameProfiler::computePercentiles(std::vector<int64_t> &values) {
+	Percentiles rc;
+
+	if (values.empty()) {
+		return rc;
+	}
+
+	std::sort(values.begin(),values.end());
+
+	// Nearest rank method
+	auto percentile = [&values] (double p) {
+		size_t rank = size_t(p / 100.0 * double(values.size()) + 0.5);
+		if (rank < 1) {
+			rank = 1;
+		}
+		if (rank > values.size()) {
+			rank = values.size();
+		}
+		return double(values[rank - 1]) / 1.0e6;
+	};
+
+	double sum = 0.0;
+	for (auto v : values) {
+		sum += double(v);
+	}
+
+	rc.p50 = percentile(50.0);
+	rc.p95 = percentile(95.0);
+	rc.p99 = percentile(99.0);
+	rc.max = double(values.back()) / 1.0e6;
+	rc.mean = sum / double(values.size()) / 1.0e6;
+
+	return rc;
+}
+
+FrameProfiler::Summary FrameProfiler::computeSummary() const {
+	Summary rc;
+	std::vector<FrameRecord> records;
+	std::vector<int64_t> values;
+
+	frames.snapshot(records);
+
+	rc.numFrames = records.size();
+	rc.totalFrames = frames.getNumPushed();
+	rc.phaseNames = phaseNames;
+
+	values.reserve(records.size());
+
+	for (auto const &rec : records) {
+		values.push_back(rec.frameDurationNs);
+	}
+	rc.frameTime = computePercentiles(values);
+
+	for (size_t i = 0; i < phaseNames.size(); i++) {
+		values.clear();
+		for (auto const &rec : records) {
+			values.push_back(rec.phaseDurationNs[i]);
+		}
+		rc.phaseTimes.push_back(computePercentiles(values));
+	}
+
+	return rc;
+}
+
+void FrameProfiler::writeSummary(std::ostream &os) const {
+	Summary summary = computeSummary();
+
+	auto writeLine = [&os] (std::string const &name,Percentiles const &p) {
+		os << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+				<< std::setw(10) << p.p50
+				<< std::setw(10) << p.p95
+				<< std::setw(10) << p.p99
+				<< std::setw(10) << p.max
+				<< std::setw(10) << p.mean
+				<< '\n';
+	};
+
+	os << "Frame statistics over the last " << summary.numFrames << " of " << summary.totalFrames << " frames\n";
+	os << std::left << std::setw(24) << "Phase [ms]" << std::right
+			<< std::setw(10) << "p50"
+			<< std::setw(10) << "p95"
+			<< std::setw(10) << "p99"
+			<< std::setw(10) << "max"
+			<< std::setw(10) << "mean"
+			<< '\n';
+
+	writeLine("frame",summary.frameTime);
+	for (size_t i = 0; i < summary.phaseNames.size(); i++) {
+		writeLine(summary.phaseNames[i],summary.phaseTimes[i]);
+	}
+}
+
+bool FrameProfiler::writeSummaryFile(char const *fileName) const {
+	std::ofstream statsFile (fileName,std::ios::out | std::ios::trunc);
+
+	if (!statsFile) {
+		LOG4CXX_ERROR(logger,"Cannot open frame statistics file \"" << fileName << "\"");
+		return false;
+	}
+
+	writeSummary(statsFile);
+	statsFile.close();
+
+	LOG4CXX_INFO(logger,"Wrote frame statistics to \"" << fileName << "\"");
+
+	return !statsFile.fail();
+}
+
+void FrameProfiler::logSummary() const {
+#if defined HAVE_LOG4CXX_H
+	std::ostringstream str;
+
+	writeSummary(str);
+
+	LOG4CXX_INFO(logger,str.str());
+#endif
+}
+
+} /* namespace OevUtils */
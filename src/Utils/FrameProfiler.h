@@ -0,0 +1,206 @@
+/*
+ * FrameProfiler.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Measures the CPU time of the phases of each rendered frame,
+ *  keeps the last N frames, and computes percentile statistics.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef UTILS_FRAMEPROFILER_H_
+#define UTILS_FRAMEPROFILER_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+#include "Utils/RingBuffer.h"
+
+namespace OevUtils {
+
+/** \brief Frame profiler
+ *
+ * The render loop calls \ref beginFrame() and \ref endFrame() around each frame,
+ * and brackets the interesting phases of the frame (matrix setup, draw calls of each renderer, buffer swap...)
+ * with \ref beginPhase() and \ref endPhase(), or more conveniently with a \ref ScopedPhase object.
+ *
+ * Phases are registered once up front with \ref registerPhase(). A phase can be entered multiple times within a frame.
+ * The durations are accumulated then.
+ *
+ * The records of the last frames are kept in a lock-free ring buffer. \ref computeSummary() can be called
+ * at any time, also from another thread, to obtain the p50/p95/p99 percentiles of the frame time, and of each phase.
+ *
+ * All times are taken from the monotonic std::chrono::steady_clock, and stored in nanoseconds.
+ */
+class FrameProfiler {
+public:
+
+	typedef std::chrono::steady_clock Clock;
+
+	/// \brief Maximum number of phases which can be registered
+	static constexpr unsigned maxPhases = 16;
+
+	/// \brief Timing record of one frame as stored in the ring buffer
+	struct FrameRecord {
+		uint64_t	frameNo;						///< Running number of the frame
+		int64_t		frameStartNs;					///< Start of the frame relative to the creation of the profiler
+		int64_t		frameDurationNs;				///< Time from \ref beginFrame() to \ref endFrame()
+		int64_t		phaseDurationNs[maxPhases];		///< Accumulated time spent in each phase during the frame
+	};
+
+	/// \brief Statistics of a series of durations. All values are in milliseconds.
+	struct Percentiles {
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double mean = 0.0;
+	};
+
+	/// \brief Statistics over the frames which are currently kept in the ring buffer
+	struct Summary {
+		size_t numFrames = 0;						///< Number of frames the statistics are based on
+		uint64_t totalFrames = 0;					///< Number of frames profiled since the start
+		Percentiles frameTime;						///< Statistics of the complete frame time
+		std::vector<std::string> phaseNames;		///< Names of the registered phases
+		std::vector<Percentiles> phaseTimes;		///< Statistics of each phase. Same order as \ref phaseNames
+	};
+
+	/** \brief RAII helper which measures one phase from its construction until its destruction
+	 *
+	 */
+	class ScopedPhase {
+	public:
+		ScopedPhase(FrameProfiler &profiler,unsigned phaseIdx)
+			:profiler{profiler},
+			 phaseIdx{phaseIdx}
+		{
+			profiler.beginPhase(phaseIdx);
+		}
+
+		~ScopedPhase() {
+			profiler.endPhase(phaseIdx);
+		}
+
+	private:
+		FrameProfiler &profiler;
+		unsigned phaseIdx;
+	};
+
+	/** \brief Constructor
+	 *
+	 * @param historyLength Number of frames which are kept for the statistics.
+	 */
+	FrameProfiler(size_t historyLength = 1024);
+
+	virtual ~FrameProfiler();
+
+	/** \brief Register a new phase.
+	 *
+	 * Call this before the render loop starts.
+	 *
+	 * @param phaseName Name of the phase as it appears in the summary
+	 * @return Index of the phase to be used with \ref beginPhase and \ref endPhase
+	 * @throws std::length_error when more than \ref maxPhases phases are registered
+	 */
+	unsigned registerPhase(char const *phaseName);
+
+	/// \brief Start timing of a new frame
+	void beginFrame();
+
+	/// \brief Finish timing of the current frame, and store its record in the ring buffer
+	void endFrame();
+
+	/** \brief Start timing a phase within the current frame
+	 *
+	 * @param phaseIdx Index as returned by \ref registerPhase
+	 */
+	void beginPhase(unsigned phaseIdx) {
+		phaseStart[phaseIdx] = Clock::now();
+	}
+
+	/** \brief Stop timing a phase, and add the time to the phase duration of the current frame.
+	 *
+	 * @param phaseIdx Index as returned by \ref registerPhase
+	 */
+	void endPhase(unsigned phaseIdx) {
+		currFrame.phaseDurationNs[phaseIdx] +=
+				std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - phaseStart[phaseIdx]).count();
+	}
+
+	/** \brief Compute the statistics over the frames in the ring buffer
+	 *
+	 * @return Frame and phase statistics
+	 */
+	Summary computeSummary() const;
+
+	/** \brief Write the summary as human readable table
+	 *
+	 * @param os Output stream
+	 */
+	void writeSummary(std::ostream &os) const;
+
+	/** \brief Write the summary into a file. An existing file is overwritten.
+	 *
+	 * @param fileName Name of the statistics file
+	 * @return true when the file was written successfully
+	 */
+	bool writeSummaryFile(char const *fileName) const;
+
+	/// \brief Write the summary to the logger with level INFO
+	void logSummary() const;
+
+	/** \brief Access to the raw frame records for further analysis.
+	 *
+	 * @param[out] records Frame records from the oldest to the newest
+	 */
+	void getFrameRecords(std::vector<FrameRecord> &records) const {
+		frames.snapshot(records);
+	}
+
+private:
+
+	std::vector<std::string> phaseNames;
+
+	RingBuffer<FrameRecord> frames;
+
+	Clock::time_point startTime;
+	Clock::time_point frameStart;
+	Clock::time_point phaseStart[maxPhases];
+
+	FrameRecord currFrame;
+	uint64_t frameNo = 0;
+
+	/** \brief Computes the percentiles of the values
+	 *
+	 * @param values Durations in nanoseconds. The vector is sorted in place.
+	 * @return Statistics in milliseconds
+	 */
+	static Percentiles computePercentiles(std::vector<int64_t> &values);
+
+};
+
+} /* namespace OevUtils */
+
+#endif /* UTILS_FRAMEPROFILER_H_ */
@@ -0,0 +1,155 @@
+/*
+ * RingBuffer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Lock-free single producer ring buffer which keeps the last N entries.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef UTILS_RINGBUFFER_H_
+#define UTILS_RINGBUFFER_H_
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+namespace OevUtils {
+
+/** \brief Lock-free ring buffer with one writer and any number of readers
+ *
+ * The buffer keeps the last \ref getCapacity() entries. When it is full the oldest entry is overwritten.
+ * The writer never waits for readers.
+ *
+ * Each slot carries a sequence number which works like a seqlock:
+ * It is odd while the writer updates the slot, and even when the slot is consistent.
+ * Readers copy a slot, and discard the copy when the sequence number changed in between.
+ * Therefore T must be trivially copyable.
+ *
+ * Only one thread may call \ref push(). \ref snapshot() can be called from any thread at any time.
+ */
+template <typename T>
+class RingBuffer {
+public:
+
+	static_assert(std::is_trivially_copyable<T>::value,"RingBuffer entries must be trivially copyable");
+
+	/** \brief Constructor
+	 *
+	 * @param capacity Number of entries kept in the buffer. Must be > 0.
+	 */
+	RingBuffer(size_t capacity)
+		:slots (capacity > 0 ? capacity : 1)
+	{}
+
+	/** \brief Number of entries the buffer can hold
+	 *
+	 * @return Capacity of the buffer
+	 */
+	size_t getCapacity() const {
+		return slots.size();
+	}
+
+	/** \brief Total number of entries pushed since construction or \ref clear()
+	 *
+	 * @return Number of pushed entries. Can be larger than the capacity.
+	 */
+	uint64_t getNumPushed() const {
+		return numPushed.load(std::memory_order_acquire);
+	}
+
+	/** \brief Append an entry. Overwrites the oldest entry when the buffer is full.
+	 *
+	 * Must only be called by the single writer thread.
+	 *
+	 * @param value Entry to be stored
+	 */
+	void push(T const& value) {
+		uint64_t const idx = numPushed.load(std::memory_order_relaxed);
+		Slot &slot = slots[idx % slots.size()];
+
+		slot.seq.store(2 * idx + 1,std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.value = value;
+		slot.seq.store(2 * idx + 2,std::memory_order_release);
+
+		numPushed.store(idx + 1,std::memory_order_release);
+	}
+
+	/** \brief Copy all consistent entries from the oldest to the newest into \ref result
+	 *
+	 * Entries which are overwritten by the writer while they are being copied are skipped.
+	 *
+	 * @param[out] result Receives the entries. Previous content is discarded.
+	 */
+	void snapshot(std::vector<T> &result) const {
+		uint64_t const end = numPushed.load(std::memory_order_acquire);
+		uint64_t const begin = (end > slots.size()) ? (end - slots.size()) : 0;
+
+		result.clear();
+		result.reserve(end - begin);
+
+		for (uint64_t i = begin; i < end; i++) {
+			Slot const &slot = slots[i % slots.size()];
+			uint64_t const seqBefore = slot.seq.load(std::memory_order_acquire);
+
+			if (seqBefore != 2 * i + 2) {
+				// Being written, or already overwritten by a newer entry
+				continue;
+			}
+
+			T copy = slot.value;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (slot.seq.load(std::memory_order_relaxed) == seqBefore) {
+				result.push_back(copy);
+			}
+		}
+	}
+
+	/** \brief Discard all entries.
+	 *
+	 * Must only be called by the writer thread.
+	 */
+	void clear() {
+		for (auto &slot : slots) {
+			slot.seq.store(0,std::memory_order_relaxed);
+		}
+		numPushed.store(0,std::memory_order_release);
+	}
+
+private:
+
+	struct Slot {
+		std::atomic<uint64_t> seq {0};
+		T value {};
+	};
+
+	std::vector<Slot> slots;
+
+	std::atomic<uint64_t> numPushed {0};
+
+};
+
+} /* namespace OevUtils */
+
+#endif /* UTILS_RINGBUFFER_H_ */
@@ -0,0 +1,127 @@
+/*
+ * WorkerPool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Fixed pool of worker threads which execute queued jobs.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <exception>
+
+#include "OVFCommon.h"
+
+#include "Utils/WorkerPool.h"
+
+namespace OevUtils {
+
+#if defined HAVE_LOG4CXX_H
+static log4cxx::LoggerPtr logger = 0;
+#endif
+
+WorkerPool::WorkerPool(unsigned numThreads) {
+#if defined HAVE_LOG4CXX_H
+	if (!logger) {
+		logger = log4cxx::Logger::getLogger("OpenVarioFront.WorkerPool");
+	}
+#endif
+
+	if (numThreads == 0) {
+		unsigned const hwThreads = std::thread::hardware_concurrency();
+
+		numThreads = (hwThreads > 1) ? (hwThreads - 1) : 1;
+	}
+
+	LOG4CXX_DEBUG(logger,"Start " << numThreads << " worker threads");
+
+	threads.reserve(numThreads);
+	for (unsigned i = 0; i < numThreads; i++) {
+		threads.emplace_back(&WorkerPool::workerLoop,this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		stopping = true;
+		jobs.clear();
+	}
+	jobAvailable.notify_all();
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::submit(Job job) {
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		jobs.push_back(std::move(job));
+	}
+	jobAvailable.notify_one();
+}
+
+size_t WorkerPool::getNumQueuedJobs() const {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return jobs.size();
+}
+
+void WorkerPool::workerLoop() {
+
+	for (;;) {
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			jobAvailable.wait(lock,[this] {
+				return stopping || !jobs.empty();
+			});
+
+			if (stopping) {
+				return;
+			}
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		try {
+			job();
+		} catch (std::exception const &e) {
+			LOG4CXX_ERROR(logger,"Uncaught exception in a worker job: " << e.what());
+		} catch (...) {
+			LOG4CXX_ERROR(logger,"Uncaught unknown exception in a worker job");
+		}
+	}
+}
+
+} /* namespace OevUtils */
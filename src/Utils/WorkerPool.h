@@ -0,0 +1,98 @@
+/*
+ * WorkerPool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: hor
+ *
+ *  Fixed pool of worker threads which execute queued jobs.
+ *
+ *   This file is part of OpenVarioFront, an electronic variometer display for glider planes
+ *   Copyright (C) 2026  Kai Horstmann
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#ifndef UTILS_WORKERPOOL_H_
+#define UTILS_WORKERPOOL_H_
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+namespace OevUtils {
+
+/** \brief Pool of worker threads
+ *
+ * Jobs are executed in the order of submission by the first idle thread.
+ * Jobs must not throw. Exceptions which escape a job are logged and discarded.
+ *
+ * The destructor discards jobs which did not start yet, and waits for the running jobs.
+ */
+class WorkerPool {
+public:
+
+	typedef std::function<void()> Job;
+
+	/** \brief Constructor. Starts the threads.
+	 *
+	 * @param numThreads Number of threads. 0 uses the number of hardware threads minus one for the render thread, at least one.
+	 */
+	explicit WorkerPool(unsigned numThreads = 0);
+
+	virtual ~WorkerPool();
+
+	WorkerPool(WorkerPool const &) = delete;
+	WorkerPool &operator = (WorkerPool const &) = delete;
+
+	/** \brief Queue a job for execution
+	 *
+	 * @param job The job
+	 */
+	void submit(Job job);
+
+	/// \brief Number of worker threads
+	unsigned getNumThreads() const {
+		return unsigned(threads.size());
+	}
+
+	/// \brief Number of jobs which wait for a thread
+	size_t getNumQueuedJobs() const;
+
+private:
+
+	std::vector<std::thread> threads;
+
+	std::deque<Job> jobs;
+
+	mutable std::mutex mutex;
+
+	/// \brief Signaled when a job is queued, or the pool is stopped
+	std::condition_variable jobAvailable;
+
+	bool stopping = false;
+
+	/// \brief Main function of the threads
+	void workerLoop();
+
+};
+
+} /* namespace OevUtils */
+
+#endif /* UTILS_WORKERPOOL_H_ */